@@ -46,13 +46,10 @@ SOFTWARE.
 
 
 
-// Unfortunately these structures that have to
-// be made global because the data needs to be updated in the TwsClient::tickPrice
-// and TwsClient::updatePortfolio functions which are callbacks from the
-// Interactive Brokers library (therefore I can't pass AppState into it).
-// These maps are instantiated in tws-client.cpp
-extern std::unordered_map<TickerId, TickerData> mapTickerData;
-extern std::unordered_map<int, PortfolioData> mapPortfolioData;
+// Unfortunately these variables have to
+// be made global because the data needs to be updated in the TwsClient
+// callbacks from the Interactive Brokers library (therefore I can't pass
+// AppState into it). These are instantiated in tws-client.cpp
 extern double netliq_value;
 extern double excessliq_value;
 extern double maintenance_value;
@@ -233,7 +230,7 @@ void ShowActiveTradesRightClickPopup(AppState& state) {
         // Change background color when the item is hot tracked
         ImGui::PushStyleColor(ImGuiCol_HeaderHovered, clrSelection(state));
 
-        bool is_futures_ticker = state.config.IsFuturesTicker(state.activetrades_selected_trade->ticker_symbol);
+        bool is_futures_ticker = state.config.GetInstrument(*state.activetrades_selected_trade).is_futures;
 
         if (state.activetrades_rightclickmenu_linetype == RightClickMenuLineType::trade_header_line) {
             if (state.activetrades_rightclickmenu_shares_exist) {
@@ -386,18 +383,20 @@ void LoadActiveTradesData(AppState& state, std::vector<CListPanelData>& vec) {
 
     if (state.db.trades.size()) {
         // In case of newly added/deleted data ensure data is sorted.
+        // Ticker symbols are compared by their alphabetical rank in the symbol table.
+        const std::vector<uint32_t> ranks = symbol_table.SortRanks();
 
         if (state.activetrades_filter_type == ActiveTradesFilterType::Category) {
             // Sort based on Category and then TickerSymbol
             std::sort(state.db.trades.begin(), state.db.trades.end(),
-                [](const auto& trade1, const auto& trade2) {
+                [&ranks](const auto& trade1, const auto& trade2) {
                     {
                         if (trade1->category < trade2->category) return true;
                         if (trade2->category < trade1->category) return false;
 
                         // a=b for primary condition, go to secondary
-                        if (trade1->ticker_symbol < trade2->ticker_symbol) return true;
-                        if (trade2->ticker_symbol < trade1->ticker_symbol) return false;
+                        if (ranks[trade1->symbol_id] < ranks[trade2->symbol_id]) return true;
+                        if (ranks[trade2->symbol_id] < ranks[trade1->symbol_id]) return false;
 
                         return false;
                     }
@@ -407,10 +406,10 @@ void LoadActiveTradesData(AppState& state, std::vector<CListPanelData>& vec) {
         if (state.activetrades_filter_type == ActiveTradesFilterType::TickerSymbol) {
             // Sort based on TickerSymbol and Expiration
             std::sort(state.db.trades.begin(), state.db.trades.end(),
-                [](const auto& trade1, const auto& trade2) {
+                [&ranks](const auto& trade1, const auto& trade2) {
                     {
-                        if (trade1->ticker_symbol < trade2->ticker_symbol) return true;
-                        if (trade2->ticker_symbol < trade1->ticker_symbol) return false;
+                        if (ranks[trade1->symbol_id] < ranks[trade2->symbol_id]) return true;
+                        if (ranks[trade2->symbol_id] < ranks[trade1->symbol_id]) return false;
 
                         // a=b for primary condition, go to secondary
                         if (trade1->earliest_legs_DTE < trade2->earliest_legs_DTE) return true;
@@ -424,14 +423,14 @@ void LoadActiveTradesData(AppState& state, std::vector<CListPanelData>& vec) {
         if (state.activetrades_filter_type == ActiveTradesFilterType::Expiration) {
             // Sort based on Expiration and TickerSymbol
             std::sort(state.db.trades.begin(), state.db.trades.end(),
-                [](const auto& trade1, const auto& trade2) {
+                [&ranks](const auto& trade1, const auto& trade2) {
                     {
                         if (trade1->earliest_legs_DTE < trade2->earliest_legs_DTE) return true;
                         if (trade2->earliest_legs_DTE < trade1->earliest_legs_DTE) return false;
 
                         // a=b for primary condition, go to secondary
-                        if (trade1->ticker_symbol < trade2->ticker_symbol) return true;
-                        if (trade2->ticker_symbol < trade1->ticker_symbol) return false;
+                        if (ranks[trade1->symbol_id] < ranks[trade2->symbol_id]) return true;
+                        if (ranks[trade2->symbol_id] < ranks[trade1->symbol_id]) return false;
 
                         return false;
                     }
@@ -478,7 +477,7 @@ void LoadActiveTradesData(AppState& state, std::vector<CListPanelData>& vec) {
             if (trade->is_open) {
 
                 // Set the decimals for this tickerSymbol. Most will be 2 but futures can have a lot more.
-                trade->ticker_decimals = state.config.GetTickerDecimals(trade->ticker_symbol);
+                trade->ticker_decimals = state.config.GetInstrument(*trade).ticker_decimals;
 
                 if (state.activetrades_filter_type == ActiveTradesFilterType::Category) {
                     if (trade->category != category_header) {
@@ -499,6 +498,7 @@ void LoadActiveTradesData(AppState& state, std::vector<CListPanelData>& vec) {
     }
 
     state.is_activetrades_data_loaded = true;
+    state.activetrades_data_version++;
 }
 
 
@@ -768,9 +768,23 @@ void ShowActiveTrades(AppState& state) {
 
         // Default to display the Trade History for the first entry in the list.
         SetFirstLineActiveTrades(state, vec);
+        ScrollToSelectedGridRow(lp);
         SetTradeHistoryTrade(state, state.activetrades_selected_trade);
     }
 
+    // After RefreshAppState only the rows that were given new TickerIds when the list was
+    // rebuilt need market data. When a full request is pending it will include them.
+    if (state.first_new_ticker_id && state.is_activetrades_data_loaded) {
+        if (tws_IsConnected(state) && !is_connection_ready_for_data && !is_positions_ready_for_data) {
+            for (auto& ld : vec) {
+                if (ld.line_type != LineType::ticker_line && ld.line_type != LineType::options_leg) continue;
+                TickerId ticker_id = (ld.line_type == LineType::ticker_line) ? ld.trade->ticker_id : ld.leg->ticker_id;
+                if (ticker_id >= state.first_new_ticker_id) client.RequestMarketData(state, &ld);
+            }
+        }
+        state.first_new_ticker_id = 0;
+    }
+
 
     if (tws_IsConnected(state) && is_connection_ready_for_data) {
         // Load all local positions in vector
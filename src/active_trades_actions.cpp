@@ -27,6 +27,9 @@ SOFTWARE.
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include <cmath>
 
 #include "appstate.h"
 #include "list_panel_data.h"
@@ -34,6 +37,8 @@ SOFTWARE.
 #include "tws-client.h"
 #include "active_trades_actions.h"
 #include "utilities.h"
+#include "market_data.h"
+#include "reconcile.h"
 
 #if defined(_WIN32) // win32 and win64
 #include <dwmapi.h>
@@ -43,13 +48,10 @@ SOFTWARE.
 // #include <iostream>
 
 
-// Unfortunately these structures that have to
-// be made global because the data needs to be updated in the TwsClient::tickPrice
-// and TwsClient::updatePortfolio functions which are callbacks from the
-// Interactive Brokers library (therefore I can't pass AppState into it).
-// These maps are instantiated in tws-client.cpp
-extern std::unordered_map<TickerId, TickerData> mapTickerData;
-extern std::unordered_map<int, PortfolioData> mapPortfolioData;
+// Unfortunately these variables have to
+// be made global because the data needs to be updated in the TwsClient
+// callbacks from the Interactive Brokers library (therefore I can't pass
+// AppState into it). These are instantiated in tws-client.cpp
 extern double netliq_value;
 extern double excessliq_value;
 extern double maintenance_value;
@@ -64,11 +66,11 @@ enum class CurrentActivePanel {
 };
 
 
-void ReloadAppState(AppState& state) {
-    // Prevent any current active connection from updating pointers
-    // while the program is in the process of resetting everything.
-    state.is_pause_market_data = true;
-
+// ========================================================================================
+// Close the panels and popups so that they are rebuilt from the changed Trades. Returns
+// the panel that was showing so that RestoreActivePanel can show it again.
+// ========================================================================================
+static CurrentActivePanel ResetPanels(AppState& state) {
     // Save the active panel so that it can be reloaded after the database is reloaded.
     CurrentActivePanel current_active_panel;
     if (state.show_activetrades) current_active_panel = CurrentActivePanel::ActiveTrades;
@@ -104,6 +106,30 @@ void ReloadAppState(AppState& state) {
     state.show_journalfolders_rightclickmenu = false;
     state.show_journalnotes_rightclickmenu = false;
 
+    return current_active_panel;
+}
+
+
+// ========================================================================================
+// Show the panel that was active before ResetPanels.
+// ========================================================================================
+static void RestoreActivePanel(AppState& state, CurrentActivePanel current_active_panel) {
+    // Ensure that the previously selected panel gets reloaded
+    if (current_active_panel == CurrentActivePanel::ActiveTrades) state.show_activetrades = true;
+    if (current_active_panel == CurrentActivePanel::ClosedTrades) state.show_closedtrades = true ;
+    if (current_active_panel == CurrentActivePanel::Transactions) state.show_transpanel = true;
+
+    state.db.is_previously_loaded = true;    // to allow reposition to previously selected row
+}
+
+
+void ReloadAppState(AppState& state) {
+    // Prevent any current active connection from updating pointers
+    // while the program is in the process of resetting everything.
+    state.is_pause_market_data = true;
+
+    CurrentActivePanel current_active_panel = ResetPanels(state);
+
     // Attempt to apply the standard Windows dark theme to the non-client areas of the main form.
 #if defined(_WIN32) // win32 and win64
     BOOL value = (state.config.color_theme == ColorThemeType::Dark) ? TRUE : FALSE;
@@ -118,25 +144,22 @@ void ReloadAppState(AppState& state) {
 
     // Ensure that any previously requested Market Data is cancelled because the
     // ticker_id will have changed when the Trades are reloaded from the database.
-    for (const auto& [key, value] : mapTickerData) {
-        tws_CancelMarketData(state, key);
+    for (TickerId ticker_id = 1; ticker_id <= state.ticker_id; ++ticker_id) {
+        if (ticker_data_store.HasData(ticker_id)) tws_CancelMarketData(state, ticker_id);
     }
 
-    // Clear the ticker data map because the ticker id's will change when
+    // Clear the ticker data because the ticker id's will change when
     // the database is reloaded.
-    mapTickerData.clear();
+    ticker_data_store.Clear();
     state.ticker_id = 1;    // reset counter
+    state.first_new_ticker_id = 0;
 
 
     // Load the refeshed data
     state.db.LoadDatabase(state);
 
-    // Ensure that the previously selected panel gets reloaded
-    if (current_active_panel == CurrentActivePanel::ActiveTrades) state.show_activetrades = true;
-    if (current_active_panel == CurrentActivePanel::ClosedTrades) state.show_closedtrades = true ;
-    if (current_active_panel == CurrentActivePanel::Transactions) state.show_transpanel = true;
+    RestoreActivePanel(state, current_active_panel);
 
-    state.db.is_previously_loaded = true;    // to allow reposition to previously selected row
     is_connection_ready_for_data = true;
     positionEnd_fired = false;
     is_positions_ready_for_data = false;
@@ -153,6 +176,113 @@ void ReloadAppState(AppState& state) {
 }
 
 
+// ========================================================================================
+// Apply an edit to the loaded Trades without reloading the database. Only the modified
+// Trades are recalculated (open legs, ACB, shares history) and the save is queued for the
+// background journal writer. Market data keeps flowing for the legs whose contract did
+// not change; only new or changed contracts are given new TickerIds.
+// Used after an edit instead of ReloadAppState's full save and reload of the database.
+// ========================================================================================
+void RefreshAppState(AppState& state) {
+    // New contracts are given new TickerIds. Reload everything instead if the ids are
+    // close to running out because a reload starts them again at 1.
+    if (state.ticker_id + 256 >= MAX_TICKER_DATA_SLOTS) {
+        ReloadAppState(state);
+        return;
+    }
+
+    // Prevent any current active connection from updating pointers
+    // while the Trades are being recalculated.
+    state.is_pause_market_data = true;
+
+    CurrentActivePanel current_active_panel = ResetPanels(state);
+
+    // Save the new data (appends to the journal when it is enabled)
+    state.db.SaveDatabase(state);
+
+    auto cancel_market_data = [&state](TickerId& ticker_id) {
+        if (ticker_id != -1 && ticker_data_store.HasData(ticker_id)) {
+            tws_CancelMarketData(state, ticker_id);
+        }
+        ticker_id = -1;
+    };
+
+    for (const auto& trade : state.db.deleted_trades) {
+        cancel_market_data(trade->ticker_id);
+        for (const auto& leg : trade->open_legs) {
+            cancel_market_data(leg->ticker_id);
+        }
+    }
+
+    std::vector<std::shared_ptr<Leg>> previous_open_legs;
+
+    for (const auto& trade : state.db.modified_trades) {
+        previous_open_legs = trade->open_legs;
+
+        state.config.ResolveInstrument(*trade);
+        trade->CalculateBuyingPowerDates();
+        trade->CalculateDerivedValues(state);
+
+        // The underlying contract of every row changes if the ticker symbol or futures
+        // expiry was edited.
+        bool is_same_underlying = (trade->ticker_id == -1) ||
+            (trade->symbol_id == trade->market_data_symbol_id &&
+             trade->future_expiry == trade->market_data_future_expiry);
+
+        if (!trade->is_open || !is_same_underlying) cancel_market_data(trade->ticker_id);
+
+        // A leg that is still open for the same contract keeps its TickerId. Editing a
+        // Trade recreates its legs so the TickerId is passed to the new leg for the same
+        // contract. Legs that were closed or whose contract changed are cancelled.
+        for (const auto& leg : previous_open_legs) {
+            if (leg->ticker_id == -1) continue;
+
+            if (is_same_underlying) {
+                auto it = std::find(trade->open_legs.begin(), trade->open_legs.end(), leg);
+                if (it != trade->open_legs.end() &&
+                    leg->GetMarketDataContract() == leg->market_data_contract) continue;
+
+                if (it == trade->open_legs.end()) {
+                    auto match = std::find_if(trade->open_legs.begin(), trade->open_legs.end(),
+                        [&leg](const std::shared_ptr<Leg>& open_leg) {
+                            return open_leg->ticker_id == -1 &&
+                                   open_leg->underlying == leg->underlying &&
+                                   open_leg->GetMarketDataContract() == leg->market_data_contract;
+                        });
+                    if (match != trade->open_legs.end()) {
+                        (*match)->ticker_id = leg->ticker_id;
+                        (*match)->market_data_contract = leg->market_data_contract;
+                        (*match)->contract_id = leg->contract_id;
+                        leg->ticker_id = -1;
+                        continue;
+                    }
+                }
+            }
+
+            cancel_market_data(leg->ticker_id);
+        }
+    }
+
+    state.db.modified_trades.clear();
+    state.db.deleted_trades.clear();
+
+    // Only the rows that receive a new TickerId need their market data requested (see
+    // ShowActiveTrades). The local positions used by reconciliation are rebuilt and then
+    // matched against the IBKR positions already received so that new or recreated legs
+    // get their contract_id (used by the portfolio updates) before market data resumes.
+    state.first_new_ticker_id = state.ticker_id + 1;
+    if (tws_IsConnected(state)) {
+        Reconcile_LoadAllLocalPositions(state);
+        Reconcile_doPositionMatching();
+    }
+
+    RestoreActivePanel(state, current_active_panel);
+
+    // Allow price/market data to flow again.
+    state.is_pause_market_data = false;
+}
+
+
 void UpdateTickerPortfolioLine(AppState& state, int index, int index_trade) {
     ImU32 theme_color = clrTextDarkWhite(state);
 
@@ -168,8 +298,9 @@ void UpdateTickerPortfolioLine(AppState& state, int index, int index_trade) {
         if (ld->trade->aggregate_futures) value_aggregate = ld->trade->aggregate_futures;
 
         double multiplier = 1;
-        if (state.config.IsFuturesTicker(ld->trade->ticker_symbol)) {
-            multiplier = AfxValDouble(state.config.GetMultiplier(ld->trade->ticker_symbol));
+        const InstrumentInfo& instrument = state.config.GetInstrument(*ld->trade);
+        if (instrument.is_futures) {
+            multiplier = instrument.multiplier;
         }
 
         double acb = (value_aggregate) ? ld->trade->acb_shares : ld->trade->acb_total;
@@ -240,8 +371,9 @@ void UpdateLegPortfolioLine(AppState& state, int index, CListPanelData* ld) {
             ld->SetTextData(COLUMN_TICKER_PORTFOLIO_1, text, theme_color);
 
             double multiplier = 1;
-            if (state.config.IsFuturesTicker(ld->trade->ticker_symbol)) {
-                multiplier = AfxValDouble(state.config.GetMultiplier(ld->trade->ticker_symbol));
+            const InstrumentInfo& instrument = state.config.GetInstrument(*ld->trade);
+            if (instrument.is_futures) {
+                multiplier = instrument.multiplier;
             }
 
             double shares_market_value = value_aggregate * ld->trade->ticker_last_price * multiplier;
@@ -277,21 +409,15 @@ void UpdateLegPortfolioLine(AppState& state, int index, CListPanelData* ld) {
     if (ld->line_type == LineType::options_leg && ld->leg) {
         // Lookup the most recent Portfolio position data
         PortfolioData pd{};
-        bool found = false;
-        if (mapPortfolioData.count(ld->leg->contract_id)) {
-            pd = mapPortfolioData.at(ld->leg->contract_id);
-            found = true;
-        }
-
-        if (!found) return;
+        if (!portfolio_data_store.Get(ld->leg->contract_id, pd)) return;
 
 
         // OPTION LEG DELTA
         theme_color = clrTextDarkWhite(state);
         text = "";
         // Lookup the most recent Option position Delta
-        if (mapTickerData.count(ld->leg->ticker_id)) {
-            text = AfxMoney(mapTickerData.at(ld->leg->ticker_id).delta, 2, state);
+        if (ticker_data_store.HasData(ld->leg->ticker_id)) {
+            text = AfxMoney(ticker_data_store.Get(ld->leg->ticker_id).delta, 2, state);
         }
         ld->SetTextData(COLUMN_OPTIONLEG_DELTA, text, theme_color);   // Option leg Delta
 
@@ -303,7 +429,7 @@ void UpdateLegPortfolioLine(AppState& state, int index, CListPanelData* ld) {
 
         // MARKET VALUE
         theme_color = clrTextDarkWhite(state);
-        double multiplier = AfxValDouble(state.config.GetMultiplier(ld->trade->ticker_symbol));
+        double multiplier = state.config.GetInstrument(*ld->trade).multiplier;
         double market_value = (pd.market_price * ld->leg->open_quantity * multiplier);
         ld->leg->market_value = market_value;
         text = AfxMoney(market_value, ld->trade->ticker_decimals, state);
@@ -341,7 +467,8 @@ void PerformITMcalculation(AppState& state, std::shared_ptr<Trade>& trade) {
     const ImU32 GREEN = clrGreen(state);
     int ITMCOLOR = 0;
 
-    double strike_price = 0;
+    // Strikes are compared as integer millionths.
+    int64_t last_price = std::llround(trade->ticker_last_price * FixedPrice::SCALE);
 
     // Iterate forward over the open legs to process the Puts but iterate in
     // reverse to process the Calls in order to properly ensure that the ITM
@@ -349,8 +476,7 @@ void PerformITMcalculation(AppState& state, std::shared_ptr<Trade>& trade) {
     for (const auto& leg : trade->open_legs) {
         if (leg->underlying != Underlying::Options) continue;
         if (leg->put_call != PutCall::Put) continue;
-        strike_price = AfxValDouble(leg->strike_price);
-        if (trade->ticker_last_price < strike_price) {
+        if (last_price < leg->strike_price.Value()) {
             if (leg->open_quantity < 0) ITMCOLOR = RED;    // credit
             if (leg->open_quantity > 0) ITMCOLOR = GREEN;  // debit
         }
@@ -361,8 +487,7 @@ void PerformITMcalculation(AppState& state, std::shared_ptr<Trade>& trade) {
         auto leg = trade->open_legs[i];
         if (leg->underlying != Underlying::Options) continue;
         if (leg->put_call != PutCall::Call) continue;
-        strike_price = AfxValDouble(leg->strike_price);
-        if (trade->ticker_last_price > strike_price) {
+        if (last_price > leg->strike_price.Value()) {
             if (leg->open_quantity < 0) ITMCOLOR = RED;    // credit
             if (leg->open_quantity > 0) ITMCOLOR = GREEN;  // debit
         }
@@ -375,10 +500,7 @@ void PerformITMcalculation(AppState& state, std::shared_ptr<Trade>& trade) {
 
 void UpdateTickerPricesLine(AppState& state, int index, CListPanelData* ld) {
     // Lookup the most recent Market Price data
-    TickerData td{};
-    if (mapTickerData.count(ld->ticker_id)) {
-        td = mapTickerData.at(ld->ticker_id);
-    }
+    TickerData td = ticker_data_store.Get(ld->ticker_id);
 
     ld->trade->ticker_last_price = td.last_price;
     ld->trade->ticker_close_price = td.close_price;
@@ -461,6 +583,112 @@ void UpdateTickerPrices(AppState& state) {
 }
 
 
+// ========================================================================================
+// Update the ticker line and all of its leg lines for one Trade in the ActiveTrades list.
+// ========================================================================================
+void UpdateTickerPricesTrade(AppState& state, std::vector<CListPanelData>* vec, int index_trade) {
+    CListPanelData* ld = &vec->at(index_trade);
+    UpdateTickerPricesLine(state, index_trade, ld);
+
+    const int num_rows = (int)vec->size();
+    for (int index = index_trade; index < num_rows; ++index) {
+        ld = &vec->at(index);
+        if (index > index_trade && ld->line_type == LineType::ticker_line) break;
+        UpdateLegPortfolioLine(state, index, ld);
+    }
+
+    UpdateTickerPortfolioLine(state, index_trade, index_trade);
+}
+
+
+// ========================================================================================
+// Update only the Trades in the ActiveTrades list whose market price, option delta or
+// portfolio data has changed since the previous update. The whole list is updated when
+// it has been rebuilt since the previous update.
+// This function is called from the TickerUpdateFunction() thread.
+// ========================================================================================
+void UpdateChangedTickerPrices(AppState& state) {
+    if (state.is_pause_market_data) return;
+
+    std::vector<CListPanelData>* vec = static_cast<std::vector<CListPanelData>*>(state.vecActiveTrades);
+    if (vec == nullptr || vec->size() == 0) return;
+
+    // Row index of the ticker line of the Trade that each TickerId and leg contract id
+    // belongs to. Rebuilt whenever the ActiveTrades list is rebuilt.
+    static int data_version = -1;
+    static std::unordered_map<TickerId, int> ticker_rows;
+    static std::unordered_map<int, std::vector<int>> contract_rows;
+
+    static std::vector<TickerId> dirty_ticker_ids;
+    static std::vector<int> dirty_contract_ids;
+    static std::vector<int> dirty_rows;
+
+    if (data_version != state.activetrades_data_version) {
+        data_version = state.activetrades_data_version;
+        ticker_rows.clear();
+        contract_rows.clear();
+
+        int index_trade = -1;
+        const int num_rows = (int)vec->size();
+        for (int index = 0; index < num_rows; ++index) {
+            CListPanelData* ld = &vec->at(index);
+            if (ld->line_type == LineType::ticker_line) {
+                index_trade = index;
+                ticker_rows[ld->ticker_id] = index_trade;
+            }
+            if (index_trade == -1) continue;
+            if (ld->line_type == LineType::options_leg && ld->leg) {
+                ticker_rows[ld->leg->ticker_id] = index_trade;
+                contract_rows[ld->leg->contract_id].push_back(index_trade);
+            }
+        }
+
+        // Discard the pending changes because every line is being updated.
+        dirty_ticker_ids.clear();
+        dirty_contract_ids.clear();
+        ticker_data_store.TakeDirty(dirty_ticker_ids);
+        portfolio_data_store.TakeDirty(dirty_contract_ids);
+
+        UpdateTickerPrices(state);
+        state.RequestRedraw();
+        return;
+    }
+
+    if (!ticker_data_store.IsDirty() && !portfolio_data_store.IsDirty()) return;
+
+    dirty_ticker_ids.clear();
+    dirty_contract_ids.clear();
+    dirty_rows.clear();
+
+    ticker_data_store.TakeDirty(dirty_ticker_ids);
+    portfolio_data_store.TakeDirty(dirty_contract_ids);
+
+    for (const auto& ticker_id : dirty_ticker_ids) {
+        auto it = ticker_rows.find(ticker_id);
+        if (it != ticker_rows.end()) dirty_rows.push_back(it->second);
+    }
+
+    for (const auto& contract_id : dirty_contract_ids) {
+        auto it = contract_rows.find(contract_id);
+        if (it != contract_rows.end()) {
+            dirty_rows.insert(dirty_rows.end(), it->second.begin(), it->second.end());
+        }
+    }
+
+    // A Trade can be flagged more than once (e.g. price and several legs changed).
+    std::sort(dirty_rows.begin(), dirty_rows.end());
+    dirty_rows.erase(std::unique(dirty_rows.begin(), dirty_rows.end()), dirty_rows.end());
+
+    const int num_rows = (int)vec->size();
+    for (const auto& index_trade : dirty_rows) {
+        if (index_trade >= num_rows) continue;
+        UpdateTickerPricesTrade(state, vec, index_trade);
+    }
+
+    if (!dirty_rows.empty()) state.RequestRedraw();
+}
+
+
 // ========================================================================================
 // Expire the selected legs. Basically, ask for confirmation via a messagebox and
 // then take appropriate action.
@@ -468,7 +696,7 @@ void UpdateTickerPrices(AppState& state) {
 void ExpireSelectedLegs(AppState& state) {
     std::shared_ptr<Trade> trade = state.activetrades_selected_trade;
 
-    std::shared_ptr<Transaction> trans = std::make_shared<Transaction>();
+    std::shared_ptr<Transaction> trans = model_arena.NewTransaction();
 
     trans->description = "Expiration";
     trans->underlying = Underlying::Options;
@@ -477,7 +705,7 @@ void ExpireSelectedLegs(AppState& state) {
     for (auto& leg : state.activetrades_selected_legs) {
 
         // Save this transaction's leg quantities
-        std::shared_ptr<Leg> newleg = std::make_shared<Leg>();
+        std::shared_ptr<Leg> newleg = model_arena.NewLeg();
 
         trade->nextleg_id += 1;
         newleg->leg_id = trade->nextleg_id;
@@ -502,9 +730,10 @@ void ExpireSelectedLegs(AppState& state) {
 
     // Set the open status of the entire trade based on the new modified legs
     trade->SetTradeOpenStatus();
+    state.db.SetTradeModified(trade);
 
-    // Save/Load the new data to the database
-    ReloadAppState(state);
+    // Save the new data and recalculate the modified Trade
+    RefreshAppState(state);
 }
 
 
@@ -31,7 +31,9 @@ SOFTWARE.
 #include "appstate.h"
 
 void UpdateTickerPrices(AppState& state);
+void UpdateChangedTickerPrices(AppState& state);
 void ReloadAppState(AppState& state);
+void RefreshAppState(AppState& state);
 
 void ExpireSelectedLegs(AppState& state);
 void AskExpireSelectedLegs(AppState& state);
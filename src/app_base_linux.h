@@ -78,6 +78,18 @@ public:
         // Setup Platform/Renderer backends
         ImGui_ImplSDL2_InitForSDLRenderer(window, renderer);
         ImGui_ImplSDLRenderer2_Init(renderer);
+
+        // Custom event used by other threads to wake the main loop
+        redraw_event_type = SDL_RegisterEvents(1);
+        state.redraw_callback = &AppBase::PushRedrawEvent;
+    }
+
+
+    static void PushRedrawEvent() {
+        if (redraw_event_type == (Uint32)-1) return;
+        SDL_Event event{};
+        event.type = redraw_event_type;
+        SDL_PushEvent(&event);
     }
 
 
@@ -97,15 +109,32 @@ public:
         // Initialize the underlying app
         StartUp();
 
-        // Main loop
-        const int FPS = 60;
-        const int frameDelay = 1000 / FPS;
+        // Main loop. When nothing is happening the loop blocks in SDL_WaitEventTimeout
+        // rather than drawing frames. Input events and redraw requests from other threads
+        // (custom redraw_event_type) wake it immediately.
+        const Uint32 frameDelay = 1000 / state.config.max_fps;
 
         Uint32 frameStart;
-        int frameTime;
+        Uint32 frameTime;
+
+        // ImGui needs a few frames after an event to settle (hover, popups, layout).
+        const int FRAMES_AFTER_EVENT = 3;
+        int frames_to_render = FRAMES_AFTER_EVENT;
 
         bool done = false;
         while (!done) {
+            // Block while idle. Still draw a frame every IDLE_TIMEOUT so that time based
+            // displays (and the text cursor while editing) are kept current.
+            SDL_Event event;
+            bool has_event = false;
+            if (frames_to_render > 0) {
+                has_event = SDL_PollEvent(&event);
+            }
+            else {
+                int timeout = ImGui::GetIO().WantTextInput ? TEXT_INPUT_TIMEOUT : IDLE_TIMEOUT;
+                has_event = SDL_WaitEventTimeout(&event, timeout);
+            }
+
             frameStart = SDL_GetTicks();
 
             // Poll and handle events (inputs, window resize, etc.)
@@ -113,17 +142,23 @@ public:
             // - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application, or clear/overwrite your copy of the mouse data.
             // - When io.WantCaptureKeyboard is true, do not dispatch keyboard input data to your main application, or clear/overwrite your copy of the keyboard data.
             // Generally you may always pass all inputs to dear imgui, and hide them from your application based on those two flags.
-            SDL_Event event;
-            while (SDL_PollEvent(&event)) {
-                ImGui_ImplSDL2_ProcessEvent(&event);
+            while (has_event) {
+                if (event.type == redraw_event_type) {
+                    state.is_redraw_pending = false;
+                }
+                else {
+                    ImGui_ImplSDL2_ProcessEvent(&event);
+                }
                 if (event.type == SDL_QUIT)
                     done = true;
                 if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_CLOSE && event.window.windowID == SDL_GetWindowID(window))
                     done = true;
+                frames_to_render = FRAMES_AFTER_EVENT;
+                has_event = SDL_PollEvent(&event);
             }
 
             if (SDL_GetWindowFlags(window) & SDL_WINDOW_MINIMIZED) {
-                SDL_Delay(10);
+                frames_to_render = 0;
                 continue;
             }
 
@@ -144,6 +179,11 @@ public:
             ImGui_ImplSDLRenderer2_RenderDrawData(ImGui::GetDrawData(), renderer);
             SDL_RenderPresent(renderer);
 
+            if (frames_to_render > 0) frames_to_render--;
+
+            // Keep drawing while a mouse button is held (eg. dragging a scrollbar).
+            if (ImGui::IsAnyMouseDown()) frames_to_render = 1;
+
             frameTime = SDL_GetTicks() - frameStart;
 
             if (frameDelay > frameTime) {
@@ -169,6 +209,10 @@ public:
 
     SDL_Window* window = nullptr;
     SDL_Renderer* renderer = nullptr;
+    static inline Uint32 redraw_event_type = (Uint32)-1;
+
+    static const int IDLE_TIMEOUT = 1000;        // milliseconds
+    static const int TEXT_INPUT_TIMEOUT = 250;   // milliseconds (text cursor blink)
     ImVec4 clear_color = ImVec4(0.0f, 0.0f, 0.0f, 1.00f);
     AppState state{};
 
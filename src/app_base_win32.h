@@ -32,6 +32,9 @@ void CreateRenderTarget();
 void CleanupRenderTarget();
 LRESULT WINAPI WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
+// Posted by other threads (eg. new market data) to wake the main loop
+#define WM_APP_REDRAW (WM_APP + 1)
+
 
 template <typename Derived>
 class AppBase {
@@ -82,6 +85,14 @@ public:
         // Setup Platform/Renderer backends
         ImGui_ImplWin32_Init(hwnd);
         ImGui_ImplDX11_Init(g_pd3dDevice, g_pd3dDeviceContext);
+
+        redraw_hwnd = hwnd;
+        state.redraw_callback = &AppBase::PostRedrawMessage;
+    }
+
+
+    static void PostRedrawMessage() {
+        if (redraw_hwnd) ::PostMessage(redraw_hwnd, WM_APP_REDRAW, 0, 0);
     }
 
     virtual ~AppBase() {
@@ -100,19 +111,39 @@ public:
         // Initialize the underlying app
         StartUp();
 
-        // Main loop
+        // Main loop. When nothing is happening the loop blocks in MsgWaitForMultipleObjects
+        // rather than drawing frames. Input messages and redraw requests from other threads
+        // (WM_APP_REDRAW) wake it immediately.
+        const ULONGLONG frameDelay = 1000 / state.config.max_fps;
+
+        // ImGui needs a few frames after an event to settle (hover, popups, layout).
+        const int FRAMES_AFTER_EVENT = 3;
+        int frames_to_render = FRAMES_AFTER_EVENT;
+
         bool done = false;
         while (!done)
         {
+            // Block while idle. Still draw a frame every IDLE_TIMEOUT so that time based
+            // displays (and the text cursor while editing) are kept current.
+            if (frames_to_render == 0) {
+                DWORD timeout = ImGui::GetIO().WantTextInput ? TEXT_INPUT_TIMEOUT : IDLE_TIMEOUT;
+                ::MsgWaitForMultipleObjects(0, nullptr, FALSE, timeout, QS_ALLINPUT);
+            }
+
+            ULONGLONG frameStart = ::GetTickCount64();
+
             // Poll and handle messages (inputs, window resize, etc.)
             // See the WndProc() function below for our to dispatch events to the Win32 backend.
             MSG msg;
             while (::PeekMessage(&msg, nullptr, 0U, 0U, PM_REMOVE))
             {
+                if (msg.message == WM_APP_REDRAW)
+                    state.is_redraw_pending = false;
                 ::TranslateMessage(&msg);
                 ::DispatchMessage(&msg);
                 if (msg.message == WM_QUIT)
                     done = true;
+                frames_to_render = FRAMES_AFTER_EVENT;
             }
             if (done)
                 break;
@@ -120,7 +151,7 @@ public:
             // Handle window being minimized or screen locked
             if (g_SwapChainOccluded && g_pSwapChain->Present(0, DXGI_PRESENT_TEST) == DXGI_STATUS_OCCLUDED)
             {
-                ::Sleep(10);
+                frames_to_render = 0;
                 continue;
             }
             g_SwapChainOccluded = false;
@@ -156,6 +187,17 @@ public:
             HRESULT hr = g_pSwapChain->Present(1, 0);   // Present with vsync
             //HRESULT hr = g_pSwapChain->Present(0, 0); // Present without vsync
             g_SwapChainOccluded = (hr == DXGI_STATUS_OCCLUDED);
+
+            if (frames_to_render > 0) frames_to_render--;
+
+            // Keep drawing while a mouse button is held (eg. dragging a scrollbar).
+            if (ImGui::IsAnyMouseDown()) frames_to_render = 1;
+
+            ULONGLONG frameTime = ::GetTickCount64() - frameStart;
+
+            if (frameDelay > frameTime) {
+                ::Sleep((DWORD)(frameDelay - frameTime));
+            }
         }
 
         // Shutdown the underlying app
@@ -176,6 +218,10 @@ public:
 
     HWND hwnd = nullptr;
     WNDCLASSEXW wc;
+    static inline HWND redraw_hwnd = nullptr;
+
+    static const DWORD IDLE_TIMEOUT = 1000;        // milliseconds
+    static const DWORD TEXT_INPUT_TIMEOUT = 250;   // milliseconds (text cursor blink)
     ImVec4 clear_color = ImVec4(0.0f, 0.0f, 0.0f, 1.00f);
     AppState state{};
 };
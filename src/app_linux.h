@@ -50,6 +50,9 @@ public:
         SaveTradeHistoryNotes(state);
         SaveJournalNotes(state);
 
+        // Fold any journaled trade changes back into the main database file.
+        state.db.CompactJournal(state);
+
         // Save main window size
         int width = 0;
         int height = 0;
@@ -63,7 +66,7 @@ public:
         
         // If we are connected to TWS then initiate a disconnect that will also
         // stop the running background threads.
-        if (tws_IsConnected(state)) tws_Disconnect(state);
+        tws_Disconnect(state);
     }
 
 private:
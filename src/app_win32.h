@@ -69,13 +69,16 @@ public:
         // Save any modified Trade History Notes, JournalNotes. (if applicable)
         SaveTradeHistoryNotes(state);
         SaveJournalNotes(state);
+
+        // Fold any journaled trade changes back into the main database file.
+        state.db.CompactJournal(state);
         state.config.SaveConfig(state);
 
         ShowWindow(hwnd, false);
 
         // If we are connected to TWS then initiate a disconnect that will also
         // stop the running background threads.
-        if (tws_IsConnected(state)) tws_Disconnect(state);
+        tws_Disconnect(state);
     }
 
 private:
@@ -28,8 +28,20 @@ SOFTWARE.
 #define APPSTATE_H
 
 #include "imgui.h"
+#include "date.h"
+#include "fixed_price.h"
+#include "journal_writer.h"
+#include "model_arena.h"
+#include "symbols.h"
+#include "transaction_index.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <sstream>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <unordered_map>
 #include <vector>
@@ -54,6 +66,18 @@ class Transaction;   // forward declare
 class Trade;         // forward declare
 class Leg;           // forward declare
 
+// Config values for a ticker symbol (multiplier, decimals, exchange). Resolved once from
+// the CConfig maps and copied to each Trade (see CConfig::ResolveInstrument).
+struct InstrumentInfo {
+    SymbolId symbol_id = 0;
+    uint32_t version = 0;             // CConfig::instrument_version when resolved (0 = never)
+    double multiplier = 100;          // Futures multiplier
+    int ticker_decimals = 2;
+    std::string futures_exchange;
+    bool is_futures = false;
+    bool is_index = false;
+};
+
 struct TickerData {
     double last_price = 0;
     double open_price = 0;
@@ -61,17 +85,42 @@ struct TickerData {
     double delta = 0;         // For Option legs
 };
 
+// Packed identity of a position used to match IBKR and Local positions (reconcile.cpp).
+// Expiry, strike and put/call are only set for options.
+enum class PositionSecType : uint8_t {
+    other,      // never matched
+    stock,
+    future,
+    option,
+    future_option
+};
+
+struct PositionKey {
+    SymbolId symbol_id = 0;                 // interned ticker symbol
+    PositionSecType sec_type = PositionSecType::other;
+    char put_call = 0;                      // 'P' or 'C'
+    int32_t expiry_date = 0;                // YYYYMMDD
+    int64_t strike_price = 0;               // strike in millionths (FixedPrice::Value)
+
+    bool operator==(const PositionKey&) const = default;
+};
+
+struct PositionKeyHash {
+    size_t operator()(const PositionKey& key) const;
+};
+
 // Structure & vector to hold all positions returned from connection to IBKR (TWS).
 // These are used for the reconciliation between TradeTracker and IBKR.
 struct positionStruct {
     int contract_id = 0;
+    PositionKey key;
     Contract contract;
     std::vector<std::shared_ptr<Leg>> legs;    // pointer list for all legs that make up the position
     int open_quantity = 0;
     std::string ticker_symbol;
     std::string underlying;
     std::string expiry_date;
-    double strike_price = 0;
+    FixedPrice strike_price;
     std::string put_call;
     // References to Trade and Leg that this position belongs to. The IBKR contract reference gets
     // set when the positions are reconciled.
@@ -155,6 +204,13 @@ enum class ColorThemeType {
     Light
 };
 
+enum class TwsConnectionState {
+    Disconnected,
+    Connecting,
+    Connected,
+    Backoff         // connection was lost, waiting before the next reconnect attempt
+};
+
 enum class TabPanelItem {
     ActiveTrades,
     ClosedTrades,
@@ -318,7 +374,17 @@ void Tooltip(AppState& state, const char* label, const ImU32& text_color, const
 
 class Leg {
 public:
+    // The fields of the option contract that market data was requested for. A leg keeps
+    // its ticker_id across edits as long as these do not change (see RefreshAppState).
+    struct MarketDataContract {
+        Date       expiry_date;
+        FixedPrice strike_price;
+        PutCall    put_call = PutCall::Nothing;
+        bool operator==(const MarketDataContract&) const = default;
+    };
+
     bool         isOpen();                   // method to calc if leg quantity is not zero
+    MarketDataContract GetMarketDataContract() const { return { expiry_date, strike_price, put_call }; }
     bool         option_data_requested = false;  // Option data already requested
     TickerId     ticker_id           = -1;   // Set when retrieving Option leg data
     int          contract_id         = 0;    // Contract ID received from IBKR
@@ -326,12 +392,13 @@ public:
     int          leg_back_pointer_id = 0;    // If transaction is CLOSE, EXPIRE, ROLL this points back to leg where quantity modified
     int          original_quantity   = 0;
     int          open_quantity       = 0;
-    std::string  expiry_date         = "";
-    std::string  strike_price        = "";
+    Date         expiry_date;
+    std::string  invalid_expiry_date = "";   // original text if expiry_date could not be parsed (written back unchanged)
+    FixedPrice   strike_price;
     PutCall      put_call            = PutCall::Nothing;
     Action       action              = Action::Nothing;      // STO,BTO,STC,BTC
     Underlying   underlying          = Underlying::Nothing;  // OPTIONS, STOCKS, FUTURES, DIVIDEND, OTHER
-    std::shared_ptr<Transaction> trans = nullptr;            // back pointer to transaction that this leg belongs to
+    MarketDataContract market_data_contract;                 // contract that ticker_id was assigned for
 
     double calculated_leg_cost       = 0;    // refer to CalculateLegCosting(). Alternative for position_cost.
 
@@ -346,7 +413,8 @@ class Transaction {
 public:
     Underlying    underlying  = Underlying::Nothing;   // OPTIONS,STOCKS,FUTURES,DIVIDEND
     std::string   description = "";                    // Iron Condor, Strangle, Roll, Expired, Closed, Exercised, etc
-    std::string   trans_date  = "";                    // YYYY-MM-DD
+    Date          trans_date;
+    std::string   invalid_trans_date = "";             // original text if trans_date could not be parsed (written back unchanged)
     int           quantity    = 0;
     double        price       = 0;
     double        multiplier  = 0;
@@ -370,9 +438,14 @@ public:
 
 class Trade {
 public:
+    int           trade_id           = 0;    // Position of the Trade in the database file (see database_journal.cpp)
     bool          is_open            = true; // false if all legs are closed
     TickerId      ticker_id          = -1;
+    SymbolId      market_data_symbol_id = 0;  // symbol_id and future_expiry that ticker_id was assigned for
+    std::string   market_data_future_expiry = "";
     std::string   ticker_symbol      = "";
+    SymbolId      symbol_id          = 0;    // Interned ticker_symbol (see symbols.h). Set via SetTickerSymbol().
+    InstrumentInfo instrument;               // Cached config values for the ticker (see CConfig::GetInstrument)
     std::string   ticker_name        = "";
     std::string   future_expiry      = "";   // YYYYMM of Futures contract expiry
     std::string   notes              = "";
@@ -398,7 +471,7 @@ public:
     // vector is created during the CalculateAdjustedCostBase method. We use this vector when displaying
     // the Trade history.
     std::vector<SharesHistory> shares_history;
-    void AddSharesHistory(std::shared_ptr<Transaction> trans, Action leg_action, int open_quantity, double average_cost);
+    void AddSharesHistory(const std::shared_ptr<Transaction>& trans, Action leg_action, int open_quantity, double average_cost);
     void CalculateTotalSharesProfit(AppState& state);
 
     // The earliest DTE from the Legs of the Trade are calculated in the SetTradeOpenStatus() function
@@ -425,18 +498,21 @@ public:
     ImU32 ticker_column_3_clr{};
 
     // Dates used to calculate ROI on TradeBP.
-    std::string  bp_start_date = "99999999";            // YYYYMMDD  First transaction date
-    std::string  bp_end_date = "00000000";              // YYYYMMDD  Last trans expiry date or trade close date if earlier)
-    std::string  oldest_trade_trans_date = "00000000";  // If Trade is closed then this trans will be the BPendDate
+    Date  bp_start_date;                // First transaction date
+    Date  bp_end_date;                  // Last trans expiry date or trade close date if earlier)
+    Date  oldest_trade_trans_date;      // If Trade is closed then this trans will be the BPendDate
 
     std::vector<std::shared_ptr<Transaction>> transactions;     // pointer list for all transactions in the trade
     std::vector<std::shared_ptr<Leg>> open_legs;                // sorted list of open legs for this trade
 
+    void SetTickerSymbol(std::string_view symbol);
     void SetTradeOpenStatus();
     void CalculateAdjustedCostBase(AppState& state);
     void AverageCostACB(AppState& state);
     void FIFOCostACB(AppState& state);
     void CreateOpenLegsVector();
+    void CalculateBuyingPowerDates();
+    void CalculateDerivedValues(AppState& state);
 };
 
 
@@ -444,27 +520,70 @@ class CDatabase {
 public:
     std::string dbFilename;;
     std::string dbJournalNotes;
+    std::string dbSnapshot;
+    std::string dbJournal;
 
     bool is_previously_loaded = false;
 
     // Pointer list for all trades (initially loaded from database)
     std::vector<std::shared_ptr<Trade>> trades;
 
+    // Trades modified/deleted since the last save. These are appended to the journal.
+    std::vector<std::shared_ptr<Trade>> journal_modified_trades;
+    std::vector<int> journal_deleted_trade_ids;
+    int next_trade_id = 1;
+
+    // Trades modified/deleted since their derived values were last calculated. These are
+    // processed by RefreshAppState so that only the changed Trades are recalculated.
+    std::vector<std::shared_ptr<Trade>> modified_trades;
+    std::vector<std::shared_ptr<Trade>> deleted_trades;
+
+    // Columnar index of all Transactions used by the Transactions and Closed Trades panels.
+    // It is rebuilt on the next GetTransactionIndex() after the Trades change.
+    const CTransactionIndex& GetTransactionIndex();
+    void InvalidateTransactionIndex();
+
     std::string PutCallToString(const PutCall e);
-    PutCall StringToPutCall(const std::string& text);
+    PutCall StringToPutCall(std::string_view text);
 
-    Underlying StringToUnderlying(const std::string& underlying);
+    Underlying StringToUnderlying(std::string_view underlying);
     std::string UnderlyingToString(const Underlying e);
 
-    Action StringToAction(const std::string& action);
-    Action StringDescriptionToAction(const std::string& action);
+    Action StringToAction(std::string_view action);
+    Action StringDescriptionToAction(std::string_view action);
     std::string ActionToString(const Action e);
     std::string ActionToStringDescription(const Action e);
 
     bool LoadDatabase(AppState& state);
+    bool LoadDatabaseText(AppState& state);
+    bool ParseDatabaseLine(std::string_view input, std::vector<std::string_view>& st,
+                std::shared_ptr<Trade>& trade, std::shared_ptr<Transaction>& trans);
     bool SaveDatabase(AppState& state);
+    bool WriteDatabase(AppState& state);
+    void WriteTradeRecords(std::ostringstream& text, const std::shared_ptr<Trade>& trade, bool indent_open_trades);
+
+    // Append-only journal of modified Trades (see database_journal.cpp)
+    void SetTradeModified(const std::shared_ptr<Trade>& trade);
+    void SetTradeDeleted(const std::shared_ptr<Trade>& trade);
+    bool IsJournalPending();
+    bool IsJournalCompactionNeeded();
+    bool AppendJournal();
+    bool ReplayJournal();
+    bool CompactJournal(AppState& state);
+    void RemoveJournal();
+
+    // Binary snapshot of the text database (see database_snapshot.cpp)
+    bool LoadSnapshot();
+    bool SaveSnapshot();
 
     CDatabase();
+
+private:
+    CTransactionIndex trans_index;
+    bool is_trans_index_dirty = true;
+
+    // Writes journal batches on a background thread (see journal_writer.cpp)
+    CJournalWriter journal_writer;
 };
 
 
@@ -475,6 +594,9 @@ public:
     int startup_width = 0;
     int startup_height = 0;
     int startup_right_panel_width = 0;
+    int ticker_update_interval = 250;     // milliseconds between market data display updates
+    int max_fps = 60;                     // maximum frames per second while the app is active
+    double tick_replay_speed = 1;         // multiple of the recorded rate (0 = as fast as possible)
 
     float font_size = 16;
 
@@ -483,6 +605,11 @@ public:
     bool allow_update_check = true;
     bool exclude_nonstock_costs = false;
     bool show_45day_trade_date = true;
+    bool use_database_snapshot = true;
+    bool use_database_journal = true;
+
+    std::string tick_record_file;         // record TWS market data callbacks to this file (tick_recorder.cpp)
+    std::string tick_replay_file;         // replay this recording instead of connecting to TWS
 
     std::string label_45day_trade_date;
 
@@ -567,6 +694,17 @@ public:
         { "NANOS", true }
     };
 
+    // Values from the maps above for each interned symbol, indexed by SymbolId. Entries are
+    // resolved on first use. instrument_version changes whenever one of the maps changes so
+    // that the copies on each Trade are refreshed. The copies are made on the UI thread when
+    // a Trade is loaded or edited (ResolveInstrument). Any thread may read them (GetInstrument).
+    std::vector<InstrumentInfo> instruments;
+    uint32_t instrument_version = 1;
+    const InstrumentInfo& ResolveInstrument(SymbolId id);
+    void ResolveInstrument(Trade& trade);
+    const InstrumentInfo& GetInstrument(const Trade& trade) const;
+    void InvalidateInstruments();
+
     bool SaveConfig(AppState& state);
     bool LoadConfig(AppState& state);
 
@@ -603,6 +741,7 @@ struct AppState {
     std::string version_available_display = "";     // this is automatically populated when server is checked.
 
     int ticker_id = 1;    // incrementing counter for requesting market data
+    int first_new_ticker_id = 0;    // market data is requested for ids from here after RefreshAppState (0 = none)
 
     float dpi_scale = 1;
     int display_width = 0;
@@ -633,6 +772,7 @@ struct AppState {
     bool show_connect_rightclickmenu = false;
 
     bool is_activetrades_data_loaded = false;
+    std::atomic<int> activetrades_data_version = 0;   // incremented every time the list is rebuilt
     bool is_closedtrades_data_loaded = false;
     bool is_transactions_data_loaded = false;
     bool is_transedit_data_loaded = false;
@@ -691,10 +831,29 @@ struct AppState {
     std::atomic<bool> stop_monitor_thread_requested = false;
     std::atomic<bool> stop_ticker_update_thread_requested = false;
 
+    // Connection state machine run by the monitoring thread. The thread waits on the
+    // condition variable while disconnected and is woken to stop or to reconnect now.
+    std::atomic<TwsConnectionState> tws_connection_state = TwsConnectionState::Disconnected;
+    std::atomic<bool> is_reconnect_requested = false;
+    std::mutex monitor_mutex;
+    std::condition_variable monitor_cv;
+
     std::thread monitoring_thread;
     std::thread ticker_update_thread;
     std::thread check_for_update_thread;
 
+    // Wake the main loop from another thread (eg. new market data) so that a frame is
+    // drawn. The callback is set by the platform AppBase. Requests made before the main
+    // loop has handled the previous one are coalesced.
+    void (*redraw_callback)() = nullptr;
+    std::atomic<bool> is_redraw_pending = false;
+
+    void RequestRedraw() {
+        if (!redraw_callback) return;
+        if (is_redraw_pending.exchange(true)) return;
+        redraw_callback();
+    }
+
     std::string year_to_close;
 
     std::string tradehistory_ticker = "";
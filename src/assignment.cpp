@@ -48,13 +48,13 @@ void CalledAwayAssignment(AppState& state,
     std::shared_ptr<Leg> newleg;
 
     // Close the Option. Save this transaction's leg quantities
-    trans = std::make_shared<Transaction>();
-    trans->trans_date = called_away_date;
+    trans = model_arena.NewTransaction();
+    trans->trans_date = Date::FromString(called_away_date);
     trans->description = "Called away";
     trans->underlying = Underlying::Options;
     trade->transactions.push_back(trans);
 
-    newleg = std::make_shared<Leg>();
+    newleg = model_arena.NewLeg();
     trade->nextleg_id += 1;
     newleg->leg_id = trade->nextleg_id;
     newleg->underlying = trans->underlying;
@@ -73,25 +73,25 @@ void CalledAwayAssignment(AppState& state,
     if (leg->action == Action::STO) newleg->action = Action::BTC;
     if (leg->action == Action::BTO) newleg->action = Action::STC;
 
-    newleg->expiry_date = called_away_date;
+    newleg->expiry_date = Date::FromString(called_away_date);
     newleg->strike_price = leg->strike_price;
     newleg->put_call = leg->put_call;
     trans->legs.push_back(newleg);
 
 
     // Remove the SHARES/FUTURES that have been called away.
-    trans = std::make_shared<Transaction>();
-    trans->trans_date = called_away_date;
+    trans = model_arena.NewTransaction();
+    trans->trans_date = Date::FromString(called_away_date);
     trans->description = "Called away";
     trans->underlying = (is_shares) ? Underlying::Shares : Underlying::Futures;
     trans->quantity = quantity_assigned;
-    trans->price = AfxValDouble(leg->strike_price);
+    trans->price = leg->strike_price.ToDouble();
     trans->multiplier = multiplier;
     trans->fees = 0;
     trans->share_action= (leg->put_call == PutCall::Put) ? Action::BTC : Action::STC;
     trade->transactions.push_back(trans);
 
-    newleg = std::make_shared<Leg>();
+    newleg = model_arena.NewLeg();
     trade->nextleg_id += 1;
     newleg->leg_id = trade->nextleg_id;
     newleg->underlying = trans->underlying;
@@ -114,9 +114,10 @@ void CalledAwayAssignment(AppState& state,
 
     // Set the open status of the entire trade based on the new modified legs
     trade->SetTradeOpenStatus();
+    state.db.SetTradeModified(trade);
 
-    // Save/Load the new data to the database
-    ReloadAppState(state);
+    // Save the new data and recalculate the modified Trade
+    RefreshAppState(state);
 }
 
 
@@ -129,14 +130,14 @@ void CreateAssignment(AppState& state, std::shared_ptr<Trade> trade, std::shared
     std::shared_ptr<Leg> newleg;
 
     // Close the Option. Save this transaction's leg quantities
-    trans = std::make_shared<Transaction>();
-    trans->trans_date = assignment_date;
+    trans = model_arena.NewTransaction();
+    trans->trans_date = Date::FromString(assignment_date);
     trans->quantity = 1;   // must have something > 0 otherwise "Quantity error" if saving an Edit
     trans->description = "Assignment";
     trans->underlying = Underlying::Options;
     trade->transactions.push_back(trans);
 
-    newleg = std::make_shared<Leg>();
+    newleg = model_arena.NewLeg();
     trade->nextleg_id += 1;
     newleg->leg_id = trade->nextleg_id;
     newleg->underlying = trans->underlying;
@@ -156,23 +157,23 @@ void CreateAssignment(AppState& state, std::shared_ptr<Trade> trade, std::shared
     if (leg->action == Action::STO) newleg->action = Action::BTC;
     if (leg->action == Action::BTO) newleg->action = Action::STC;
 
-    newleg->expiry_date = assignment_date;
+    newleg->expiry_date = Date::FromString(assignment_date);
     newleg->strike_price = leg->strike_price;
     newleg->put_call = leg->put_call;
     trans->legs.push_back(newleg);
 
     // Make the SHARES/FUTURES that have been assigned.
-    trans = std::make_shared<Transaction>();
-    trans->trans_date = assignment_date;
+    trans = model_arena.NewTransaction();
+    trans->trans_date = Date::FromString(assignment_date);
     trans->description = "Assignment";
     trans->underlying = (is_shares) ? Underlying::Shares : Underlying::Futures;
     trans->quantity = quantity_assigned;
-    trans->price = AfxValDouble(leg->strike_price);
+    trans->price = leg->strike_price.ToDouble();
     trans->multiplier = multiplier;
     trans->fees = 0;
     trade->transactions.push_back(trans);
 
-    newleg = std::make_shared<Leg>();
+    newleg = model_arena.NewLeg();
     trade->nextleg_id += 1;
     newleg->leg_id = trade->nextleg_id;
     newleg->underlying = trans->underlying;
@@ -195,9 +196,10 @@ void CreateAssignment(AppState& state, std::shared_ptr<Trade> trade, std::shared
 
     // Set the open status of the entire trade based on the new modified legs
     trade->SetTradeOpenStatus();
+    state.db.SetTradeModified(trade);
 
-    // Save/Load the new data to the database
-    ReloadAppState(state);
+    // Save the new data and recalculate the modified Trade
+    RefreshAppState(state);
 }
 
 
@@ -277,7 +279,7 @@ void ShowAssignmentPopup(AppState& state) {
                     quantity_assigned = MIN(std::abs(leg->open_quantity * 100), std::abs(aggregate_shares));
                     leg_quantity = quantity_assigned / 100;
                     quantity_assigned_text = std::to_string(quantity_assigned);
-                    strike_price_text = " shares called away at $" + leg->strike_price + " per share.";
+                    strike_price_text = " shares called away at $" + leg->strike_price.ToString() + " per share.";
                     multiplier = 1;
                     caption = "SHARES CALLED AWAY";
                 }
@@ -285,7 +287,7 @@ void ShowAssignmentPopup(AppState& state) {
                     quantity_assigned = MIN(std::abs(leg->open_quantity), std::abs(aggregate_futures));
                     leg_quantity = quantity_assigned;
                     quantity_assigned_text = std::to_string(quantity_assigned);
-                    strike_price_text = " futures called away at $" + leg->strike_price + " per future.";
+                    strike_price_text = " futures called away at $" + leg->strike_price.ToString() + " per future.";
                     multiplier = trade->multiplier;
                     caption = "FUTURES CALLED AWAY";
                 }
@@ -298,14 +300,14 @@ void ShowAssignmentPopup(AppState& state) {
                 if (is_shares) {
                     quantity_assigned = std::abs(leg->open_quantity * 100);
                     quantity_assigned_text = std::to_string(quantity_assigned);
-                    strike_price_text = " shares at $" + leg->strike_price + " per share.";
+                    strike_price_text = " shares at $" + leg->strike_price.ToString() + " per share.";
                     multiplier = 1;
                     caption = "SHARES ASSIGNED";
                 }
                 else {
                     quantity_assigned = std::abs(leg->open_quantity);
                     quantity_assigned_text = std::to_string(quantity_assigned);
-                    strike_price_text = " futures at $" + leg->strike_price + " per future.";
+                    strike_price_text = " futures at $" + leg->strike_price.ToString() + " per future.";
                     multiplier = trade->multiplier;
                     caption = "FUTURES ASSIGNED";
                 }
@@ -53,9 +53,10 @@ void SetFirstLineClosedTrades(AppState& state, std::vector<CListPanelData>& vec)
 
 
 void LoadClosedTradesData(AppState& state, std::vector<CListPanelData>& vec) {
-    std::string start_date = state.filterpanel_start_date;
-    std::string end_date = state.filterpanel_end_date;
+    Date start_date = Date::FromString(state.filterpanel_start_date);
+    Date end_date = Date::FromString(state.filterpanel_end_date);
     std::string ticker = state.filterpanel_ticker_symbol;
+    SymbolId ticker_symbol_id = symbol_table.Find(ticker);
     int selected_category = state.filterpanel_selected_category;
 
     if (selected_category == CATEGORY_END + 1) selected_category = CATEGORY_OTHER;
@@ -65,32 +66,31 @@ void LoadClosedTradesData(AppState& state, std::vector<CListPanelData>& vec) {
         std::shared_ptr<Trade> trade;
         std::shared_ptr<Transaction> trans;
         std::string description;
-        std::string closed_date;
+        Date closed_date;
         double close_amount = 0;
     };
 
     std::vector<ClosedData> vectorClosed;
     vectorClosed.reserve(1000);         // reserve space for 1000 closed trades
 
-    // Look at all the closed trades as well as open trades that have shares/futures
-
-    for (auto& trade : state.db.trades) {
+    TransactionFilter filter;
+    filter.end_date = end_date;
+    filter.symbol_id = ticker_symbol_id;
+    filter.is_symbol_filtered = (ticker.length() > 0);
+    filter.category = selected_category;
+    filter.is_category_filtered = (selected_category != CATEGORY_ALL);
 
-        if (ticker.length() && ticker != trade->ticker_symbol) continue;
-
-        if (selected_category != CATEGORY_ALL) {
-            if (trade->category != selected_category) continue;
-        }
+    // Use the columnar index to find the Trades that pass the filter and whose latest
+    // Transaction is not after the end date.
+    const CTransactionIndex& index = state.db.GetTransactionIndex();
+    std::vector<uint32_t> trade_rows;
+    index.SelectTrades(filter, trade_rows);
 
-        // Iterate to find the latest closed date
-        std::string latest_closed_date;
-        for (auto& trans : trade->transactions) {
-            if (trans->trans_date > latest_closed_date) {
-                latest_closed_date = trans->trans_date;
-            }
-        } 
+    // Look at all the closed trades as well as open trades that have shares/futures
 
-        if (latest_closed_date > end_date) continue;
+    for (uint32_t k : trade_rows) {
+        const std::shared_ptr<Trade>& trade = index.trades[k];
+        Date latest_closed_date = Date(index.latest_trans_date[k]);
 
         // If this Trade has Shares/Futures transactions show the costing
         bool exclude_acb_non_shares = true;
@@ -106,8 +106,9 @@ void LoadClosedTradesData(AppState& state, std::vector<CListPanelData>& vec) {
                 int quantity = std::abs(share.open_quantity);
                 double price = share.trans->price;
 
-                if (state.config.IsFuturesTicker(trade->ticker_symbol)) {
-                    double multiplier = AfxValDouble(state.config.GetMultiplier(trade->ticker_symbol));
+                const InstrumentInfo& instrument = state.config.GetInstrument(*trade);
+                if (instrument.is_futures) {
+                    double multiplier = instrument.multiplier;
                     price *= multiplier;
                 }
 
@@ -147,7 +148,7 @@ void LoadClosedTradesData(AppState& state, std::vector<CListPanelData>& vec) {
                 data.close_amount = trade->acb_non_shares;
                 data.description = trade->ticker_name;
                 if (trade->ticker_symbol == "OTHER") data.description = trade->transactions[0]->description;
-                if (state.config.IsFuturesTicker(trade->ticker_symbol)) data.description += " (" + AfxFormatFuturesDate(trade->future_expiry) + ")";
+                if (state.config.GetInstrument(*trade).is_futures) data.description += " (" + AfxFormatFuturesDate(trade->future_expiry) + ")";
                 vectorClosed.push_back(data);
 
             }
@@ -163,7 +164,7 @@ void LoadClosedTradesData(AppState& state, std::vector<CListPanelData>& vec) {
                 data.close_amount = trade->acb_shares;
                 data.description = trade->ticker_name;
                 if (trade->ticker_symbol == "OTHER") data.description = trade->transactions[0]->description;
-                if (state.config.IsFuturesTicker(trade->ticker_symbol)) data.description += " (" + AfxFormatFuturesDate(trade->future_expiry) + ")";
+                if (state.config.GetInstrument(*trade).is_futures) data.description += " (" + AfxFormatFuturesDate(trade->future_expiry) + ")";
                 vectorClosed.push_back(data);
             }
         }
@@ -176,7 +177,7 @@ void LoadClosedTradesData(AppState& state, std::vector<CListPanelData>& vec) {
 
     // Sort the closed vector based on trade closed date
     std::sort(vectorClosed.begin(), vectorClosed.end(),
-        [](const ClosedData data1, const ClosedData data2) {
+        [](const ClosedData& data1, const ClosedData& data2) {
             return (data1.closed_date > data2.closed_date) ? true : false;
         });
 
@@ -206,15 +207,18 @@ void LoadClosedTradesData(AppState& state, std::vector<CListPanelData>& vec) {
     int year_win = 0;
     int year_loss = 0;
 
-    std::string today_date = AfxCurrentDate();
-    int today_year = AfxGetYear(today_date);
-    std::string week_start_date = AfxDateAddDays(today_date, -AfxLocalDayOfWeek());
-    std::string week_end_date = AfxDateAddDays(week_start_date, 6);
-    std::string current_date = "";
+    Date today_date = Date::Today();
+    int today_year = 0;
+    int today_month = 0;
+    int today_day = 0;
+    today_date.ToYMD(today_year, today_month, today_day);
+    Date week_start_date = today_date.AddDays(-AfxLocalDayOfWeek());
+    Date week_end_date = week_start_date.AddDays(6);
+    Date current_date;
 
     for (const auto& ClosedData : vectorClosed) {
-        current_month = AfxGetMonth(ClosedData.closed_date);
-        current_year = AfxGetYear(ClosedData.closed_date);
+        int current_day = 0;
+        ClosedData.closed_date.ToYMD(current_year, current_month, current_day);
 
         if (ClosedData.closed_date < start_date && current_year != today_year) continue;
 
@@ -242,8 +246,8 @@ void LoadClosedTradesData(AppState& state, std::vector<CListPanelData>& vec) {
         if (ClosedData.close_amount >= 0) ++current_month_win;
         if (ClosedData.close_amount < 0) ++current_month_loss;
 
-        if (current_month == AfxGetMonth(today_date) &&
-            current_year == AfxGetYear(today_date)) {
+        if (current_month == today_month &&
+            current_year == today_year) {
             monthly_amount += ClosedData.close_amount;
             if (ClosedData.close_amount >= 0) ++month_win;
             if (ClosedData.close_amount < 0) ++month_loss;
@@ -261,7 +265,7 @@ void LoadClosedTradesData(AppState& state, std::vector<CListPanelData>& vec) {
             if (ClosedData.close_amount < 0) ++day_loss;
         }
 
-        if (today_year == AfxGetYear(current_date)) {
+        if (today_year == current_year) {
             if (ClosedData.close_amount >= 0) ++year_win;
             if (ClosedData.close_amount < 0) ++year_loss;
             YTD += ClosedData.close_amount;
@@ -317,6 +321,7 @@ void ShowClosedTrades(AppState& state) {
 
         // Default to display the Trade History for the first entry in the list.
         SetFirstLineClosedTrades(state, vec);
+        ScrollToSelectedGridRow(lp);
 
         state.tradehistory_trade = state.closedtrades_selected_trade;
         SetTradeHistoryTrade(state, state.closedtrades_selected_trade);
@@ -33,6 +33,7 @@ SOFTWARE.
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <algorithm>
 #include "icons_material_design.h"
 
 
@@ -131,6 +132,60 @@ bool CConfig::IsFuturesTicker(const std::string& ticker) {
 }
 
 
+// ========================================================================================
+// Return the config values for the interned ticker symbol. UI thread only.
+// ========================================================================================
+const InstrumentInfo& CConfig::ResolveInstrument(SymbolId id) {
+    if (id >= instruments.size()) {
+        instruments.resize(symbol_table.Count());
+        if (id >= instruments.size()) instruments.resize((size_t)id + 1);
+    }
+
+    InstrumentInfo& info = instruments[id];
+    if (info.version != instrument_version) {
+        const std::string& ticker = symbol_table.Name(id);
+        info.symbol_id = id;
+        info.version = instrument_version;
+        info.multiplier = AfxValDouble(GetMultiplier(ticker));
+        info.ticker_decimals = GetTickerDecimals(ticker);
+        info.futures_exchange = GetFuturesExchange(ticker);
+        info.is_futures = IsFuturesTicker(ticker);
+        info.is_index = IsIndexTicker(ticker);
+    }
+    return info;
+}
+
+
+// ========================================================================================
+// Copy the config values for the Trade's ticker symbol to the Trade. Only done when the
+// Trade is new, its symbol has changed, or the config maps have changed. UI thread only
+// and only while market data is paused (the ticker update thread reads trade.instrument).
+// ========================================================================================
+void CConfig::ResolveInstrument(Trade& trade) {
+    if (trade.instrument.version != instrument_version || trade.instrument.symbol_id != trade.symbol_id) {
+        trade.instrument = ResolveInstrument(trade.symbol_id);
+    }
+}
+
+
+// ========================================================================================
+// Return the config values previously resolved for the Trade (see ResolveInstrument).
+// Read only so it can be called from any thread.
+// ========================================================================================
+const InstrumentInfo& CConfig::GetInstrument(const Trade& trade) const {
+    return trade.instrument;
+}
+
+
+// ========================================================================================
+// Discard the resolved instrument values after one of the config maps has changed.
+// ========================================================================================
+void CConfig::InvalidateInstruments() {
+    instruments.clear();
+    ++instrument_version;
+}
+
+
 // ========================================================================================
 // Determine if the incoming ticker symbol is an Index.
 // ========================================================================================
@@ -145,6 +200,7 @@ bool CConfig::IsIndexTicker(const std::string& ticker) {
 // ========================================================================================
 void CConfig::SetIndexTicker(const std::string& ticker) {
     mapIndexTickers[ticker] = true;
+    InvalidateInstruments();
 }
 
 
@@ -166,6 +222,7 @@ int CConfig::GetTickerDecimals(const std::string& underlying) {
 // ========================================================================================
 void CConfig::SetTickerDecimals(const std::string& underlying, int decimals) {
     mapTickerDecimals[underlying] = decimals;
+    InvalidateInstruments();
 }
 
 
@@ -187,6 +244,7 @@ std::string CConfig::GetMultiplier(const std::string& underlying) {
 // ========================================================================================
 void CConfig::SetMultiplier(const std::string& underlying, const std::string& multiplier) {
     mapMultipliers[underlying] = multiplier;
+    InvalidateInstruments();
 }
 
 
@@ -208,6 +266,7 @@ std::string CConfig::GetFuturesExchange(const std::string& underlying) {
 // ========================================================================================
 void CConfig::SetFuturesExchange(const std::string& underlying, const std::string& exchange) {
     mapFuturesExchanges[underlying] = exchange;
+    InvalidateInstruments();
 }
 
 
@@ -257,6 +316,20 @@ bool CConfig::SaveConfig(AppState& state) {
    
     text << "DISPLAYLICENSE|" << (display_open_source_license ? "true" : "false") << "\n";
 
+    text << "DATABASESNAPSHOT|" << (use_database_snapshot ? "true" : "false") << "\n";
+
+    text << "DATABASEJOURNAL|" << (use_database_journal ? "true" : "false") << "\n";
+
+    text << "TICKERUPDATEINTERVAL" << "|" << ticker_update_interval << "\n";
+
+    text << "MAXFPS" << "|" << max_fps << "\n";
+
+    text << "TICKRECORDFILE" << "|" << tick_record_file << "\n";
+
+    text << "TICKREPLAYFILE" << "|" << tick_replay_file << "\n";
+
+    text << "TICKREPLAYSPEED" << "|" << AfxDoubleToString(tick_replay_speed, 2) << "\n";
+
     text << "STARTUPWIDTH" << "|" << startup_width << "\n";
 
     text << "STARTUPHEIGHT" << "|" << startup_height << "\n";
@@ -307,12 +380,18 @@ bool CConfig::LoadConfig(AppState& state) {
         return false;
     }
 
-    std::string config_version;
-    std::string line;
+    db.close();
 
-    while (getline(db, line)) {
+    // Read the whole file into one buffer. Lines and tokens are string_views into
+    // that buffer so no per line allocations are made.
+    std::string buffer = AfxLoadFileIntoString(dbConfig);
+    std::string_view text(buffer);
+    std::string_view line;
+    std::vector<std::string_view> st;
+
+    while (AfxNextLine(text, line)) {
         // Trim leading and trailing white space
-        line = AfxTrim(line);
+        line = AfxTrimView(line);
 
         if (line.length() == 0) continue;
 
@@ -320,17 +399,17 @@ bool CConfig::LoadConfig(AppState& state) {
         if (line.compare(1, 3, "// ") == 0) continue;
 
         // Tokenize the line into a vector based on the pipe delimiter
-        std::vector<std::string> st = AfxSplit(line, L'|');
+        AfxSplitView(line, '|', st);
 
         if (st.empty()) continue;
 
-        std::string arg = AfxTrim(st.at(0));
+        std::string_view arg = AfxTrimView(st.at(0));
 
         // Determine the Starting day of th week
         if (arg == "STARTWEEKDAY") {
             std::string value;
             
-            try {value = AfxTrim(st.at(1)); }
+            try {value = AfxTrimView(st.at(1)); }
             catch (...) { continue; }
             start_weekday = StartWeekdayType::Sunday;
             if (value == "Monday") start_weekday = StartWeekdayType::Monday;
@@ -341,7 +420,7 @@ bool CConfig::LoadConfig(AppState& state) {
         if (arg == "NUMBERFORMAT") {
             std::string value;
             
-            try {value = AfxTrim(st.at(1)); }
+            try {value = AfxTrimView(st.at(1)); }
             catch (...) { continue; }
             number_format_type = NumberFormatType::American;
             if (value == "European") number_format_type = NumberFormatType::European;
@@ -352,7 +431,7 @@ bool CConfig::LoadConfig(AppState& state) {
         if (arg == "COLORTHEME") {
             std::string value;
             
-            try {value = AfxTrim(st.at(1)); }
+            try {value = AfxTrimView(st.at(1)); }
             catch (...) { continue; }
             color_theme = ColorThemeType::Dark;
             if (value == "Light") color_theme = ColorThemeType::Light;
@@ -363,7 +442,7 @@ bool CConfig::LoadConfig(AppState& state) {
         if (arg == "COSTINGMETHOD") {
             std::string value;
             
-            try {value = AfxTrim(st.at(1)); }
+            try {value = AfxTrimView(st.at(1)); }
             catch (...) { continue; }
             costing_method = CostingMethodType::AverageCost;
             if (value == "fifo") costing_method = CostingMethodType::fifo;
@@ -374,7 +453,7 @@ bool CConfig::LoadConfig(AppState& state) {
         if (arg == "EXCLUDENONSTOCKCOSTS") {
             std::string value;
             
-            try {value = AfxTrim(st.at(1)); }
+            try {value = AfxTrimView(st.at(1)); }
             catch (...) { continue; }
         
             exclude_nonstock_costs = (value == "true") ? true : false;
@@ -385,7 +464,7 @@ bool CConfig::LoadConfig(AppState& state) {
         if (arg == "SHOWPORTFOLIOVALUE") {
             std::string value;
             
-            try {value = AfxTrim(st.at(1)); }
+            try {value = AfxTrimView(st.at(1)); }
             catch (...) { continue; }
         
             show_portfolio_value = (value == "true") ? true : false;
@@ -396,7 +475,7 @@ bool CConfig::LoadConfig(AppState& state) {
         if (arg == "SHOW45TRADEDATE") {
             std::string value;
             
-            try {value = AfxTrim(st.at(1)); }
+            try {value = AfxTrimView(st.at(1)); }
             catch (...) { continue; }
         
             show_45day_trade_date = (value == "true") ? true : false;
@@ -407,7 +486,7 @@ bool CConfig::LoadConfig(AppState& state) {
         if (arg == "ALLOWUPDATECHECK") {
             std::string value;
             
-            try {value = AfxTrim(st.at(1)); }
+            try {value = AfxTrimView(st.at(1)); }
             catch (...) { continue; }
         
             allow_update_check = (value == "true") ? true : false;
@@ -418,18 +497,85 @@ bool CConfig::LoadConfig(AppState& state) {
         if (arg == "DISPLAYLICENSE") {
             std::string value;
             
-            try {value = AfxTrim(st.at(1)); }
+            try {value = AfxTrimView(st.at(1)); }
             catch (...) { continue; }
         
             display_open_source_license = (value == "true") ? true : false;
             continue;
         }
 
+        // Check if should use the binary snapshot to speed up loading the trades database
+        if (arg == "DATABASESNAPSHOT") {
+            std::string value;
+            
+            try {value = AfxTrimView(st.at(1)); }
+            catch (...) { continue; }
+        
+            use_database_snapshot = (value == "true") ? true : false;
+            continue;
+        }
+
+        // Check if should append changes to the journal rather than rewriting the trades database
+        if (arg == "DATABASEJOURNAL") {
+            std::string value;
+            
+            try {value = AfxTrimView(st.at(1)); }
+            catch (...) { continue; }
+        
+            use_database_journal = (value == "true") ? true : false;
+            continue;
+        }
+
+        // Check for the market data display update interval (milliseconds)
+        if (arg == "TICKERUPDATEINTERVAL") {
+            std::string interval;
+
+            try { interval = AfxTrimView(st.at(1)); }
+            catch (...) { continue; }
+
+            ticker_update_interval = std::clamp(AfxValInteger(interval), 50, 5000);
+            continue;
+        }
+
+        // Check for the maximum frames per second
+        if (arg == "MAXFPS") {
+            std::string fps;
+
+            try { fps = AfxTrimView(st.at(1)); }
+            catch (...) { continue; }
+
+            max_fps = std::clamp(AfxValInteger(fps), 5, 240);
+            continue;
+        }
+
+        // Check for the tick recording and replay files (developer load testing)
+        if (arg == "TICKRECORDFILE") {
+            try { tick_record_file = AfxTrimView(st.at(1)); }
+            catch (...) { continue; }
+            continue;
+        }
+
+        if (arg == "TICKREPLAYFILE") {
+            try { tick_replay_file = AfxTrimView(st.at(1)); }
+            catch (...) { continue; }
+            continue;
+        }
+
+        if (arg == "TICKREPLAYSPEED") {
+            std::string speed;
+
+            try { speed = AfxTrimView(st.at(1)); }
+            catch (...) { continue; }
+
+            tick_replay_speed = std::max(0.0, AfxValDouble(speed));
+            continue;
+        }
+
         // Check for startup_width
         if (arg == "STARTUPWIDTH") {
             std::string width;
 
-            try { width = AfxTrim(st.at(1)); }
+            try { width = AfxTrimView(st.at(1)); }
             catch (...) { continue; }
 
             startup_width = AfxValInteger(width);
@@ -440,7 +586,7 @@ bool CConfig::LoadConfig(AppState& state) {
         if (arg == "STARTUPHEIGHT") {
             std::string height;
 
-            try { height = AfxTrim(st.at(1)); }
+            try { height = AfxTrimView(st.at(1)); }
             catch (...) { continue; }
 
             startup_height = AfxValInteger(height);
@@ -451,7 +597,7 @@ bool CConfig::LoadConfig(AppState& state) {
         if (arg == "GUIFONTSIZE") {
             std::string value;
 
-            try { value = AfxTrim(st.at(1)); }
+            try { value = AfxTrimView(st.at(1)); }
             catch (...) { continue; }
 
             font_size = AfxValDouble(value);
@@ -478,7 +624,7 @@ bool CConfig::LoadConfig(AppState& state) {
         if (arg == "STARTUPRIGHTPANELWIDTH") {
             std::string width;
 
-            try { width = AfxTrim(st.at(1)); }
+            try { width = AfxTrimView(st.at(1)); }
             catch (...) { continue; }
 
             startup_right_panel_width = AfxValInteger(width);
@@ -530,7 +676,7 @@ bool CConfig::LoadConfig(AppState& state) {
             catch (...) {continue;}
             
             try { 
-                temp = AfxTrim(st.at(2));
+                temp = AfxTrimView(st.at(2));
                 decimals = AfxValInteger(temp);
             }
             catch (...) {continue;}
@@ -554,7 +700,10 @@ bool CConfig::LoadConfig(AppState& state) {
 
     }
 
-    db.close();
+    // The maps may have changed so refresh the values copied to any loaded Trades.
+    for (const auto& trade : state.db.trades) {
+        ResolveInstrument(*trade);
+    }
 
     return true;
 }
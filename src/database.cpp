@@ -25,20 +25,30 @@ SOFTWARE.
 */
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <algorithm>
+#include <iterator>
+#include <thread>
 
 #include "appstate.h"
 #include "utilities.h"
 #include "messagebox.h"
 
 
+// Smallest piece of the text database worth handing to its own thread when loading.
+static const size_t DATABASE_MIN_CHUNK_SIZE = 64 * 1024;
+
+
 CDatabase::CDatabase() {
     dbFilename = GetDataFilesFolder() + "/tt-database.db";
     dbJournalNotes = GetDataFilesFolder() + "/tt-notes.txt";
+    dbSnapshot = GetDataFilesFolder() + "/tt-database.snapshot";
+    dbJournal = GetDataFilesFolder() + "/tt-database.journal";
 }
 
 
@@ -49,7 +59,7 @@ std::string CDatabase::PutCallToString(const PutCall e) {
 }
 
 
-PutCall CDatabase::StringToPutCall(const std::string& text) {
+PutCall CDatabase::StringToPutCall(std::string_view text) {
     if (text == "P") return PutCall::Put;
     if (text == "C") return PutCall::Call;
     if (text.length() == 0) return PutCall::Nothing;
@@ -57,8 +67,8 @@ PutCall CDatabase::StringToPutCall(const std::string& text) {
 }
 
 
-Underlying CDatabase::StringToUnderlying(const std::string& text) {
-    static const std::unordered_map<std::string, Underlying> map = {
+Underlying CDatabase::StringToUnderlying(std::string_view text) {
+    static const std::unordered_map<std::string_view, Underlying> map = {
         {"0", Underlying::Options}, {"1", Underlying::Shares},
         {"2", Underlying::Futures}, {"3", Underlying::Dividend},
         {"4", Underlying::Other}
@@ -77,8 +87,8 @@ std::string CDatabase::UnderlyingToString(const Underlying e) {
 }
 
 
-Action CDatabase::StringDescriptionToAction(const std::string& text) {
-    static const std::unordered_map<std::string, Action> map = {
+Action CDatabase::StringDescriptionToAction(std::string_view text) {
+    static const std::unordered_map<std::string_view, Action> map = {
         {"STO", Action::STO}, {"BTO", Action::BTO},
         {"STC", Action::STC}, {"BTC", Action::BTC},
         {"", Action::Nothing}
@@ -91,8 +101,8 @@ Action CDatabase::StringDescriptionToAction(const std::string& text) {
     return (it != map.end()) ? it->second : Action::Nothing;
 }
 
-Action CDatabase::StringToAction(const std::string& text) {
-    static const std::unordered_map<std::string, Action> map = {
+Action CDatabase::StringToAction(std::string_view text) {
+    static const std::unordered_map<std::string_view, Action> map = {
         {"0", Action::STO}, {"1", Action::BTO},
         {"2", Action::STC}, {"3", Action::BTC},
         {"", Action::Nothing}
@@ -122,7 +132,84 @@ std::string CDatabase::ActionToStringDescription(const Action e) {
 }
 
 
+// ========================================================================================
+// Serialize a Trade and all of its Transactions and Legs as T|, X| and L| records.
+// Open trades are indented to give some visual breathing room in the text file.
+// ========================================================================================
+void CDatabase::WriteTradeRecords(std::ostringstream& text, const std::shared_ptr<Trade>& trade, bool indent_open_trades) {
+    static std::string p0 = "";
+    static std::string p2 = "  ";
+    static std::string p4 = "    ";
+
+    bool is_indented = (indent_open_trades && trade->is_open);
+
+    text << "T|"
+         << std::string(trade->is_open ? "1|" : "0|")
+         << trade->nextleg_id << "|"
+         << trade->ticker_symbol << "|"
+         << trade->ticker_name << "|"
+         << AfxReplace(trade->future_expiry, "-", "") << "|"
+         << trade->category << "|"
+         << AfxDoubleToString(trade->trade_bp, 0)  << "|"
+         << AfxReplace(trade->notes, "\n", "~~") << "|"
+         << trade->warning_3_dte << "|"
+         << trade->warning_21_dte << "|"
+         << AfxDoubleToString(trade->trade_profit_percentage, 4)
+         << "\n";
+
+    for (const auto& trans : trade->transactions) {
+        text << (is_indented ? p2 : p0) << "X|"
+             << (trans->trans_date.IsValid() ? trans->trans_date.ToCompactString() : trans->invalid_trans_date) << "|"
+             << trans->description << "|"
+             << UnderlyingToString(trans->underlying) << "|"
+             << trans->quantity << "|"
+             << AfxDoubleToString(trans->price, 4) << "|"
+             << AfxDoubleToString(trans->multiplier, 4) << "|"
+             << AfxDoubleToString(trans->fees, 4) << "|"
+             << AfxDoubleToString(trans->total, 4) << "|"
+             << ActionToString(trans->share_action)
+             << "\n";
+
+        for (const auto& leg : trans->legs) {
+             text << (is_indented ? p4 : p0) << "L|"
+                  << leg->leg_id << "|"
+                  << leg->leg_back_pointer_id << "|"
+                  << leg->original_quantity << "|"
+                  << leg->open_quantity << "|"
+                  << (leg->expiry_date.IsValid() ? leg->expiry_date.ToCompactString() : leg->invalid_expiry_date) << "|"
+                  << leg->strike_price.ToString() << "|"
+                  << PutCallToString(leg->put_call) << "|"
+                  << ActionToString(leg->action) << "|"
+                  << UnderlyingToString(leg->underlying)
+                  << "\n";
+        }
+    }
+}
+
+
+// ========================================================================================
+// Save the trades. In journaled mode only the Trades modified since the last save are
+// appended to the journal. The full database is rewritten if journaling is disabled,
+// nothing has been flagged as modified, or the journal has grown large enough that it
+// should be folded back into the main file.
+// ========================================================================================
 bool CDatabase::SaveDatabase(AppState& state) {
+    if (state.config.use_database_journal && IsJournalPending() && AfxFileExists(dbFilename)) {
+        if (AppendJournal() && !IsJournalCompactionNeeded()) return true;
+    }
+
+    return WriteDatabase(state);
+}
+
+
+// ========================================================================================
+// Rewrite the entire text database. Any journal is now folded into the main file and
+// can be removed.
+// ========================================================================================
+bool CDatabase::WriteDatabase(AppState& state) {
+    // Let any queued journal batches finish before the journal is replaced.
+    journal_writer.Flush();
+
     // Create and open a text file
     std::ofstream db(dbFilename);
 
@@ -150,213 +237,344 @@ bool CDatabase::SaveDatabase(AppState& state) {
         if (trade->is_open || prev_trade_was_open) text << "\n";
         prev_trade_was_open = trade->is_open;
 
-        text << "T|"
-             << std::string(trade->is_open ? "1|" : "0|")
-             << trade->nextleg_id << "|"
-             << trade->ticker_symbol << "|"
-             << trade->ticker_name << "|"
-             << AfxReplace(trade->future_expiry, "-", "") << "|"
-             << trade->category << "|"
-             << AfxDoubleToString(trade->trade_bp, 0)  << "|"
-             << AfxReplace(trade->notes, "\n", "~~") << "|"
-             << trade->warning_3_dte << "|"
-             << trade->warning_21_dte << "|"
-             << AfxDoubleToString(trade->trade_profit_percentage, 4)
-             << "\n";
-
-        static std::string p0 = "";
-        static std::string p2 = "  ";
-        static std::string p4 = "    ";
-
-        for (const auto& trans : trade->transactions) {
-            text << (trade->is_open ? p2 : p0) << "X|"
-                 << AfxReplace(trans->trans_date, "-", "") << "|"
-                 << trans->description << "|"
-                 << UnderlyingToString(trans->underlying) << "|"
-                 << trans->quantity << "|"
-                 << AfxDoubleToString(trans->price, 4) << "|"
-                 << AfxDoubleToString(trans->multiplier, 4) << "|"
-                 << AfxDoubleToString(trans->fees, 4) << "|"
-                 << AfxDoubleToString(trans->total, 4) << "|"
-                 << ActionToString(trans->share_action)
-                 << "\n";
-
-            for (const auto& leg : trans->legs) {
-                 text << (trade->is_open ? p4 : p0) << "L|"
-                      << leg->leg_id << "|"
-                      << leg->leg_back_pointer_id << "|"
-                      << leg->original_quantity << "|"
-                      << leg->open_quantity << "|"
-                      << AfxReplace(leg->expiry_date, "-", "") << "|"
-                      << leg->strike_price << "|"
-                      << PutCallToString(leg->put_call) << "|"
-                      << ActionToString(leg->action) << "|"
-                      << UnderlyingToString(leg->underlying)
-                      << "\n";
-            }
-        }
+        WriteTradeRecords(text, trade, true);
     }
 
     db << text.str();
     db.close();
 
+    // Keep the journal (and any journal write failure) if the main file was not written.
+    if (db.fail()) {
+        CustomMessageBox(state, "Warning", "Could not save trades database.");
+        return false;
+    }
+
+    // The main file now holds every change so the journal is no longer needed. Trade ids
+    // are renumbered to match the order of the trades in the file so that any new journal
+    // records refer to the same trades when the file is next loaded.
+    RemoveJournal();
+    for (size_t i = 0; i < trades.size(); ++i) {
+        trades[i]->trade_id = (int)i + 1;
+    }
+    next_trade_id = (int)trades.size() + 1;
+
+    // Refresh the binary snapshot so that it matches the text database just written.
+    if (state.config.use_database_snapshot) SaveSnapshot();
+
     return true;
 }
 
 
-inline static std::string try_catch_string(const std::vector<std::string>& st, const int idx) {
-    if (idx >= st.size() || idx < 0) return "";
+inline static std::string_view try_catch_string(const std::vector<std::string_view>& st, const int idx) {
+    if (idx >= st.size() || idx < 0) return std::string_view();
     return st.at(idx);
 }
 
 
-inline static int try_catch_int(const std::vector<std::string>& st, const int idx) {
-    std::string text = try_catch_string(st, idx);
-    return AfxValInteger(text);
+inline static int try_catch_int(const std::vector<std::string_view>& st, const int idx) {
+    return AfxValInteger(try_catch_string(st, idx));
 }
 
 
-inline static double try_catch_double(const std::vector<std::string>& st, const int idx) {
-    std::string text = try_catch_string(st, idx);
-    return AfxValDouble(text);
+inline static double try_catch_double(const std::vector<std::string_view>& st, const int idx) {
+    return AfxValDouble(try_catch_string(st, idx));
 }
 
 
-bool CDatabase::LoadDatabase(AppState& state) {
-    trades.clear();
-    trades.reserve(5000);         // reserve space for 5000 trades
+// ========================================================================================
+// Parse one line of the text database (or journal). A T| record starts a new Trade and
+// returns true so that the caller can take ownership of it. X| and L| records are
+// attached to the Trade and Transaction currently being built. The tokens vector is
+// supplied by the caller so that it can be reused for every line.
+// ========================================================================================
+bool CDatabase::ParseDatabaseLine(std::string_view input, std::vector<std::string_view>& st,
+            std::shared_ptr<Trade>& trade, std::shared_ptr<Transaction>& trans) {
+    // Trim leading and trailing white space
+    std::string_view line = AfxTrimView(input);
+
+    if (line.length() == 0) return false;
+
+    // If this is a Comment line then simply iterate to next line.
+    if (line.compare(1, 3, "// ") == 0) return false;
+
+    // Tokenize the line into a vector based on the pipe delimiter
+    AfxSplitView(line, '|', st);
+
+    if (st.empty()) return false;
+
+    std::string_view date_text;
+    std::string_view expiry_date;
+
+    // Check for Trades, Trans, and Legs
+    std::string_view action = try_catch_string(st, 0);
+
+    if (action == "T") {  // TRADE
+        trade = model_arena.NewTrade();
+        trade->is_open       = (try_catch_string(st, 1) == "0") ? false : true;
+        trade->nextleg_id    = try_catch_int(st, 2);
+        trade->SetTickerSymbol(try_catch_string(st, 3));
+        trade->ticker_name   = try_catch_string(st, 4);
+        date_text            = try_catch_string(st, 5);
+        trade->future_expiry = AfxInsertDateHyphens(date_text);
+        trade->category      = try_catch_int(st, 6);
+        trade->trade_bp      = try_catch_double(st, 7);
+        trade->notes         = AfxReplace(std::string(try_catch_string(st, 8)), "~~", "\n");
+        trade->warning_3_dte  = try_catch_int(st, 9);
+        trade->warning_21_dte = try_catch_int(st, 10);
+        trade->trade_profit_percentage = try_catch_double(st, 11);
+        return true;
+    }
 
-    // If database file does not exist then simply exit because default values
-    // will be used and then saved to disk.
-    if (!AfxFileExists(dbFilename)) return true;
+    if (action == "X") {  // TRANSACTION
+        trans = model_arena.NewTransaction();
+        trans->trans_date    = Date::FromString(try_catch_string(st, 1));
+        if (!trans->trans_date.IsValid()) trans->invalid_trans_date = try_catch_string(st, 1);
+        trans->description   = try_catch_string(st, 2);
+        trans->underlying    = StringToUnderlying(try_catch_string(st, 3));
+        trans->quantity      = try_catch_int(st, 4);
+        trans->price         = try_catch_double(st, 5);
+        trans->multiplier    = try_catch_double(st, 6);
+        trans->fees          = try_catch_double(st, 7);
+        trans->total         = try_catch_double(st, 8);
+        trans->share_action  = StringToAction(try_catch_string(st, 9));
+        if (trans->share_action == Action::Nothing) {
+            trans->share_action = (trans->total < 0) ? Action::BTO: Action::STO;
+        }
 
-    std::ifstream db(dbFilename);
-    if (!db) {
-        CustomMessageBox(state, "Warning", "Could not load trades database.");
+        if (trade) {
+            // Determine earliest and latest dates for BP ROI calculation.
+            Date trans_date = trans->trans_date;
+            if (trans_date.IsValid()) {
+                if (!trade->bp_start_date.IsValid() || trans_date < trade->bp_start_date) trade->bp_start_date = trans_date;
+                if (trans_date > trade->bp_end_date) trade->bp_end_date = trans_date;
+                if (trans_date > trade->oldest_trade_trans_date) trade->oldest_trade_trans_date = trans_date;
+            }
+            trade->transactions.emplace_back(trans);
+        }
         return false;
     }
 
-    std::shared_ptr<Trade> trade;
-    std::shared_ptr<Transaction> trans;
-    std::shared_ptr<Leg> leg;
-
-    std::string line;
-    std::string text;
-    std::string date_text;
-    std::string expiry_date;
-
-    std::vector<std::string> st;
-
-    while (getline(db, line)) {
-        // Trim leading and trailing white space
-        line = AfxTrim(line);
-
-        if (line.length() == 0) continue;
-
-        // If this is a Comment line then simply iterate to next line.
-        if (line.compare(1, 3, "// ") == 0) continue;
-
-        // Tokenize the line into a vector based on the pipe delimiter
-        st = AfxSplit(line, '|');
-
-        if (st.empty()) continue;
-
-        // Check for Trades, Trans, and Legs
-        std::string action = try_catch_string(st, 0);
-
-        if (action == "T") {  // TRADE
-            trade = std::make_shared<Trade>();
-            trade->is_open       = (try_catch_string(st, 1) == "0") ? false : true;
-            trade->nextleg_id    = try_catch_int(st, 2);
-            trade->ticker_symbol = try_catch_string(st, 3);
-            trade->ticker_name   = try_catch_string(st, 4);
-            date_text            = try_catch_string(st, 5);
-            trade->future_expiry = AfxInsertDateHyphens(date_text);
-            trade->category      = try_catch_int(st, 6);
-            trade->trade_bp      = try_catch_double(st, 7);
-            text                 = try_catch_string(st, 8);
-            trade->notes         = AfxReplace(text, "~~", "\n");
-            trade->warning_3_dte  = try_catch_int(st, 9);
-            trade->warning_21_dte = try_catch_int(st, 10);
-            trade->trade_profit_percentage = try_catch_double(st, 11);
-            trades.emplace_back(trade);
-            continue;
+    if (action == "L") {  // LEG
+        std::shared_ptr<Leg> leg = model_arena.NewLeg();
+        leg->leg_id              = try_catch_int(st, 1);
+        leg->leg_back_pointer_id = try_catch_int(st, 2);
+        leg->original_quantity   = try_catch_int(st, 3);
+        leg->open_quantity       = try_catch_int(st, 4);
+        leg->expiry_date         = Date::FromString(try_catch_string(st, 5));
+        if (!leg->expiry_date.IsValid()) leg->invalid_expiry_date = try_catch_string(st, 5);
+        leg->strike_price        = FixedPrice::FromString(try_catch_string(st, 6));
+        leg->put_call            = StringToPutCall(try_catch_string(st, 7));
+        leg->action              = StringToAction(try_catch_string(st, 8));
+        leg->underlying          = StringToUnderlying(try_catch_string(st, 9));
+
+        if (trans) {
+            if (trade) {
+                // Determine latest date for BP ROI calculation.
+                if (leg->expiry_date > trade->bp_end_date) trade->bp_end_date = leg->expiry_date;
+            }
+            trans->legs.emplace_back(leg);
         }
+        return false;
+    }
 
-        if (action == "X") {  // TRANSACTION
-            trans = std::make_shared<Transaction>();
-            date_text            = try_catch_string(st, 1);
-            trans->trans_date    = AfxInsertDateHyphens(date_text);
-            trans->description   = try_catch_string(st, 2);
-            trans->underlying    = StringToUnderlying(try_catch_string(st, 3));
-            trans->quantity      = try_catch_int(st, 4);
-            trans->price         = try_catch_double(st, 5);
-            trans->multiplier    = try_catch_double(st, 6);
-            trans->fees          = try_catch_double(st, 7);
-            trans->total         = try_catch_double(st, 8);
-            trans->share_action  = StringToAction(try_catch_string(st, 9));
-            if (trans->share_action == Action::Nothing) {
-                trans->share_action = (trans->total < 0) ? Action::BTO: Action::STO;
-            }
+    return false;
+}
 
-            if (trade) {
-                // Determine earliest and latest dates for BP ROI calculation.
-                if (AfxValDouble(date_text) < AfxValDouble(trade->bp_start_date)) trade->bp_start_date = date_text;
-                if (AfxValDouble(date_text) > AfxValDouble(trade->bp_end_date)) trade->bp_end_date = date_text;
-                if (AfxValDouble(date_text) > AfxValDouble(trade->oldest_trade_trans_date)) trade->oldest_trade_trans_date = date_text;
-                trade->transactions.emplace_back(trans);
+
+// ========================================================================================
+// Split the text database into (at most) num_chunks pieces. Every piece after the first
+// begins at the start of a T| line so that each piece only holds complete Trades.
+// ========================================================================================
+static std::vector<std::string_view> SplitAtTradeRecords(std::string_view text, size_t num_chunks) {
+    std::vector<std::string_view> chunks;
+    chunks.reserve(num_chunks);
+
+    size_t chunk_size = text.size() / (num_chunks ? num_chunks : 1);
+    size_t start = 0;
+
+    for (size_t i = 1; i < num_chunks; ++i) {
+        size_t pos = std::max(start, i * chunk_size);
+
+        // Advance to the beginning of the next line that is a Trade record
+        while (pos < text.size()) {
+            size_t eol = text.find('\n', pos);
+            if (eol == std::string_view::npos) {
+                pos = text.size();
+                break;
             }
-            continue;
+            pos = eol + 1;
+
+            size_t p = pos;
+            while (p < text.size() && (text[p] == ' ' || text[p] == '\t')) ++p;
+            if (text.compare(p, 2, "T|") == 0) break;
         }
 
-        if (action == "L") {  // LEG
-            leg = std::make_shared<Leg>();
-            leg->leg_id              = try_catch_int(st, 1);
-            leg->leg_back_pointer_id = try_catch_int(st, 2);
-            leg->original_quantity   = try_catch_int(st, 3);
-            leg->open_quantity       = try_catch_int(st, 4);
-            expiry_date              = try_catch_string(st, 5);
-            leg->expiry_date         = AfxInsertDateHyphens(expiry_date);
-            leg->strike_price        = try_catch_string(st, 6);
-            leg->put_call            = StringToPutCall(try_catch_string(st, 7));
-            leg->action              = StringToAction(try_catch_string(st, 8));
-            leg->underlying          = StringToUnderlying(try_catch_string(st, 9));
-
-            if (trans) {
-                leg->trans = trans;
-                if (trade) {
-                    // Determine latest date for BP ROI calculation.
-                    if (AfxValDouble(expiry_date) > AfxValDouble(trade->bp_end_date)) trade->bp_end_date = expiry_date;
+        if (pos >= text.size()) break;
+        chunks.emplace_back(text.substr(start, pos - start));
+        start = pos;
+    }
+
+    chunks.emplace_back(text.substr(start));
+    return chunks;
+}
+
+
+// ========================================================================================
+// Count the Trade, Transaction and Leg records in the text database so that the arena
+// can reserve its slabs before the parse.
+// ========================================================================================
+static void CountDatabaseRecords(std::string_view text, size_t& trade_count, size_t& trans_count, size_t& leg_count) {
+    trade_count = trans_count = leg_count = 0;
+
+    std::string_view line;
+    while (AfxNextLine(text, line)) {
+        size_t p = 0;
+        while (p < line.size() && (line[p] == ' ' || line[p] == '\t')) ++p;
+        if (p + 1 >= line.size() || line[p + 1] != '|') continue;
+
+        switch (line[p]) {
+        case 'T': ++trade_count; break;
+        case 'X': ++trans_count; break;
+        case 'L': ++leg_count; break;
+        }
+    }
+}
+
+
+bool CDatabase::LoadDatabaseText(AppState& state) {
+    std::ifstream db(dbFilename);
+    if (!db) {
+        CustomMessageBox(state, "Warning", "Could not load trades database.");
+        return false;
+    }
+    db.close();
+
+    // Read the whole file into one buffer. Lines and tokens are string_views into
+    // that buffer so no per line allocations are made while parsing.
+    std::string buffer = AfxLoadFileIntoString(dbFilename);
+
+    // Split the buffer into chunks that each start at a T| record. Every chunk holds
+    // complete Trades and is parsed on its own thread. The chunk results are then
+    // appended in order so the Trades keep their original file order.
+    size_t num_chunks = std::max<size_t>(1, std::thread::hardware_concurrency()) * 4;
+    num_chunks = std::min(num_chunks, buffer.size() / DATABASE_MIN_CHUNK_SIZE + 1);
+
+    size_t trade_count = 0;
+    size_t trans_count = 0;
+    size_t leg_count = 0;
+    CountDatabaseRecords(buffer, trade_count, trans_count, leg_count);
+    model_arena.Reserve(trade_count, trans_count, leg_count);
+
+    std::vector<std::string_view> chunks = SplitAtTradeRecords(buffer, num_chunks);
+    std::vector<std::vector<std::shared_ptr<Trade>>> chunk_trades(chunks.size());
+
+    AfxParallelFor(chunks.size(), 1, [&](size_t begin, size_t end) {
+        std::vector<std::string_view> st;
+        std::string_view line;
+
+        for (size_t i = begin; i < end; ++i) {
+            std::string_view text = chunks[i];
+            std::shared_ptr<Trade> trade;
+            std::shared_ptr<Transaction> trans;
+
+            while (AfxNextLine(text, line)) {
+                if (ParseDatabaseLine(line, st, trade, trans)) {
+                    chunk_trades[i].emplace_back(trade);
                 }
-                trans->legs.emplace_back(leg);
             }
-            continue;
         }
+    });
+
+    for (auto& vec : chunk_trades) {
+        trades.insert(trades.end(), std::make_move_iterator(vec.begin()), std::make_move_iterator(vec.end()));
     }
 
-    db.close();
+    return true;
+}
+
 
+bool CDatabase::LoadDatabase(AppState& state) {
+    // If the journal writer failed the changes it lost only exist in the loaded Trades.
+    // Write them to the main database before those Trades are discarded.
+    if (!journal_writer.Flush() && !trades.empty()) WriteDatabase(state);
+
+    InvalidateTransactionIndex();
+    trades.clear();
+    trades.reserve(5000);         // reserve space for 5000 trades
+
+    journal_modified_trades.clear();
+    journal_deleted_trade_ids.clear();
+    modified_trades.clear();
+    deleted_trades.clear();
+
+    // If database file does not exist then only a journal (if any) needs to be applied
+    // because default values will be used and then saved to disk.
+    if (AfxFileExists(dbFilename)) {
+        // Use the binary snapshot when it is current with the text database. Otherwise parse
+        // the text database and rebuild the snapshot so that the next load is fast.
+        bool is_snapshot_loaded = false;
+        if (state.config.use_database_snapshot) {
+            is_snapshot_loaded = LoadSnapshot();
+        }
+
+        if (!is_snapshot_loaded) {
+            trades.clear();
+            if (!LoadDatabaseText(state)) return false;
+            if (state.config.use_database_snapshot) SaveSnapshot();
+        }
+    }
+
+    // Trade ids follow the order of the trades in the main file. Journal records
+    // refer to trades using these ids.
+    for (size_t i = 0; i < trades.size(); ++i) {
+        trades[i]->trade_id = (int)i + 1;
+    }
+    next_trade_id = (int)trades.size() + 1;
+
+    ReplayJournal();
 
     // Now that the trades have been constructed, create the open position vector based
     // on a sorted list of open legs. We also calculate the ACB for the entire Trade
     // rather than physically storing that value in the database. This allows us to
     // manually edit individual Transactions externally and not have to go through
     // an error prone process of recalculating the ACB with the new change.
-    for (auto& trade : trades) {
-        if (trade->is_open) {
-            trade->CreateOpenLegsVector();
-        }
-        else {
-            // Trade is closed so set the BPendDate to be the oldest transaction in the Trade
-            trade->bp_end_date = trade->oldest_trade_trans_date;
-        }
-
-        // Calculate the full trade ACB and also the Shares ACB depending on what costing
-        // method has been chosen.
-        trade->CalculateAdjustedCostBase(state);
+    // Each Trade is independent of the others so the work is spread across threads.
+    // The config values used by the calculations are resolved first because that is not
+    // safe to do from the worker threads.
+    for (const auto& trade : trades) {
+        state.config.ResolveInstrument(*trade);
     }
 
+    AfxParallelFor(trades.size(), 256, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            trades[i]->CalculateDerivedValues(state);
+        }
+    });
+
     return true;
 }
 
 
+// ========================================================================================
+// Return the Transaction index, rebuilding it if the Trades have changed since it was
+// last built.
+// ========================================================================================
+const CTransactionIndex& CDatabase::GetTransactionIndex() {
+    if (is_trans_index_dirty) {
+        trans_index.Build(trades);
+        is_trans_index_dirty = false;
+    }
+    return trans_index;
+}
+
+
+// ========================================================================================
+// Flag the Transaction index as out of date. Called whenever Trades are loaded, added,
+// modified or deleted. The rows are dropped straight away so that the index does not
+// keep deleted Trades alive.
+// ========================================================================================
+void CDatabase::InvalidateTransactionIndex() {
+    trans_index.Clear();
+    is_trans_index_dirty = true;
+}
+
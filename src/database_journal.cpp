@@ -0,0 +1,306 @@
+/*
+
+MIT License
+
+Copyright(c) 2023-2025 Paul Squires
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+// The journal (tt-database.journal) is an append-only log of the Trades changed since
+// the main text database was last written. Each save appends one batch:
+//
+//   R|trade_id          replace (or add) the Trade with this id by the records that follow
+//   T|... X|... L|...   the Trade in exactly the same format as the main database
+//   D|trade_id          delete the Trade with this id
+//   C|num_records|num_bytes  commit marker with the number of R|/D| records and the size
+//                            of the batch text before the marker (each line ending counts
+//                            as one byte so a journal with "\r\n" endings is also accepted)
+//
+// A batch is only replayed if its commit marker matches the records that precede it.
+// Replay stops at the first batch that does not (e.g. a write that was interrupted) and
+// the journal is truncated there so that the next batch is appended after good data. If
+// not even the first batch is valid the journal is kept as tt-database.journal.bad.
+//
+// Trade ids are the 1-based position of the Trade in the main database file. Trades that
+// are created after the file was loaded receive the next unused id. The journal is folded
+// back into the main file (and removed) when it grows large and when the program exits.
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+
+#include "appstate.h"
+#include "utilities.h"
+
+
+namespace fs = std::filesystem;
+
+// Journal size at which the next save rewrites the main database instead.
+static const uintmax_t JOURNAL_COMPACT_SIZE = 512 * 1024;
+
+
+// ========================================================================================
+// Flag a Trade as modified so that it is written to the journal on the next save. New
+// Trades are assigned their trade id here.
+// ========================================================================================
+void CDatabase::SetTradeModified(const std::shared_ptr<Trade>& trade) {
+    if (!trade) return;
+    InvalidateTransactionIndex();
+    if (trade->trade_id == 0) trade->trade_id = next_trade_id++;
+
+    auto it = std::find(journal_modified_trades.begin(), journal_modified_trades.end(), trade);
+    if (it == journal_modified_trades.end()) journal_modified_trades.push_back(trade);
+
+    if (std::find(modified_trades.begin(), modified_trades.end(), trade) == modified_trades.end()) {
+        modified_trades.push_back(trade);
+    }
+}
+
+
+// ========================================================================================
+// Flag a Trade as deleted so that its removal is written to the journal on the next save.
+// ========================================================================================
+void CDatabase::SetTradeDeleted(const std::shared_ptr<Trade>& trade) {
+    if (!trade) return;
+    InvalidateTransactionIndex();
+
+    auto it = std::find(journal_modified_trades.begin(), journal_modified_trades.end(), trade);
+    if (it != journal_modified_trades.end()) journal_modified_trades.erase(it);
+
+    modified_trades.erase(std::remove(modified_trades.begin(), modified_trades.end(), trade), modified_trades.end());
+    deleted_trades.push_back(trade);
+
+    if (trade->trade_id != 0) journal_deleted_trade_ids.push_back(trade->trade_id);
+}
+
+
+// ========================================================================================
+// Determine if there are any modified or deleted Trades waiting to be saved.
+// ========================================================================================
+bool CDatabase::IsJournalPending() {
+    return (!journal_modified_trades.empty() || !journal_deleted_trade_ids.empty());
+}
+
+
+// ========================================================================================
+// Determine if the journal has grown large enough to be folded into the main database.
+// ========================================================================================
+bool CDatabase::IsJournalCompactionNeeded() {
+    // The size on disk lags any batches still queued for the journal writer. Those are
+    // counted at the next save.
+    std::error_code ec;
+    uintmax_t size = fs::file_size(dbJournal, ec);
+    if (ec) return false;
+    return (size >= JOURNAL_COMPACT_SIZE);
+}
+
+
+// ========================================================================================
+// Append the modified and deleted Trades to the journal as a single committed batch.
+// The batch text is built here and queued for the background journal writer.
+// ========================================================================================
+bool CDatabase::AppendJournal() {
+    std::ostringstream text;
+    int num_records = 0;
+
+    for (const auto& trade : journal_modified_trades) {
+        text << "R|" << trade->trade_id << "\n";
+        WriteTradeRecords(text, trade, false);
+        num_records++;
+    }
+
+    for (const auto& trade_id : journal_deleted_trade_ids) {
+        text << "D|" << trade_id << "\n";
+        num_records++;
+    }
+
+    size_t num_bytes = text.str().size();
+    text << "C|" << num_records << "|" << num_bytes << "\n";
+
+    // A batch that could not be written earlier is missing from the journal. Report the
+    // failure so that the caller rewrites the full database instead.
+    if (journal_writer.HasFailed()) return false;
+
+    // The batch is written by the background journal writer so the edit does not wait
+    // for the disk.
+    journal_writer.Append(dbJournal, text.str());
+
+    journal_modified_trades.clear();
+    journal_deleted_trade_ids.clear();
+
+    return true;
+}
+
+
+// ========================================================================================
+// Apply the committed batches of the journal to the Trades loaded from the main database.
+// ========================================================================================
+bool CDatabase::ReplayJournal() {
+    // A failed write is kept by the journal writer (see LoadDatabase) so that the next save
+    // rewrites the full database.
+    journal_writer.Flush();
+    if (!AfxFileExists(dbJournal)) return true;
+
+    std::string buffer = AfxLoadFileIntoString(dbJournal);
+
+    std::unordered_map<int, size_t> trade_index;
+    trade_index.reserve(trades.size());
+    for (size_t i = 0; i < trades.size(); ++i) {
+        trade_index[trades[i]->trade_id] = i;
+    }
+
+    std::vector<std::string_view> st;
+
+    auto apply_batch = [&](const std::vector<std::string_view>& batch) {
+        std::shared_ptr<Trade> trade;
+        std::shared_ptr<Transaction> trans;
+        int current_id = 0;
+
+        for (const auto& line : batch) {
+            if (line.compare(0, 2, "R|") == 0) {
+                current_id = AfxValInteger(line.substr(2));
+                trade = nullptr;
+                trans = nullptr;
+                continue;
+            }
+
+            if (line.compare(0, 2, "D|") == 0) {
+                auto it = trade_index.find(AfxValInteger(line.substr(2)));
+                if (it != trade_index.end()) {
+                    trades[it->second] = nullptr;
+                    trade_index.erase(it);
+                }
+                current_id = 0;
+                continue;
+            }
+
+            if (ParseDatabaseLine(line, st, trade, trans)) {
+                if (current_id <= 0) continue;
+                trade->trade_id = current_id;
+
+                auto it = trade_index.find(current_id);
+                if (it != trade_index.end()) {
+                    trades[it->second] = trade;
+                }
+                else {
+                    trade_index[current_id] = trades.size();
+                    trades.emplace_back(trade);
+                }
+                if (current_id >= next_trade_id) next_trade_id = current_id + 1;
+            }
+        }
+    };
+
+    std::vector<std::string_view> batch;
+    std::string_view text(buffer);
+    std::string_view line;
+
+    size_t batch_bytes = 0;          // size of the current batch counting each line ending as "\n"
+    size_t committed_end = 0;        // offset just past the last commit marker replayed
+    int num_batch_records = 0;
+    bool is_batch_valid = true;
+
+    while (AfxNextLine(text, line)) {
+        size_t line_end = buffer.size() - text.size();
+
+        if (line.compare(0, 2, "C|") == 0) {
+            // The marker must be complete and match the records and bytes of the batch.
+            AfxSplitView(line, '|', st);
+            bool is_committed = is_batch_valid && !batch.empty() &&
+                buffer[line_end - 1] == '\n' && st.size() >= 2 &&
+                AfxValInteger(st[1]) == num_batch_records &&
+                (st.size() < 3 || AfxValInteger(st[2]) == (int)batch_bytes);
+            if (!is_committed) break;
+
+            apply_batch(batch);
+            committed_end = line_end;
+
+            batch.clear();
+            batch_bytes = 0;
+            num_batch_records = 0;
+            continue;
+        }
+
+        if (line.compare(0, 2, "R|") == 0 || line.compare(0, 2, "D|") == 0) {
+            num_batch_records++;
+        }
+        else if (batch.empty() ||
+            (line.compare(0, 2, "T|") != 0 && line.compare(0, 2, "X|") != 0 && line.compare(0, 2, "L|") != 0)) {
+            // Every batch starts with a record header and contains only database records.
+            is_batch_valid = false;
+        }
+        batch.push_back(line);
+        batch_bytes += line.size() + 1;
+    }
+
+    // Anything after the last commit marker was never completely written (e.g. interrupted
+    // write). Cut it off so that it is not joined to the next batch that is appended.
+    if (committed_end == 0 && !buffer.empty()) {
+        // Nothing could be replayed. Keep the file for inspection rather than discarding
+        // it, but move it aside so that new batches start a clean journal.
+        std::error_code ec;
+        fs::rename(dbJournal, dbJournal + ".bad", ec);
+        std::cout << "Journal could not be replayed. Kept as " + dbJournal + ".bad" << std::endl;
+    }
+    else if (committed_end < buffer.size()) {
+        std::error_code ec;
+        fs::resize_file(dbJournal, committed_end, ec);
+        if (ec) std::cout << "Could not truncate file " + dbJournal << std::endl;
+    }
+
+    // Remove the Trades that were deleted by the journal.
+    trades.erase(std::remove(trades.begin(), trades.end(), nullptr), trades.end());
+
+    return true;
+}
+
+
+// ========================================================================================
+// Remove the journal file (its contents have been written to the main database).
+// ========================================================================================
+void CDatabase::RemoveJournal() {
+    // Every change is now in the main database, including any that the journal writer
+    // failed to write.
+    journal_writer.Flush();
+    journal_writer.ClearFailure();
+    journal_modified_trades.clear();
+    journal_deleted_trade_ids.clear();
+
+    std::error_code ec;
+    fs::remove(dbJournal, ec);
+}
+
+
+// ========================================================================================
+// Fold any existing journal into the main database. Called when the program exits.
+// ========================================================================================
+bool CDatabase::CompactJournal(AppState& state) {
+    // The journal is missing changes if a write failed so rewrite from the loaded Trades.
+    if (!journal_writer.Flush()) return WriteDatabase(state);
+    if (!AfxFileExists(dbJournal)) return true;
+    return WriteDatabase(state);
+}
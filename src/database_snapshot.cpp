@@ -0,0 +1,508 @@
+/*
+
+MIT License
+
+Copyright(c) 2023-2025 Paul Squires
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+// The binary snapshot is a cache of tt-database.db that can be memory mapped and turned
+// back into Trades with almost no parsing. The text database always remains the source
+// of truth. The snapshot stores the size and last write time of the text file that it
+// was built from and is simply ignored (and later rebuilt) whenever those no longer match.
+//
+// Layout (all values little endian, every section aligned on 8 bytes):
+//   SnapshotHeader
+//   SnapshotTrade[trade_count]
+//   SnapshotTrans[trans_count]      (grouped by Trade in Trade order)
+//   SnapshotLeg[leg_count]          (grouped by Transaction in Transaction order)
+//   string pool                     (SnapshotString offset/length pairs point in here)
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(_WIN32) // win32 and win64
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "appstate.h"
+#include "utilities.h"
+
+
+namespace fs = std::filesystem;
+
+static const char SNAPSHOT_MAGIC[8] = { 'T', 'T', 'S', 'N', 'A', 'P', '\0', '\0' };
+static const uint32_t SNAPSHOT_VERSION = 4;
+
+struct SnapshotString {
+    uint32_t offset = 0;
+    uint32_t length = 0;
+};
+
+struct SnapshotHeader {
+    char     magic[8]{};
+    uint32_t version = 0;
+    uint32_t header_size = 0;
+    uint64_t source_size = 0;      // size of tt-database.db when the snapshot was written
+    int64_t  source_mtime = 0;     // last write time of tt-database.db when the snapshot was written
+    uint32_t trade_count = 0;
+    uint32_t trans_count = 0;
+    uint32_t leg_count = 0;
+    uint32_t reserved = 0;
+    uint64_t trades_offset = 0;
+    uint64_t trans_offset = 0;
+    uint64_t legs_offset = 0;
+    uint64_t strings_offset = 0;
+    uint64_t strings_size = 0;
+};
+
+struct SnapshotTrade {
+    SnapshotString ticker_symbol;
+    SnapshotString ticker_name;
+    SnapshotString future_expiry;
+    SnapshotString notes;
+    double   trade_bp = 0;
+    double   trade_profit_percentage = 0;
+    int32_t  nextleg_id = 0;
+    int32_t  category = 0;
+    uint32_t first_trans = 0;
+    uint32_t trans_count = 0;
+    uint8_t  is_open = 0;
+    uint8_t  warning_3_dte = 0;
+    uint8_t  warning_21_dte = 0;
+    uint8_t  padding[5]{};
+};
+
+struct SnapshotTrans {
+    SnapshotString description;
+    SnapshotString invalid_trans_date;
+    double   price = 0;
+    double   multiplier = 0;
+    double   fees = 0;
+    double   total = 0;
+    int32_t  quantity = 0;
+    int32_t  trans_date = Date::NONE;  // days since 1970-01-01 (see date.h)
+    uint32_t first_leg = 0;
+    uint32_t leg_count = 0;
+    uint8_t  underlying = 0;
+    uint8_t  share_action = 0;
+    uint8_t  padding[6]{};
+};
+
+struct SnapshotLeg {
+    FixedPrice strike_price;
+    SnapshotString invalid_expiry_date;
+    int32_t  leg_id = 0;
+    int32_t  leg_back_pointer_id = 0;
+    int32_t  original_quantity = 0;
+    int32_t  open_quantity = 0;
+    int32_t  expiry_date = Date::NONE; // days since 1970-01-01 (see date.h)
+    uint8_t  put_call = 0;
+    uint8_t  action = 0;
+    uint8_t  underlying = 0;
+    uint8_t  padding = 0;
+};
+
+static_assert(std::is_trivially_copyable_v<SnapshotHeader>);
+static_assert(std::is_trivially_copyable_v<SnapshotTrade>);
+static_assert(std::is_trivially_copyable_v<SnapshotTrans>);
+static_assert(std::is_trivially_copyable_v<SnapshotLeg>);
+static_assert(sizeof(SnapshotTrade) % 8 == 0 && sizeof(SnapshotTrans) % 8 == 0 && sizeof(SnapshotLeg) % 8 == 0);
+
+
+// ========================================================================================
+// Read-only memory mapping of an entire file. The mapping is released when the
+// object goes out of scope.
+// ========================================================================================
+class CMappedFile {
+public:
+    const char* view = nullptr;
+    size_t view_size = 0;
+
+    bool Open(const std::string& filename) {
+#if defined(_WIN32)
+        file_handle = CreateFileW(ansi2unicode(filename).c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file_handle == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER file_size{};
+        if (!GetFileSizeEx(file_handle, &file_size) || file_size.QuadPart == 0) return false;
+
+        mapping_handle = CreateFileMappingW(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping_handle == NULL) return false;
+
+        view = static_cast<const char*>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+        if (view == nullptr) return false;
+        view_size = (size_t)file_size.QuadPart;
+#else
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd == -1) return false;
+
+        struct stat sb {};
+        if (fstat(fd, &sb) == -1 || sb.st_size == 0) {
+            close(fd);
+            return false;
+        }
+
+        void* p = mmap(nullptr, (size_t)sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) return false;
+
+        view = static_cast<const char*>(p);
+        view_size = (size_t)sb.st_size;
+#endif
+        return true;
+    }
+
+    ~CMappedFile() {
+#if defined(_WIN32)
+        if (view) UnmapViewOfFile(view);
+        if (mapping_handle != NULL) CloseHandle(mapping_handle);
+        if (file_handle != INVALID_HANDLE_VALUE) CloseHandle(file_handle);
+#else
+        if (view) munmap((void*)view, view_size);
+#endif
+    }
+
+private:
+#if defined(_WIN32)
+    HANDLE file_handle = INVALID_HANDLE_VALUE;
+    HANDLE mapping_handle = NULL;
+#endif
+};
+
+
+// ========================================================================================
+// Retrieve the size and last write time of the text database. These values are
+// stored in the snapshot header and used to determine if the snapshot is stale.
+// ========================================================================================
+static bool GetSourceFileStamp(const std::string& filename, uint64_t& source_size, int64_t& source_mtime) {
+    std::error_code ec;
+    source_size = (uint64_t)fs::file_size(filename, ec);
+    if (ec) return false;
+    auto ftime = fs::last_write_time(filename, ec);
+    if (ec) return false;
+    source_mtime = (int64_t)ftime.time_since_epoch().count();
+    return true;
+}
+
+
+// ========================================================================================
+// Append a string to the snapshot string pool. Identical strings (ticker symbols,
+// descriptions) are only stored once.
+// ========================================================================================
+static SnapshotString AddPoolString(std::string& pool,
+            std::unordered_map<std::string, SnapshotString>& pool_index, const std::string& text) {
+    if (text.empty()) return SnapshotString{};
+
+    auto it = pool_index.find(text);
+    if (it != pool_index.end()) return it->second;
+
+    SnapshotString s;
+    s.offset = (uint32_t)pool.size();
+    s.length = (uint32_t)text.size();
+    pool.append(text);
+    pool_index.emplace(text, s);
+    return s;
+}
+
+
+static void AppendRecord(std::string& buffer, const void* record, size_t record_size) {
+    buffer.append(static_cast<const char*>(record), record_size);
+}
+
+
+static void AlignBuffer(std::string& buffer) {
+    while (buffer.size() % 8) buffer.push_back('\0');
+}
+
+
+// ========================================================================================
+// Write the binary snapshot of the currently loaded trades. The snapshot is written to
+// a temporary file and then renamed so that a partially written snapshot is never
+// seen by LoadSnapshot.
+// ========================================================================================
+bool CDatabase::SaveSnapshot() {
+    SnapshotHeader header;
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = SNAPSHOT_VERSION;
+    header.header_size = sizeof(SnapshotHeader);
+
+    if (!GetSourceFileStamp(dbFilename, header.source_size, header.source_mtime)) return false;
+
+    std::vector<SnapshotTrade> snap_trades;
+    std::vector<SnapshotTrans> snap_trans;
+    std::vector<SnapshotLeg> snap_legs;
+    snap_trades.reserve(trades.size());
+
+    std::string pool;
+    std::unordered_map<std::string, SnapshotString> pool_index;
+
+    for (const auto& trade : trades) {
+        SnapshotTrade t;
+        t.ticker_symbol = AddPoolString(pool, pool_index, trade->ticker_symbol);
+        t.ticker_name   = AddPoolString(pool, pool_index, trade->ticker_name);
+        t.future_expiry = AddPoolString(pool, pool_index, trade->future_expiry);
+        t.notes         = AddPoolString(pool, pool_index, trade->notes);
+        t.trade_bp      = trade->trade_bp;
+        t.trade_profit_percentage = trade->trade_profit_percentage;
+        t.nextleg_id    = trade->nextleg_id;
+        t.category      = trade->category;
+        t.is_open       = trade->is_open ? 1 : 0;
+        t.warning_3_dte  = trade->warning_3_dte ? 1 : 0;
+        t.warning_21_dte = trade->warning_21_dte ? 1 : 0;
+        t.first_trans   = (uint32_t)snap_trans.size();
+        t.trans_count   = (uint32_t)trade->transactions.size();
+
+        for (const auto& trans : trade->transactions) {
+            SnapshotTrans x;
+            x.description  = AddPoolString(pool, pool_index, trans->description);
+            x.trans_date   = trans->trans_date.DaysSinceEpoch();
+            x.invalid_trans_date = AddPoolString(pool, pool_index, trans->invalid_trans_date);
+            x.price        = trans->price;
+            x.multiplier   = trans->multiplier;
+            x.fees         = trans->fees;
+            x.total        = trans->total;
+            x.quantity     = trans->quantity;
+            x.underlying   = (uint8_t)trans->underlying;
+            x.share_action = (uint8_t)trans->share_action;
+            x.first_leg    = (uint32_t)snap_legs.size();
+            x.leg_count    = (uint32_t)trans->legs.size();
+
+            for (const auto& leg : trans->legs) {
+                SnapshotLeg l;
+                l.expiry_date         = leg->expiry_date.DaysSinceEpoch();
+                l.invalid_expiry_date = AddPoolString(pool, pool_index, leg->invalid_expiry_date);
+                l.strike_price        = leg->strike_price;
+                l.leg_id              = leg->leg_id;
+                l.leg_back_pointer_id = leg->leg_back_pointer_id;
+                l.original_quantity   = leg->original_quantity;
+                l.open_quantity       = leg->open_quantity;
+                l.put_call            = (uint8_t)leg->put_call;
+                l.action              = (uint8_t)leg->action;
+                l.underlying          = (uint8_t)leg->underlying;
+                snap_legs.push_back(l);
+            }
+            snap_trans.push_back(x);
+        }
+        snap_trades.push_back(t);
+    }
+
+    header.trade_count = (uint32_t)snap_trades.size();
+    header.trans_count = (uint32_t)snap_trans.size();
+    header.leg_count   = (uint32_t)snap_legs.size();
+
+    std::string buffer;
+    buffer.reserve(sizeof(SnapshotHeader) + snap_trades.size() * sizeof(SnapshotTrade) +
+                   snap_trans.size() * sizeof(SnapshotTrans) + snap_legs.size() * sizeof(SnapshotLeg) +
+                   pool.size() + 32);
+
+    // The header is written again once all of the section offsets are known.
+    AppendRecord(buffer, &header, sizeof(header));
+    AlignBuffer(buffer);
+
+    header.trades_offset = buffer.size();
+    if (!snap_trades.empty()) AppendRecord(buffer, snap_trades.data(), snap_trades.size() * sizeof(SnapshotTrade));
+
+    header.trans_offset = buffer.size();
+    if (!snap_trans.empty()) AppendRecord(buffer, snap_trans.data(), snap_trans.size() * sizeof(SnapshotTrans));
+
+    header.legs_offset = buffer.size();
+    if (!snap_legs.empty()) AppendRecord(buffer, snap_legs.data(), snap_legs.size() * sizeof(SnapshotLeg));
+
+    header.strings_offset = buffer.size();
+    header.strings_size = pool.size();
+    buffer.append(pool);
+    AlignBuffer(buffer);
+
+    std::memcpy(buffer.data(), &header, sizeof(header));
+
+    std::string temp_filename = dbSnapshot + ".tmp";
+    {
+        std::ofstream out(temp_filename, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cout << "Could not open file " + temp_filename << std::endl;
+            return false;
+        }
+        out.write(buffer.data(), (std::streamsize)buffer.size());
+        if (!out.good()) {
+            std::cout << "Error occurred while writing to file " + temp_filename << std::endl;
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(temp_filename, dbSnapshot, ec);
+    if (ec) {
+        std::cout << "Could not replace database snapshot " + dbSnapshot << std::endl;
+        fs::remove(temp_filename, ec);
+        return false;
+    }
+
+    return true;
+}
+
+
+// ========================================================================================
+// Load the trades from the binary snapshot. Returns false (and leaves the trades vector
+// empty) if the snapshot does not exist, is from a different version, is damaged, or
+// is stale relative to the text database. The caller then falls back to the text file.
+// ========================================================================================
+bool CDatabase::LoadSnapshot() {
+    if (!AfxFileExists(dbSnapshot)) return false;
+
+    CMappedFile file;
+    if (!file.Open(dbSnapshot)) return false;
+    if (file.view_size < sizeof(SnapshotHeader)) return false;
+
+    SnapshotHeader header;
+    std::memcpy(&header, file.view, sizeof(header));
+
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) return false;
+    if (header.version != SNAPSHOT_VERSION) return false;
+    if (header.header_size != sizeof(SnapshotHeader)) return false;
+
+    uint64_t source_size = 0;
+    int64_t source_mtime = 0;
+    if (!GetSourceFileStamp(dbFilename, source_size, source_mtime)) return false;
+    if (header.source_size != source_size || header.source_mtime != source_mtime) return false;
+
+    // Ensure every section lies entirely within the mapped file before touching it.
+    auto section_fits = [&](uint64_t offset, uint64_t count, uint64_t record_size) {
+        return offset <= file.view_size && count * record_size <= file.view_size - offset;
+    };
+    if (!section_fits(header.trades_offset, header.trade_count, sizeof(SnapshotTrade))) return false;
+    if (!section_fits(header.trans_offset, header.trans_count, sizeof(SnapshotTrans))) return false;
+    if (!section_fits(header.legs_offset, header.leg_count, sizeof(SnapshotLeg))) return false;
+    if (!section_fits(header.strings_offset, header.strings_size, 1)) return false;
+
+    const char* pool = file.view + header.strings_offset;
+    bool is_damaged = false;
+
+    auto pool_string = [&](const SnapshotString& s) {
+        if ((uint64_t)s.offset + s.length > header.strings_size) {
+            is_damaged = true;
+            return std::string();
+        }
+        return std::string(pool + s.offset, s.length);
+    };
+
+    std::vector<std::shared_ptr<Trade>> loaded_trades;
+    loaded_trades.reserve(header.trade_count);
+    model_arena.Reserve(header.trade_count, header.trans_count, header.leg_count);
+
+    for (uint32_t i = 0; i < header.trade_count; ++i) {
+        SnapshotTrade t;
+        std::memcpy(&t, file.view + header.trades_offset + (uint64_t)i * sizeof(SnapshotTrade), sizeof(t));
+        if ((uint64_t)t.first_trans + t.trans_count > header.trans_count) return false;
+
+        auto trade = model_arena.NewTrade();
+        trade->is_open        = (t.is_open != 0);
+        trade->nextleg_id     = t.nextleg_id;
+        trade->SetTickerSymbol(pool_string(t.ticker_symbol));
+        trade->ticker_name    = pool_string(t.ticker_name);
+        trade->future_expiry  = pool_string(t.future_expiry);
+        trade->category       = t.category;
+        trade->trade_bp       = t.trade_bp;
+        trade->notes          = pool_string(t.notes);
+        trade->warning_3_dte  = (t.warning_3_dte != 0);
+        trade->warning_21_dte = (t.warning_21_dte != 0);
+        trade->trade_profit_percentage = t.trade_profit_percentage;
+        trade->transactions.reserve(t.trans_count);
+
+        // Determine earliest and latest dates for BP ROI calculation (same rules
+        // as used when loading the text database).
+        Date bp_start_date;
+        Date bp_end_date;
+        Date oldest_trade_trans_date;
+
+        for (uint32_t j = t.first_trans; j < t.first_trans + t.trans_count; ++j) {
+            SnapshotTrans x;
+            std::memcpy(&x, file.view + header.trans_offset + (uint64_t)j * sizeof(SnapshotTrans), sizeof(x));
+            if ((uint64_t)x.first_leg + x.leg_count > header.leg_count) return false;
+
+            auto trans = model_arena.NewTransaction();
+            trans->trans_date   = Date(x.trans_date);
+            trans->invalid_trans_date = pool_string(x.invalid_trans_date);
+            trans->description  = pool_string(x.description);
+            trans->underlying   = (Underlying)x.underlying;
+            trans->quantity     = x.quantity;
+            trans->price        = x.price;
+            trans->multiplier   = x.multiplier;
+            trans->fees         = x.fees;
+            trans->total        = x.total;
+            trans->share_action = (Action)x.share_action;
+            trans->legs.reserve(x.leg_count);
+
+            if (trans->trans_date.IsValid()) {
+                if (!bp_start_date.IsValid() || trans->trans_date < bp_start_date) bp_start_date = trans->trans_date;
+                if (trans->trans_date > bp_end_date) bp_end_date = trans->trans_date;
+                if (trans->trans_date > oldest_trade_trans_date) oldest_trade_trans_date = trans->trans_date;
+            }
+
+            for (uint32_t k = x.first_leg; k < x.first_leg + x.leg_count; ++k) {
+                SnapshotLeg l;
+                std::memcpy(&l, file.view + header.legs_offset + (uint64_t)k * sizeof(SnapshotLeg), sizeof(l));
+
+                auto leg = model_arena.NewLeg();
+                leg->leg_id              = l.leg_id;
+                leg->leg_back_pointer_id = l.leg_back_pointer_id;
+                leg->original_quantity   = l.original_quantity;
+                leg->open_quantity       = l.open_quantity;
+                leg->expiry_date         = Date(l.expiry_date);
+                leg->invalid_expiry_date = pool_string(l.invalid_expiry_date);
+                leg->strike_price        = l.strike_price;
+                leg->put_call            = (PutCall)l.put_call;
+                leg->action              = (Action)l.action;
+                leg->underlying          = (Underlying)l.underlying;
+
+                if (leg->expiry_date > bp_end_date) bp_end_date = leg->expiry_date;
+
+                trans->legs.emplace_back(leg);
+            }
+
+            trade->transactions.emplace_back(trans);
+        }
+
+        trade->bp_start_date = bp_start_date;
+        trade->bp_end_date = bp_end_date;
+        trade->oldest_trade_trans_date = oldest_trade_trans_date;
+
+        loaded_trades.emplace_back(trade);
+    }
+
+    if (is_damaged) return false;
+
+    trades = std::move(loaded_trades);
+    return true;
+}
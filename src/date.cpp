@@ -0,0 +1,189 @@
+/*
+
+MIT License
+
+Copyright(c) 2023-2025 Paul Squires
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <chrono>
+
+#include "date.h"
+
+using namespace std::chrono;
+
+
+// ========================================================================================
+// Parse a run of digits. Returns false if any character is not a digit.
+// ========================================================================================
+static bool ParseDigits(std::string_view text, int& value) {
+    value = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') return false;
+        value = value * 10 + (c - '0');
+    }
+    return true;
+}
+
+
+// ========================================================================================
+// Create a Date from YYYY-MM-DD or YYYYMMDD text. Returns an empty Date if the text is
+// not a valid date.
+// ========================================================================================
+Date Date::FromString(std::string_view text) {
+    int y = 0, m = 0, d = 0;
+    if (text.length() == 10 && text[4] == '-' && text[7] == '-') {
+        if (!ParseDigits(text.substr(0, 4), y) || !ParseDigits(text.substr(5, 2), m) ||
+            !ParseDigits(text.substr(8, 2), d)) return Date();
+    }
+    else if (text.length() == 8) {
+        if (!ParseDigits(text.substr(0, 4), y) || !ParseDigits(text.substr(4, 2), m) ||
+            !ParseDigits(text.substr(6, 2), d)) return Date();
+    }
+    else {
+        return Date();
+    }
+    return FromYMD(y, m, d);
+}
+
+
+// ========================================================================================
+// Create a Date from its year, month and day. Returns an empty Date if invalid.
+// ========================================================================================
+Date Date::FromYMD(int year_value, int month_value, int day_value) {
+    year_month_day ymd{year{year_value}, month{(unsigned)month_value}, day{(unsigned)day_value}};
+    if (!ymd.ok()) return Date();
+    return Date((int32_t)sys_days{ymd}.time_since_epoch().count());
+}
+
+
+// ========================================================================================
+// Create a Date from an integer in YYYYMMDD form.
+// ========================================================================================
+Date Date::FromYYYYMMDD(int32_t value) {
+    if (value <= 0) return Date();
+    return FromYMD(value / 10000, (value / 100) % 100, value % 100);
+}
+
+
+// ========================================================================================
+// Return the current local date.
+// ========================================================================================
+Date Date::Today() {
+    std::time_t now_c = system_clock::to_time_t(system_clock::now());
+
+    // Use the reentrant versions because this is called from the parallel database load.
+    std::tm now_tm{};
+#if defined(_WIN32)
+    localtime_s(&now_tm, &now_c);
+#else
+    localtime_r(&now_c, &now_tm);
+#endif
+    return FromYMD(now_tm.tm_year + 1900, now_tm.tm_mon + 1, now_tm.tm_mday);
+}
+
+
+// ========================================================================================
+// Split the date into its year, month and day. All are zero if the date is empty.
+// ========================================================================================
+void Date::ToYMD(int& year_value, int& month_value, int& day_value) const {
+    if (!IsValid()) {
+        year_value = month_value = day_value = 0;
+        return;
+    }
+    year_month_day ymd{sys_days{std::chrono::days{days}}};
+    year_value = (int)ymd.year();
+    month_value = (int)(unsigned)ymd.month();
+    day_value = (int)(unsigned)ymd.day();
+}
+
+
+int Date::Year() const {
+    int y, m, d;
+    ToYMD(y, m, d);
+    return y;
+}
+
+
+int Date::Month() const {
+    int y, m, d;
+    ToYMD(y, m, d);
+    return m;
+}
+
+
+int Date::Day() const {
+    int y, m, d;
+    ToYMD(y, m, d);
+    return d;
+}
+
+
+// ========================================================================================
+// Return the day of the week in the range 0-6 (Sunday through Saturday).
+// ========================================================================================
+int Date::Weekday() const {
+    if (!IsValid()) return 0;
+    return (int)weekday{sys_days{std::chrono::days{days}}}.c_encoding();
+}
+
+
+// ========================================================================================
+// Return the date as an integer in YYYYMMDD form.
+// ========================================================================================
+int32_t Date::ToYYYYMMDD() const {
+    int y, m, d;
+    ToYMD(y, m, d);
+    return y * 10000 + m * 100 + d;
+}
+
+
+// ========================================================================================
+// Return the date as YYYY-MM-DD text.
+// ========================================================================================
+std::string Date::ToString() const {
+    if (!IsValid()) return "";
+    int y, m, d;
+    ToYMD(y, m, d);
+
+    char buffer[11];
+    buffer[0] = (char)('0' + (y / 1000) % 10);
+    buffer[1] = (char)('0' + (y / 100) % 10);
+    buffer[2] = (char)('0' + (y / 10) % 10);
+    buffer[3] = (char)('0' + y % 10);
+    buffer[4] = '-';
+    buffer[5] = (char)('0' + m / 10);
+    buffer[6] = (char)('0' + m % 10);
+    buffer[7] = '-';
+    buffer[8] = (char)('0' + d / 10);
+    buffer[9] = (char)('0' + d % 10);
+    buffer[10] = 0;
+    return std::string(buffer, 10);
+}
+
+
+// ========================================================================================
+// Return the date as YYYYMMDD text.
+// ========================================================================================
+std::string Date::ToCompactString() const {
+    if (!IsValid()) return "";
+    return std::to_string(ToYYYYMMDD());
+}
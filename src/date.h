@@ -0,0 +1,78 @@
+/*
+
+MIT License
+
+Copyright(c) 2023-2025 Paul Squires
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef DATE_H
+#define DATE_H
+
+#include <compare>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+
+// Calendar date stored as the number of days since 1970-01-01. The text formats
+// (YYYY-MM-DD and YYYYMMDD) are only used when reading and writing the database and when
+// displaying or editing a date. A default constructed Date is empty and compares less
+// than every valid date (the same way an empty date string used to).
+class Date {
+public:
+    static constexpr int32_t NONE = INT32_MIN;
+
+    constexpr Date() = default;
+    constexpr explicit Date(int32_t days_since_epoch) : days(days_since_epoch) {}
+
+    static Date FromString(std::string_view text);           // YYYY-MM-DD or YYYYMMDD
+    static Date FromYMD(int year, int month, int day);
+    static Date FromYYYYMMDD(int32_t value);
+    static Date Today();
+
+    constexpr bool IsValid() const { return days != NONE; }
+    constexpr int32_t DaysSinceEpoch() const { return days; }
+
+    void ToYMD(int& year, int& month, int& day) const;
+    int Year() const;
+    int Month() const;
+    int Day() const;
+    int Weekday() const;                                     // 0-6 (Sunday through Saturday)
+    int32_t ToYYYYMMDD() const;                              // 0 if empty
+
+    std::string ToString() const;                            // YYYY-MM-DD or "" if empty
+    std::string ToCompactString() const;                     // YYYYMMDD or "" if empty
+
+    constexpr Date AddDays(int num_days) const { return IsValid() ? Date(days + num_days) : Date(); }
+
+    // Number of days from this date to the later date. Zero if either date is empty.
+    constexpr int DaysUntil(Date later) const {
+        return (IsValid() && later.IsValid()) ? (int)(later.days - days) : 0;
+    }
+
+    constexpr auto operator<=>(const Date&) const = default;
+
+private:
+    int32_t days = NONE;
+};
+
+#endif //DATE_H
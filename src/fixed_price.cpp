@@ -0,0 +1,130 @@
+/*
+
+MIT License
+
+Copyright(c) 2023-2025 Paul Squires
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <cmath>
+#include <cstdlib>
+
+#include "fixed_price.h"
+
+
+// ========================================================================================
+// Create a FixedPrice from text such as "150", "-0.85" or "4125.250000". Text that is not
+// a plain decimal number with at most six decimal places (eg. hand edited database values)
+// is converted through a double and rounded to six decimal places.
+// ========================================================================================
+FixedPrice FixedPrice::FromString(std::string_view text) {
+    FixedPrice price;
+    if (text.empty()) return price;
+
+    size_t i = 0;
+    bool is_negative = false;
+    if (text[0] == '-') {
+        is_negative = true;
+        ++i;
+    }
+
+    int64_t whole = 0;
+    int64_t fraction = 0;
+    int num_whole = 0;
+    int num_decimals = 0;
+    bool has_point = false;
+    bool is_plain = (i < text.length());
+
+    for (; i < text.length() && is_plain; ++i) {
+        char c = text[i];
+        if (c == '.' && !has_point) {
+            has_point = true;
+        }
+        else if (c >= '0' && c <= '9') {
+            if (has_point) {
+                if (++num_decimals > MAX_DECIMALS) is_plain = false;
+                fraction = fraction * 10 + (c - '0');
+            }
+            else {
+                if (++num_whole > 12) is_plain = false;
+                whole = whole * 10 + (c - '0');
+            }
+        }
+        else {
+            is_plain = false;
+        }
+    }
+    if (num_whole + num_decimals == 0) is_plain = false;
+
+    if (is_plain) {
+        for (int n = num_decimals; n < MAX_DECIMALS; ++n) fraction *= 10;
+        price.value = whole * SCALE + fraction;
+        if (is_negative) price.value = -price.value;
+        price.decimals = (int8_t)num_decimals;
+        price.has_point = has_point;
+        price.has_minus = is_negative;
+        price.has_whole = (num_whole > 0);
+    }
+    else {
+        std::string copy(text);
+        price = FromDouble(std::strtod(copy.c_str(), nullptr));
+    }
+    return price;
+}
+
+
+// ========================================================================================
+// Create a FixedPrice from a double (eg. a strike received from IBKR) rounded to six
+// decimal places. Values that are not finite or too large become zero.
+// ========================================================================================
+FixedPrice FixedPrice::FromDouble(double number) {
+    FixedPrice price;
+    if (!std::isfinite(number) || std::fabs(number) > 9e12) number = 0;
+    price.value = std::llround(number * SCALE);
+    price.decimals = MAX_DECIMALS;
+    price.has_point = true;
+    return price;
+}
+
+
+// ========================================================================================
+// Return the text form of the price using the decimal places it was created with.
+// ========================================================================================
+std::string FixedPrice::ToString() const {
+    if (IsEmpty()) return "";
+
+    uint64_t magnitude = (value < 0) ? (uint64_t)(-value) : (uint64_t)value;
+    uint64_t whole = magnitude / SCALE;
+    uint64_t fraction = magnitude % SCALE;
+
+    std::string text;
+    if (value < 0 || has_minus) text += '-';
+    if (whole != 0 || has_whole) text += std::to_string(whole);
+    if (has_point) text += '.';
+
+    // Output the stored number of decimal digits (most significant first)
+    uint64_t divisor = SCALE / 10;
+    for (int n = 0; n < decimals; ++n) {
+        text += (char)('0' + (fraction / divisor) % 10);
+        divisor /= 10;
+    }
+    return text;
+}
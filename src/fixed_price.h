@@ -0,0 +1,69 @@
+/*
+
+MIT License
+
+Copyright(c) 2023-2025 Paul Squires
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef FIXED_PRICE_H
+#define FIXED_PRICE_H
+
+#include <compare>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+
+// Strike or price stored as a signed integer number of millionths. The number of decimal
+// places of the text it was created from is kept so that the database text round trips
+// exactly (eg. "85", "0.85" and "150.500000" are all written back unchanged). Comparisons
+// use the integer value only. A default constructed FixedPrice is empty (text "") and has
+// a value of zero.
+class FixedPrice {
+public:
+    static constexpr int64_t SCALE = 1000000;
+    static constexpr int MAX_DECIMALS = 6;
+
+    constexpr FixedPrice() = default;
+
+    static FixedPrice FromString(std::string_view text);
+    static FixedPrice FromDouble(double number);
+
+    constexpr bool IsEmpty() const { return decimals < 0; }
+    constexpr int64_t Value() const { return value; }           // millionths
+    constexpr double ToDouble() const { return (double)value / SCALE; }
+    std::string ToString() const;
+
+    constexpr bool operator==(const FixedPrice& other) const { return value == other.value; }
+    constexpr auto operator<=>(const FixedPrice& other) const { return value <=> other.value; }
+
+private:
+    int64_t value = 0;
+    // Shape of the text form
+    int8_t decimals = -1;       // digits after the decimal point, -1 if empty
+    bool has_point = false;     // contains a decimal point
+    bool has_minus = false;     // starts with a minus sign (also for "-0.000000")
+    bool has_whole = true;      // has digits before the decimal point (false for ".5")
+    uint8_t padding[4]{};       // written as-is into the database snapshot
+};
+
+#endif //FIXED_PRICE_H
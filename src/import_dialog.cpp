@@ -75,18 +75,19 @@ void ImportTrades_CreateTradeTransactions(AppState& state) {
         if (p.group_id != current_group_id) {
             current_group_id = p.group_id;
 
-            trade = std::make_shared<Trade>();
-            trade->ticker_symbol = p.contract.symbol;
+            trade = model_arena.NewTrade();
+            trade->SetTickerSymbol(p.contract.symbol);
             trade->ticker_name = trade->ticker_symbol;
             trade->future_expiry = "";
             state.db.trades.push_back(trade);
+            state.db.SetTradeModified(trade);
         }
 
         int intQuantity = (int)intelDecimalToDouble(p.position);
 
         if (trade) {
-            trans = std::make_shared<Transaction>();
-            trans->trans_date = AfxCurrentDate();
+            trans = model_arena.NewTransaction();
+            trans->trans_date = Date::Today();
             if (p.contract.secType == "OPT" ||
                 p.contract.secType == "FOP") {
                 trans->description = "Options";
@@ -108,15 +109,15 @@ void ImportTrades_CreateTradeTransactions(AppState& state) {
             trade->transactions.push_back(trans);
 
             // Add the new transaction legs
-            leg = std::make_shared<Leg>();
+            leg = model_arena.NewLeg();
 
             trade->nextleg_id += 1;
             leg->leg_id = trade->nextleg_id;
             leg->underlying = trans->underlying;
-            leg->expiry_date = p.contract.lastTradeDateOrContractMonth;
+            leg->expiry_date = Date::FromString(p.contract.lastTradeDateOrContractMonth);
 
             if (p.contract.secType == "FOP") {
-                trade->future_expiry = leg->expiry_date;
+                trade->future_expiry = p.contract.lastTradeDateOrContractMonth;
             }
 
             std::string str = std::to_string(p.contract.strike);
@@ -126,10 +127,9 @@ void ImportTrades_CreateTradeTransactions(AppState& state) {
             if (str.find('.') == str.size() - 1) {
                 str = str.substr(0, str.size() - 1);
             }
-            leg->strike_price = str;
+            leg->strike_price = FixedPrice::FromString(str);
 
             leg->put_call = state.db.StringToPutCall(p.contract.right);
-            leg->trans = trans;
             leg->original_quantity = intQuantity;
             leg->open_quantity = intQuantity;
             leg->action = (intQuantity < 0) ? Action::STO : Action::BTO;
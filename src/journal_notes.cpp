@@ -102,14 +102,17 @@ void LoadJournalNotes(AppState& state) {
     folder.description = "Notes";
     state.vector_folders.push_back(folder);
 
-    std::string line;
-    std::ifstream file(state.db.dbJournalNotes);
+    // Read the whole file into one buffer and walk its lines as string_views.
+    std::string buffer;
+    if (AfxFileExists(state.db.dbJournalNotes)) buffer = AfxLoadFileIntoString(state.db.dbJournalNotes);
+    std::string_view text(buffer);
+    std::string_view line;
 
-    while (std::getline(file, line)) {
-        if (line.substr(0, FOLDERS_BEGIN.length()) == FOLDERS_BEGIN) {reading_folders = true; continue;}
-        if (line.substr(0, FOLDERS_END.length()) == FOLDERS_END) {reading_folders = false; continue;}
+    while (AfxNextLine(text, line)) {
+        if (line.starts_with(FOLDERS_BEGIN)) {reading_folders = true; continue;}
+        if (line.starts_with(FOLDERS_END)) {reading_folders = false; continue;}
 
-        if (line.substr(0, NOTE_BEGIN.length()) == NOTE_BEGIN) {
+        if (line.starts_with(NOTE_BEGIN)) {
             reading_note = true;
             note_text = "";
             note_folder = ""; 
@@ -117,7 +120,7 @@ void LoadJournalNotes(AppState& state) {
             continue;
         }
 
-        if (line.substr(0, NOTE_END.length()) == NOTE_END) {
+        if (line.starts_with(NOTE_END)) {
             JournalNote note;
             note.id = state.journal_notes_next_id++; 
             note.folder = note_folder;
@@ -149,17 +152,17 @@ void LoadJournalNotes(AppState& state) {
         }
 
         if (reading_note) {
-            if (line.substr(0, NOTE_FOLDER.length()) == NOTE_FOLDER) {
+            if (line.starts_with(NOTE_FOLDER)) {
                 note_folder = line.substr(NOTE_FOLDER.length());
-            } else if (line.substr(0, NOTE_TRASH.length()) == NOTE_TRASH) {
+            } else if (line.starts_with(NOTE_TRASH)) {
                 note_trash = true;
             } else {
-                note_text += (line + "\n");
+                note_text.append(line);
+                note_text += "\n";
             }
             continue;
         }
     }
-    file.close();
 
     UpdateFolderNotesCount(state);
 
@@ -0,0 +1,143 @@
+/*
+
+MIT License
+
+Copyright(c) 2023-2025 Paul Squires
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include "journal_writer.h"
+
+
+// ========================================================================================
+// Queue a batch of journal text. The writer thread is started by the first batch.
+// ========================================================================================
+void CJournalWriter::Append(const std::string& filename, std::string text) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        batches.push_back({ filename, std::move(text) });
+        if (!writer_thread.joinable()) {
+            writer_thread = std::thread(&CJournalWriter::WriterFunction, this);
+        }
+    }
+    cv_work.notify_one();
+}
+
+
+// ========================================================================================
+// Wait for the queued batches to be written and report any write failure.
+// ========================================================================================
+bool CJournalWriter::Flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv_idle.wait(lock, [this] { return batches.empty() && !is_writing; });
+    return !is_failed;
+}
+
+
+// ========================================================================================
+// Forget a write failure. Only called once every change is in the main database.
+// ========================================================================================
+void CJournalWriter::ClearFailure() {
+    std::lock_guard<std::mutex> lock(mutex);
+    is_failed = false;
+}
+
+
+// ========================================================================================
+// Determine if a batch could not be written. Does not wait for the queued batches.
+// ========================================================================================
+bool CJournalWriter::HasFailed() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return is_failed;
+}
+
+
+// ========================================================================================
+// Write the remaining batches and stop the writer thread.
+// ========================================================================================
+CJournalWriter::~CJournalWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop_requested = true;
+    }
+    cv_work.notify_all();
+
+    if (writer_thread.joinable()) writer_thread.join();
+}
+
+
+// ========================================================================================
+// Background thread that appends the queued batches to their files.
+// ========================================================================================
+void CJournalWriter::WriterFunction() {
+    while (true) {
+        Batch batch;
+        bool is_skipped = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv_work.wait(lock, [this] { return !batches.empty() || stop_requested; });
+            if (batches.empty()) return;
+
+            batch = std::move(batches.front());
+            batches.pop_front();
+            is_writing = true;
+
+            // After a failure the journal is missing a batch. The database will be rewritten
+            // in full so the later batches are not written either.
+            is_skipped = is_failed;
+        }
+
+        bool is_ok = true;
+        if (!is_skipped) {
+            std::error_code ec;
+            uintmax_t previous_size = std::filesystem::file_size(batch.filename, ec);
+            if (ec) previous_size = 0;
+
+            // Binary so that the line endings (and the byte count in the commit marker) are
+            // the same on every platform.
+            std::ofstream journal(batch.filename, std::ios::app | std::ios::binary);
+            if (journal.is_open()) {
+                journal << batch.text;
+                journal.flush();
+            }
+
+            is_ok = journal.is_open() && journal.good();
+            if (!is_ok) {
+                std::cout << "Error occurred while writing to file " + batch.filename << std::endl;
+
+                // Remove any part of the batch that was written.
+                journal.close();
+                std::filesystem::resize_file(batch.filename, previous_size, ec);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!is_ok) is_failed = true;
+            is_writing = false;
+        }
+        cv_idle.notify_all();
+    }
+}
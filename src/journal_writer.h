@@ -0,0 +1,76 @@
+/*
+
+MIT License
+
+Copyright(c) 2023-2025 Paul Squires
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef JOURNAL_WRITER_H
+#define JOURNAL_WRITER_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+
+// Appends text to the journal file on a background thread so that an edit does not wait
+// for the disk. Batches are written in the order they were queued. Anything that reads or
+// replaces the journal must call Flush() first.
+class CJournalWriter {
+public:
+    void Append(const std::string& filename, std::string text);
+
+    // Wait until every queued batch has been written. Returns false if a write has failed.
+    // The failure is kept (and later batches are not written) until ClearFailure() is called
+    // after the full database has been rewritten, because the journal no longer holds
+    // every change.
+    bool Flush();
+    bool HasFailed();
+    void ClearFailure();
+
+    CJournalWriter() = default;
+    ~CJournalWriter();
+
+    CJournalWriter(const CJournalWriter&) = delete;
+    CJournalWriter& operator=(const CJournalWriter&) = delete;
+
+private:
+    struct Batch {
+        std::string filename;
+        std::string text;
+    };
+
+    void WriterFunction();
+
+    std::mutex mutex;
+    std::condition_variable cv_work;
+    std::condition_variable cv_idle;
+    std::deque<Batch> batches;
+    std::thread writer_thread;
+    bool is_writing = false;
+    bool is_failed = false;
+    bool stop_requested = false;
+};
+
+#endif //JOURNAL_WRITER_H
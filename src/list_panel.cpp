@@ -36,11 +36,12 @@ SOFTWARE.
 // #include <iostream>
 
 
-void SetSelectedGridRow(AppState& state, CListPanel& lp, CListPanelData& ld) {
-    // Save the selected row for ActiveTrades table in order to easily position it again after a database reload
-    if (lp.table_id == TableType::active_trades) state.activetrades_current_row_index = ImGui::TableGetRowIndex();
-    if (lp.table_id == TableType::closed_trades) state.closedtrades_current_row_index = ImGui::TableGetRowIndex();
-    if (lp.table_id == TableType::trans_panel)   state.transactions_current_row_index = ImGui::TableGetRowIndex();
+void SetSelectedGridRow(AppState& state, CListPanel& lp, CListPanelData& ld, int row) {
+    // Save the selected row for ActiveTrades table in order to easily position it again after a database reload.
+    // The row is the index into lp.vec because the clipper does not submit the rows that are not visible.
+    if (lp.table_id == TableType::active_trades) state.activetrades_current_row_index = row;
+    if (lp.table_id == TableType::closed_trades) state.closedtrades_current_row_index = row;
+    if (lp.table_id == TableType::trans_panel)   state.transactions_current_row_index = row;
 
     // If CTRL (or SHIFT) is held then:
     // - Select the line -OR- toggle deselect an already selected line.
@@ -67,7 +68,7 @@ void SetSelectedGridRow(AppState& state, CListPanel& lp, CListPanelData& ld) {
 }
 
 
-void DrawTableRow(AppState& state, CListPanel& lp, CListPanelData& ld) {
+void DrawTableRow(AppState& state, CListPanel& lp, CListPanelData& ld, int row) {
     ImGui::TableNextRow(0, state.dpi(lp.row_height));
 
     // Draw the columns cells
@@ -134,7 +135,7 @@ void DrawTableRow(AppState& state, CListPanel& lp, CListPanelData& ld) {
 
 
     if (ImGui::IsItemClicked(ImGuiMouseButton_Left)) {
-        SetSelectedGridRow(state, lp, ld);
+        SetSelectedGridRow(state, lp, ld, row);
 
         if (lp.table_id == TableType::active_trades) {
             state.activetrades_selected_trade = ld.trade;
@@ -259,6 +260,21 @@ void SetupTableColumns(AppState& state, CListPanel& lp) {
 }
 
 
+void ScrollToSelectedGridRow(CListPanel& lp) {
+    // Bring the first selected row into view the next time the ListPanel is drawn.
+    lp.scroll_to_row = -1;
+    if (!lp.vec) return;
+
+    int num_rows = (int)lp.vec->size();
+    for (int row = 0; row < num_rows; ++row) {
+        if (lp.vec->at(row).is_selected) {
+            lp.scroll_to_row = row;
+            break;
+        }
+    }
+}
+
+
 void DrawListPanel(AppState& state, CListPanel& lp) {
     std::string table_id = std::to_string((int)lp.table_id);
     ImGui::PushStyleColor(ImGuiCol_ChildBg, clrBackDarkGray(state));
@@ -268,18 +284,32 @@ void DrawListPanel(AppState& state, CListPanel& lp) {
     if (ImGui::BeginTable("##TableWithFullRowSelection", lp.column_count, lp.table_flags)) {
         SetupTableColumns(state, lp);
 
-        // Fill table rows
-        int id_gridline = 0;
+        // Fill table rows. Every row has the same height so the clipper only needs
+        // to submit the rows that are visible in the panel.
+        int num_rows = (int)lp.vec->size();
+        if (lp.scroll_to_row >= num_rows) lp.scroll_to_row = -1;
 
-        for (auto& ld : *lp.vec) {
-            ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(state.dpi(6), state.dpi(6)));
-            ImGui::PushID(id_gridline);
-            DrawTableRow(state, lp, ld);
-            ImGui::PopID();
-            ImGui::PopStyleVar();
-            id_gridline++;
+        ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(state.dpi(6), state.dpi(6)));
+
+        ImGuiListClipper clipper;
+        clipper.Begin(num_rows);
+        if (lp.scroll_to_row != -1) clipper.IncludeItemByIndex(lp.scroll_to_row);
+
+        while (clipper.Step()) {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
+                ImGui::PushID(row);
+                DrawTableRow(state, lp, lp.vec->at(row), row);
+                ImGui::PopID();
+
+                if (row == lp.scroll_to_row) {
+                    if (!ImGui::IsItemVisible()) ImGui::SetScrollHereY(0.5f);
+                    lp.scroll_to_row = -1;
+                }
+            }
         }
 
+        ImGui::PopStyleVar();
+
         ImGui::EndTable();
     }
 
@@ -48,9 +48,11 @@ public:
     int* min_col_widths = nullptr;
     float panel_width = 0;
     float panel_height = 0;
+    int scroll_to_row = -1;     // row to bring into view on the next draw (eg. selection after a reload)
 };
 
 void DrawListPanel(AppState& state, CListPanel& lp);
+void ScrollToSelectedGridRow(CListPanel& lp);
 
 #endif  //LISTPANEL_H
 
@@ -78,8 +78,8 @@ void ListPanelData_TradeROI(AppState& state, std::vector<CListPanelData>& vec, c
     int font9 = 9;
     std::string text;
 
-    std::string start_date = AfxInsertDateHyphens(trade->bp_start_date);
-    std::string end_date = AfxInsertDateHyphens(trade->bp_end_date);
+    Date start_date = trade->bp_start_date;
+    Date end_date = trade->bp_end_date;
 
     // Buying Power
     text = AfxMoney(trade->trade_bp, 0, state);
@@ -90,7 +90,7 @@ void ListPanelData_TradeROI(AppState& state, std::vector<CListPanelData>& vec, c
         clrTextDarkWhite(state), font9, false);
     
     // Days In Trade
-    int days_in_trade = AfxDaysBetween(start_date, (trade->is_open ? AfxCurrentDate() : end_date));
+    int days_in_trade = start_date.DaysUntil(trade->is_open ? Date::Today() : end_date);
     text = AfxMoney(days_in_trade, 0, state);
     ld.SetData(4, trade, ticker_id, text, StringAlignment::right, clrBackDarkGray(state),
         clrTextLightWhite(state), font9, false);
@@ -101,7 +101,7 @@ void ListPanelData_TradeROI(AppState& state, std::vector<CListPanelData>& vec, c
     vec.push_back(ld);
 
     // Totals Days for Trade
-    int days_total = AfxDaysBetween(start_date, end_date);
+    int days_total = start_date.DaysUntil(end_date);
     text = AfxMoney(days_total, 0, state);
     ld.SetData(2, trade, ticker_id, text, StringAlignment::right, clrBackDarkGray(state),
         clrTextLightWhite(state), font9, false);
@@ -163,7 +163,12 @@ void ListPanelData_OpenPosition(
     }
     else {
         ld.line_type = LineType::ticker_line;
-        ticker_id = (trade->ticker_id == -1) ? ++state.ticker_id : trade->ticker_id;
+        ticker_id = trade->ticker_id;
+        if (ticker_id == -1) {
+            ticker_id = ++state.ticker_id;
+            trade->market_data_symbol_id = trade->symbol_id;
+            trade->market_data_future_expiry = trade->future_expiry;
+        }
         
         ld.SetData(0, trade, ticker_id, GLYPH_CIRCLE, StringAlignment::center, clrBackDarkGray(state),
             clrTextDarkWhite(state), font9, false);
@@ -323,14 +328,18 @@ void ListPanelData_OpenPosition(
     for (auto& leg : trade->open_legs) {
         if (leg->underlying == Underlying::Options) {
             CListPanelData ld;
-            ticker_id = (leg->ticker_id == -1) ? ++state.ticker_id : leg->ticker_id;
+            ticker_id = leg->ticker_id;
+            if (ticker_id == -1) {
+                ticker_id = ++state.ticker_id;
+                leg->market_data_contract = leg->GetMarketDataContract();
+            }
 
             ld.leg = leg;
             ld.line_type = LineType::options_leg;
             if (is_history) ld.line_type = LineType::nonselectable;
 
-            std::string current_date = AfxCurrentDate();
-            std::string expiry_date = leg->expiry_date;
+            Date current_date = Date::Today();
+            Date expiry_date = leg->expiry_date;
             std::string short_date = AfxShortDate(expiry_date);
             std::string dte_text;
 
@@ -338,7 +347,7 @@ void ListPanelData_OpenPosition(
             // Check the Trade option set to show warnings based on the DTE.
             // 3 DTE and/or 21 DTE
 
-            int dte = AfxDaysBetween(current_date, expiry_date);
+            int dte = current_date.DaysUntil(expiry_date);
             dte_text = std::to_string(dte) + "d";
 
             dte_color = clrMagenta(state);
@@ -351,9 +360,9 @@ void ListPanelData_OpenPosition(
 
             // If the expiry year is greater than current year + 1 then add
             // the year to the display string. Useful for LEAP options.
-            if (AfxGetYear(expiry_date) > AfxGetYear(current_date) + 1) {
+            if (expiry_date.Year() > current_date.Year() + 1) {
                 short_date.append("/");
-                short_date.append(std::to_string(AfxGetYear(expiry_date)));
+                short_date.append(std::to_string(expiry_date.Year()));
             }
 
             int col = 1;
@@ -380,7 +389,7 @@ void ListPanelData_OpenPosition(
                 clrTextDarkWhite(state), font9, false);   // DTE
             col++;
 
-            ld.SetData(col, trade, ticker_id, leg->strike_price, StringAlignment::center, 
+            ld.SetData(col, trade, ticker_id, leg->strike_price.ToString(), StringAlignment::center, 
                 clrBackLightGray(state), clrTextLightWhite(state), font9, false);   // strike price
             col++;
 
@@ -461,7 +470,7 @@ void ListPanelData_HistoryHeader(AppState& state, std::vector<CListPanelData>& v
     ld.SetData(1, trade, ticker_id, text, StringAlignment::left, clrBackDarkGray(state),
         clrOrange(state), font9, false);   // orange
 
-    text = trans->trans_date;
+    text = trans->trans_date.ToString();
     ld.SetData(2, trade, ticker_id, text, StringAlignment::left, clrBackDarkGray(state),
         clrTextLightWhite(state), font9, false);
 
@@ -473,7 +482,7 @@ void ListPanelData_HistoryHeader(AppState& state, std::vector<CListPanelData>& v
 
             double multiplier = 1;
             if (trans->underlying == Underlying::Futures) {
-                multiplier = AfxValDouble(state.config.GetMultiplier(trade->ticker_symbol));
+                multiplier = state.config.GetInstrument(*trade).multiplier;
             }
 
             double quantity = trans->quantity;
@@ -559,7 +568,7 @@ void ListPanelData_HistorySharesLeg(AppState& state, std::vector<CListPanelData>
         double multiplier = 1;
         double average_cost = trans->share_average_cost;
         if (leg->underlying == Underlying::Futures) {
-            multiplier = AfxValDouble(state.config.GetMultiplier(trade->ticker_symbol));
+            multiplier = state.config.GetInstrument(*trade).multiplier;
             average_cost /= multiplier;
         }
 
@@ -688,15 +697,15 @@ void ListPanelData_HistoryOptionsLeg(AppState& state, std::vector<CListPanelData
     ld.SetData(2, trade, ticker_id, text, StringAlignment::right, 
             clrBackMediumGray(state), clrTextLightWhite(state), font9, false);
 
-    int dte = AfxDaysBetween(trans->trans_date, leg->expiry_date);
+    int dte = trans->trans_date.DaysUntil(leg->expiry_date);
     std::string days = std::to_string(dte) + "d";
     std::string short_date = AfxShortDate(leg->expiry_date);
 
     // If the expiry year is greater than current year + 1 then add
     // the year to the display string. Useful for LEAP options.
-    if (AfxGetYear(leg->expiry_date) > AfxGetYear(trans->trans_date) + 1) {
+    if (leg->expiry_date.Year() > trans->trans_date.Year() + 1) {
         short_date.append("/");
-        short_date.append(std::to_string(AfxGetYear(leg->expiry_date)));
+        short_date.append(std::to_string(leg->expiry_date.Year()));
     }
 
     ld.SetData(3, trade, ticker_id, short_date, StringAlignment::center, 
@@ -705,7 +714,7 @@ void ListPanelData_HistoryOptionsLeg(AppState& state, std::vector<CListPanelData
     ld.SetData(4, trade, ticker_id, days, StringAlignment::center,
         clrBackMediumGray(state), clrTextDarkWhite(state), font9, false);
 
-    ld.SetData(5, trade, ticker_id, leg->strike_price, StringAlignment::center,
+    ld.SetData(5, trade, ticker_id, leg->strike_price.ToString(), StringAlignment::center,
         clrBackLightGray(state), clrTextLightWhite(state), font9, false);
 
     ld.SetData(6, trade, ticker_id, state.db.PutCallToString(leg->put_call), StringAlignment::left,
@@ -851,7 +860,7 @@ void ListPanelData_OutputClosedDayTotal(AppState& state, std::vector<CListPanelD
 // Create the display data line for a closed position month subtotal.
 // ========================================================================================
 void ListPanelData_OutputClosedMonthSubtotal(
-    AppState& state, std::vector<CListPanelData>& vec, const std::string& closed_date, double subtotal, int month_win, int month_loss)
+    AppState& state, std::vector<CListPanelData>& vec, Date closed_date, double subtotal, int month_win, int month_loss)
 {
     CListPanelData ld;
     ld.line_type = LineType::nonselectable;
@@ -861,7 +870,7 @@ void ListPanelData_OutputClosedMonthSubtotal(
 
     ImU32 clr = (subtotal >= 0) ? clrGreen(state) : clrRed(state);
     
-    std::string text = AfxUpper(AfxGetLongMonthName(closed_date)) + " " + std::to_string(AfxGetYear(closed_date));
+    std::string text = AfxUpper(AfxGetLongMonthName(closed_date)) + " " + std::to_string(closed_date.Year());
     ld.SetData(3, nullptr, ticker_id, text, StringAlignment::right, 
         clrBackDarkGray(state), clr, font9, false);
 
@@ -885,7 +894,7 @@ void ListPanelData_OutputClosedMonthSubtotal(
 // Create the display data line for a closed position.
 // ========================================================================================
 void ListPanelData_OutputClosedPosition(AppState& state, std::vector<CListPanelData>& vec, const std::shared_ptr<Trade>& trade, 
-    const std::string& closed_date, const std::string& ticker_symbol, const std::string& description, double closed_amount) {
+    Date closed_date, const std::string& ticker_symbol, const std::string& description, double closed_amount) {
 
     CListPanelData ld;
     ld.line_type = LineType::ticker_line;
@@ -896,7 +905,7 @@ void ListPanelData_OutputClosedPosition(AppState& state, std::vector<CListPanelD
     ld.SetData(0, trade, ticker_id, "", StringAlignment::left, 
         clrBackDarkGray(state), clrOrange(state), font9, false);
 
-    ld.SetData(1, trade, ticker_id, closed_date, StringAlignment::left, 
+    ld.SetData(1, trade, ticker_id, closed_date.ToString(), StringAlignment::left, 
         clrBackDarkGray(state), clrOrange(state), font9, false);
 
     ld.SetData(2, trade, ticker_id, ticker_symbol, StringAlignment::left, 
@@ -970,7 +979,7 @@ void ListPanelData_OutputTransaction(
     ld.SetData(0, trade, ticker_id, "", StringAlignment::left, 
         clrBackDarkGray(state), clrOrange(state), font9, false);
 
-    ld.SetData(1, trade, ticker_id, trans->trans_date, StringAlignment::left, 
+    ld.SetData(1, trade, ticker_id, trans->trans_date.ToString(), StringAlignment::left, 
         clrBackDarkGray(state), clrTextLightWhite(state), font9, false);
 
     ld.SetData(2, trade, ticker_id, trade->ticker_symbol, StringAlignment::left,
@@ -982,7 +991,7 @@ void ListPanelData_OutputTransaction(
     ld.SetData(4, trade, ticker_id, AfxMoney(trans->quantity, 2, state), StringAlignment::right,
         clrBackDarkGray(state), clrTextLightWhite(state), font9, false);
 
-    ld.SetData(5, trade, ticker_id, AfxMoney(trans->price, state.config.GetTickerDecimals(trade->ticker_symbol), state), 
+    ld.SetData(5, trade, ticker_id, AfxMoney(trans->price, state.config.GetInstrument(*trade).ticker_decimals, state), 
         StringAlignment::right, clrBackDarkGray(state), clrTextLightWhite(state), font9, false);
 
     ld.SetData(6, trade, ticker_id, AfxMoney(trans->fees, 2, state), StringAlignment::right, 
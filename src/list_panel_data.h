@@ -262,9 +262,9 @@ void ListPanelData_OutputClosedMonthTotal(AppState& state, std::vector<CListPane
 void ListPanelData_OutputClosedWeekTotal(AppState& state, std::vector<CListPanelData>& vec, double weekly_total, int week_win, int week_loss);
 void ListPanelData_OutputClosedDayTotal(AppState& state, std::vector<CListPanelData>& vec, double daily_total, int day_win, int day_loss);
 void ListPanelData_OutputClosedMonthSubtotal(
-    AppState& state, std::vector<CListPanelData>& vec, const std::string& closed_date, double subtotal, int month_win, int month_loss);
+    AppState& state, std::vector<CListPanelData>& vec, Date closed_date, double subtotal, int month_win, int month_loss);
 void ListPanelData_OutputClosedPosition(AppState& state, std::vector<CListPanelData>& vec, const std::shared_ptr<Trade>& trade, 
-    const std::string& closed_date, const std::string& ticker_symbol, const std::string& description, double closed_amount);
+    Date closed_date, const std::string& ticker_symbol, const std::string& description, double closed_amount);
 void ListPanelData_OutputTransactionRunningTotal(AppState& state, std::vector<CListPanelData>& vec, 
     double running_gross_total, double running_fees_total, double running_net_total);
 void ListPanelData_OutputTransaction(AppState& state, std::vector<CListPanelData>& vec, const std::shared_ptr<Trade>& trade, const std::shared_ptr<Transaction>& trans);
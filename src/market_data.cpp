@@ -0,0 +1,193 @@
+/*
+
+MIT License
+
+Copyright(c) 2023-2025 Paul Squires
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "market_data.h"
+
+
+CTickerDataStore ticker_data_store;
+CPortfolioDataStore portfolio_data_store;
+
+
+// ========================================================================================
+// Determine if the TickerId fits in the store. Market data is not requested otherwise.
+// ========================================================================================
+bool CTickerDataStore::IsValidTickerId(TickerId ticker_id) const {
+    return (GetSlot(ticker_id) != nullptr);
+}
+
+
+// ========================================================================================
+// Determine if any price data has been received for the TickerId.
+// ========================================================================================
+bool CTickerDataStore::HasData(TickerId ticker_id) const {
+    Slot* slot = GetSlot(ticker_id);
+    if (!slot) return false;
+    return slot->has_data.load(std::memory_order_acquire);
+}
+
+
+// ========================================================================================
+// Return a consistent copy of the price data for the TickerId (zeros if none received).
+// ========================================================================================
+TickerData CTickerDataStore::Get(TickerId ticker_id) const {
+    Slot* slot = GetSlot(ticker_id);
+    if (!slot) return TickerData{};
+    return slot->data.Load();
+}
+
+
+// ========================================================================================
+// Tick price updates. Called from the TWS message thread.
+// ========================================================================================
+void CTickerDataStore::SetLastPrice(TickerId ticker_id, double price) {
+    Slot* slot = GetSlot(ticker_id);
+    if (!slot) return;
+    slot->data.Update([&](TickerData& td) { td.last_price = price; });
+    slot->has_data.store(true, std::memory_order_release);
+    dirty.Mark(ticker_id);
+}
+
+void CTickerDataStore::SetOpenPrice(TickerId ticker_id, double price) {
+    Slot* slot = GetSlot(ticker_id);
+    if (!slot) return;
+    slot->data.Update([&](TickerData& td) {
+        td.open_price = price;
+        if (td.close_price == 0) td.close_price = price;
+    });
+    slot->has_data.store(true, std::memory_order_release);
+    dirty.Mark(ticker_id);
+}
+
+void CTickerDataStore::SetClosePrice(TickerId ticker_id, double price) {
+    Slot* slot = GetSlot(ticker_id);
+    if (!slot) return;
+    slot->data.Update([&](TickerData& td) { td.close_price = price; });
+    slot->has_data.store(true, std::memory_order_release);
+    dirty.Mark(ticker_id);
+}
+
+
+// ========================================================================================
+// Option delta update. Only applied once price data exists for the TickerId.
+// ========================================================================================
+void CTickerDataStore::UpdateDelta(TickerId ticker_id, double delta) {
+    Slot* slot = GetSlot(ticker_id);
+    if (!slot) return;
+    if (!slot->has_data.load(std::memory_order_acquire)) return;
+    slot->data.Update([&](TickerData& td) { td.delta = delta; });
+    dirty.Mark(ticker_id);
+}
+
+
+// ========================================================================================
+// Reset all price data. Called when the database is reloaded and ticker ids restart.
+// ========================================================================================
+void CTickerDataStore::Clear() {
+    for (TickerId i = 0; i < MAX_TICKER_DATA_SLOTS; ++i) {
+        if (!slots[i].has_data.load(std::memory_order_acquire)) continue;
+        slots[i].has_data.store(false, std::memory_order_release);
+        slots[i].data.Store(TickerData{});
+    }
+    std::vector<size_t> discard;
+    dirty.Take(discard);
+}
+
+
+// ========================================================================================
+// Retrieve (and reset) the TickerIds that have received new data.
+// ========================================================================================
+void CTickerDataStore::TakeDirty(std::vector<TickerId>& ticker_ids) {
+    std::vector<size_t> indexes;
+    dirty.Take(indexes);
+    for (const auto& index : indexes) ticker_ids.push_back(static_cast<TickerId>(index));
+}
+
+
+// ========================================================================================
+// Locate the slot for the contract id, optionally claiming an empty slot for it.
+// ========================================================================================
+CPortfolioDataStore::Slot* CPortfolioDataStore::FindSlot(int contract_id, bool insert) const {
+    if (contract_id == 0) return nullptr;
+
+    const uint32_t mask = MAX_PORTFOLIO_DATA_SLOTS - 1;
+    uint32_t index = (static_cast<uint32_t>(contract_id) * 2654435761u) & mask;
+
+    for (int probe = 0; probe < MAX_PORTFOLIO_DATA_SLOTS; ++probe) {
+        Slot& slot = slots[index];
+        int id = slot.contract_id.load(std::memory_order_acquire);
+
+        if (id == contract_id) return &slot;
+
+        if (id == 0) {
+            if (!insert) return nullptr;
+            int expected = 0;
+            if (slot.contract_id.compare_exchange_strong(expected, contract_id, std::memory_order_acq_rel)) {
+                return &slot;
+            }
+            if (expected == contract_id) return &slot;
+        }
+
+        index = (index + 1) & mask;
+    }
+
+    return nullptr;   // store is full
+}
+
+
+// ========================================================================================
+// Copy the portfolio data for the contract id. Returns false if none has been received.
+// ========================================================================================
+bool CPortfolioDataStore::Get(int contract_id, PortfolioData& pd) const {
+    Slot* slot = FindSlot(contract_id, false);
+    if (!slot) return false;
+    if (!slot->has_data.load(std::memory_order_acquire)) return false;
+    pd = slot->data.Load();
+    return true;
+}
+
+
+// ========================================================================================
+// Save the portfolio data for the contract id. Called from the TWS message thread.
+// ========================================================================================
+void CPortfolioDataStore::Set(int contract_id, const PortfolioData& pd) {
+    Slot* slot = FindSlot(contract_id, true);
+    if (!slot) return;
+    slot->data.Store(pd);
+    slot->has_data.store(true, std::memory_order_release);
+    dirty.Mark(slot - slots.get());
+}
+
+
+// ========================================================================================
+// Retrieve (and reset) the contract ids that have received new portfolio data.
+// ========================================================================================
+void CPortfolioDataStore::TakeDirty(std::vector<int>& contract_ids) {
+    std::vector<size_t> indexes;
+    dirty.Take(indexes);
+    for (const auto& index : indexes) {
+        contract_ids.push_back(slots[index].contract_id.load(std::memory_order_acquire));
+    }
+}
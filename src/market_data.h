@@ -0,0 +1,233 @@
+/*
+
+MIT License
+
+Copyright(c) 2023-2025 Paul Squires
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef MARKET_DATA_H
+#define MARKET_DATA_H
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "appstate.h"
+
+
+// Maximum number of ticker ids (market data requests) that can hold price data. The
+// ticker id counter is reset every time the database is reloaded.
+constexpr TickerId MAX_TICKER_DATA_SLOTS = 8192;
+
+// Number of distinct IBKR contract ids that can hold portfolio data. Must be a power of 2.
+constexpr int MAX_PORTFOLIO_DATA_SLOTS = 4096;
+
+
+// ========================================================================================
+// A single value protected by a sequence lock. Writers never wait on readers and a reader
+// retries until it has copied a value that was not modified while it was being read. The
+// value is held in atomic words so that concurrent copies are not data races.
+// ========================================================================================
+template <typename T>
+class CSeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "CSeqLock value must be trivially copyable");
+
+    static constexpr size_t NUM_WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint32_t> sequence{0};
+    std::atomic<uint64_t> words[NUM_WORDS]{};
+
+    uint32_t BeginWrite() {
+        // Writers are normally only the TWS message thread, but the UI thread can also
+        // clear values so an odd sequence is claimed before any words are modified.
+        uint32_t seq = sequence.load(std::memory_order_relaxed);
+        while ((seq & 1) || !sequence.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            seq = sequence.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        return seq;
+    }
+
+    void ReadWords(uint64_t* buffer) const {
+        for (size_t i = 0; i < NUM_WORDS; ++i) buffer[i] = words[i].load(std::memory_order_relaxed);
+    }
+
+    void WriteWords(const uint64_t* buffer) {
+        for (size_t i = 0; i < NUM_WORDS; ++i) words[i].store(buffer[i], std::memory_order_relaxed);
+    }
+
+public:
+    T Load() const {
+        uint64_t buffer[NUM_WORDS];
+        uint32_t seq1 = 0;
+        uint32_t seq2 = 0;
+        do {
+            seq1 = sequence.load(std::memory_order_acquire);
+            ReadWords(buffer);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            seq2 = sequence.load(std::memory_order_relaxed);
+        } while ((seq1 & 1) || seq1 != seq2);
+
+        T value;
+        std::memcpy(&value, buffer, sizeof(T));
+        return value;
+    }
+
+    void Store(const T& value) {
+        uint64_t buffer[NUM_WORDS]{};
+        std::memcpy(buffer, &value, sizeof(T));
+        uint32_t seq = BeginWrite();
+        WriteWords(buffer);
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    // Read-modify-write the value as one update. func receives a T& to modify.
+    template <typename Func>
+    void Update(Func&& func) {
+        uint64_t buffer[NUM_WORDS]{};
+        uint32_t seq = BeginWrite();
+        ReadWords(buffer);
+        T value;
+        std::memcpy(&value, buffer, sizeof(T));
+        func(value);
+        std::memcpy(buffer, &value, sizeof(T));
+        WriteWords(buffer);
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+};
+
+
+// ========================================================================================
+// Fixed size set of indexes that have changed. Marking is a single atomic OR so the TWS
+// message thread never blocks. The consumer atomically takes (and clears) every marked
+// index at once.
+// ========================================================================================
+class CDirtySet {
+    size_t num_words = 0;
+    std::unique_ptr<std::atomic<uint64_t>[]> words;
+    std::atomic<bool> is_pending{false};
+
+public:
+    explicit CDirtySet(size_t capacity)
+        : num_words((capacity + 63) / 64), words(new std::atomic<uint64_t>[(capacity + 63) / 64]()) {}
+
+    void Mark(size_t index) {
+        words[index / 64].fetch_or(uint64_t{1} << (index % 64), std::memory_order_release);
+        is_pending.store(true, std::memory_order_release);
+    }
+
+    bool IsPending() const {
+        return is_pending.load(std::memory_order_acquire);
+    }
+
+    // Append every marked index to the vector and clear them. Returns the number taken.
+    size_t Take(std::vector<size_t>& indexes) {
+        if (!is_pending.exchange(false, std::memory_order_acq_rel)) return 0;
+        size_t count = 0;
+        for (size_t w = 0; w < num_words; ++w) {
+            uint64_t bits = words[w].exchange(0, std::memory_order_acq_rel);
+            while (bits) {
+                int bit = std::countr_zero(bits);
+                indexes.push_back(w * 64 + bit);
+                bits &= bits - 1;
+                count++;
+            }
+        }
+        return count;
+    }
+};
+
+
+// ========================================================================================
+// Last/open/close prices and option delta for every market data request, indexed
+// directly by the TickerId that was used for the request.
+// ========================================================================================
+class CTickerDataStore {
+    struct Slot {
+        CSeqLock<TickerData> data;
+        std::atomic<bool> has_data{false};
+    };
+    std::unique_ptr<Slot[]> slots;
+    CDirtySet dirty;
+
+    Slot* GetSlot(TickerId ticker_id) const {
+        if (ticker_id < 0 || ticker_id >= MAX_TICKER_DATA_SLOTS) return nullptr;
+        return &slots[ticker_id];
+    }
+
+public:
+    CTickerDataStore() : slots(new Slot[MAX_TICKER_DATA_SLOTS]), dirty(MAX_TICKER_DATA_SLOTS) {}
+
+    bool IsValidTickerId(TickerId ticker_id) const;
+    bool HasData(TickerId ticker_id) const;
+    TickerData Get(TickerId ticker_id) const;
+    void SetLastPrice(TickerId ticker_id, double price);
+    void SetOpenPrice(TickerId ticker_id, double price);
+    void SetClosePrice(TickerId ticker_id, double price);
+    void UpdateDelta(TickerId ticker_id, double delta);
+    void Clear();
+
+    // TickerIds whose data changed since the previous call.
+    bool IsDirty() const { return dirty.IsPending(); }
+    void TakeDirty(std::vector<TickerId>& ticker_ids);
+};
+
+
+// ========================================================================================
+// Most recent IBKR portfolio values for every contract id. Contract ids are assigned a
+// slot the first time they are seen (open addressing, slots are never removed) so no
+// rehashing can occur while another thread is reading.
+// ========================================================================================
+class CPortfolioDataStore {
+    struct Slot {
+        std::atomic<int> contract_id{0};
+        CSeqLock<PortfolioData> data;
+        std::atomic<bool> has_data{false};
+    };
+    std::unique_ptr<Slot[]> slots;
+    CDirtySet dirty;
+
+    Slot* FindSlot(int contract_id, bool insert) const;
+
+public:
+    CPortfolioDataStore() : slots(new Slot[MAX_PORTFOLIO_DATA_SLOTS]), dirty(MAX_PORTFOLIO_DATA_SLOTS) {}
+
+    bool Get(int contract_id, PortfolioData& pd) const;
+    void Set(int contract_id, const PortfolioData& pd);
+
+    // Contract ids whose data changed since the previous call.
+    bool IsDirty() const { return dirty.IsPending(); }
+    void TakeDirty(std::vector<int>& contract_ids);
+};
+
+
+// These have to be global because the data is updated in the TwsClient::tickPrice and
+// TwsClient::updatePortfolio callbacks from the Interactive Brokers library (therefore
+// AppState can't be passed into them). They are instantiated in market_data.cpp
+extern CTickerDataStore ticker_data_store;
+extern CPortfolioDataStore portfolio_data_store;
+
+#endif  // MARKET_DATA_H
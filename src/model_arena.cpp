@@ -0,0 +1,292 @@
+/*
+
+MIT License
+
+Copyright(c) 2023-2025 Paul Squires
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <algorithm>
+
+#include "appstate.h"
+#include "model_arena.h"
+
+
+CModelArena model_arena;
+
+
+// Every slot is aligned for any model class or shared_ptr control block.
+static constexpr size_t SLOT_ALIGN = alignof(std::max_align_t);
+
+// Capacity of the first slab when nothing has been reserved. Later slabs double the
+// total capacity so that the number of slabs stays small.
+static constexpr size_t MIN_SLAB_CAPACITY = 256;
+
+// Number of slots a thread takes from the pool at a time, and the number of freed slots
+// a thread keeps before half of them are given back to the pool.
+static constexpr size_t CACHE_RUN_SLOTS = 256;
+static constexpr size_t CACHE_MAX_FREE_SLOTS = 1024;
+
+// Pools that get a cache in each thread. Any further pools always lock (there are six:
+// one object pool and one control block pool for each of the model classes).
+static constexpr int MAX_CACHED_POOLS = 8;
+static std::atomic<int> next_pool_index{0};
+
+
+// The caches of the current thread. When the thread ends the cached slots are given back
+// to their pools. After that the thread uses the pools directly.
+struct ThreadCaches {
+    CSlabPool* pools[MAX_CACHED_POOLS]{};
+    CSlabPool::ThreadCache caches[MAX_CACHED_POOLS];
+    ~ThreadCaches();
+};
+
+static thread_local bool is_thread_cache_released = false;
+static thread_local ThreadCaches thread_caches;
+
+ThreadCaches::~ThreadCaches() {
+    for (int i = 0; i < MAX_CACHED_POOLS; ++i) {
+        if (pools[i]) pools[i]->ReleaseCache(caches[i]);
+    }
+    is_thread_cache_released = true;
+}
+
+
+static size_t RoundUpToSlot(size_t size) {
+    return (size + SLOT_ALIGN - 1) / SLOT_ALIGN * SLOT_ALIGN;
+}
+
+
+// ========================================================================================
+// Construct the pool. A size of zero means the slot size is set by the first Allocate().
+// ========================================================================================
+CSlabPool::CSlabPool(size_t size) {
+    slot_size = RoundUpToSlot(size);
+
+    int index = next_pool_index++;
+    if (index < MAX_CACHED_POOLS) pool_index = index;
+}
+
+
+// ========================================================================================
+// Release the slabs. Any objects still in the slabs must already have been destroyed.
+// ========================================================================================
+CSlabPool::~CSlabPool() {
+    for (auto memory : slabs) {
+        ::operator delete(memory, std::align_val_t(SLOT_ALIGN));
+    }
+}
+
+
+// ========================================================================================
+// Return the current thread's cache for this pool or nullptr if it does not have one.
+// ========================================================================================
+CSlabPool::ThreadCache* CSlabPool::GetThreadCache() {
+    if (pool_index < 0 || is_thread_cache_released) return nullptr;
+    thread_caches.pools[pool_index] = this;
+    return &thread_caches.caches[pool_index];
+}
+
+
+// ========================================================================================
+// Set the slot size from the first allocation and add any slab reserved before then.
+// ========================================================================================
+void CSlabPool::SetSlotSize(size_t size) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (slot_size != 0) return;
+
+    slot_size = RoundUpToSlot(size);
+    if (pending_reserve) AddSlab(pending_reserve);
+    pending_reserve = 0;
+}
+
+
+// ========================================================================================
+// Add a slab with room for capacity slots. Caller must hold the mutex.
+// ========================================================================================
+void CSlabPool::AddSlab(size_t capacity) {
+    size_t size = slot_size;
+    std::byte* memory = static_cast<std::byte*>(::operator new(capacity * size, std::align_val_t(SLOT_ALIGN)));
+
+    slabs.push_back(memory);
+    total_capacity += capacity;
+    next_unused = memory;
+    slab_end = memory + capacity * size;
+}
+
+
+// ========================================================================================
+// Give the thread's cache a batch of freed slots or, if there are none, a run of unused
+// slots from the last slab.
+// ========================================================================================
+void CSlabPool::RefillCache(ThreadCache& cache) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (!free_slots.empty()) {
+        size_t count = std::min(CACHE_RUN_SLOTS, free_slots.size());
+        cache.free_slots.insert(cache.free_slots.end(), free_slots.end() - count, free_slots.end());
+        free_slots.resize(free_slots.size() - count);
+        return;
+    }
+
+    size_t size = slot_size;
+    if (next_unused == slab_end) {
+        AddSlab(std::max(MIN_SLAB_CAPACITY, total_capacity));
+    }
+
+    size_t count = std::min(CACHE_RUN_SLOTS, (size_t)(slab_end - next_unused) / size);
+    cache.next = next_unused;
+    cache.end = next_unused + count * size;
+    next_unused = cache.end;
+}
+
+
+// ========================================================================================
+// Give the cached slots back to the pool (called when a thread ends).
+// ========================================================================================
+void CSlabPool::ReleaseCache(ThreadCache& cache) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    free_slots.insert(free_slots.end(), cache.free_slots.begin(), cache.free_slots.end());
+    for (std::byte* p = cache.next; p < cache.end; p += slot_size) {
+        free_slots.push_back(p);
+    }
+
+    cache.free_slots.clear();
+    cache.free_slots.shrink_to_fit();
+    cache.next = cache.end = nullptr;
+}
+
+
+// ========================================================================================
+// Return a free slot. Returns nullptr if size does not fit in the pool's slots so that
+// the caller can fall back to the general heap.
+// ========================================================================================
+void* CSlabPool::Allocate(size_t size) {
+    if (slot_size == 0) SetSlotSize(size);
+    size_t slot = slot_size;
+    if (size > slot) return nullptr;
+
+    ThreadCache* cache = GetThreadCache();
+    if (!cache) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!free_slots.empty()) {
+            void* p = free_slots.back();
+            free_slots.pop_back();
+            return p;
+        }
+        if (next_unused == slab_end) AddSlab(std::max(MIN_SLAB_CAPACITY, total_capacity));
+        void* p = next_unused;
+        next_unused += slot;
+        return p;
+    }
+
+    if (cache->free_slots.empty() && cache->next == cache->end) RefillCache(*cache);
+
+    if (!cache->free_slots.empty()) {
+        void* p = cache->free_slots.back();
+        cache->free_slots.pop_back();
+        return p;
+    }
+
+    void* p = cache->next;
+    cache->next += slot;
+    return p;
+}
+
+
+// ========================================================================================
+// Return a slot to the pool. Returns false if the slot was not allocated from the pool.
+// ========================================================================================
+bool CSlabPool::Free(void* slot, size_t size) {
+    if (!slot) return true;
+    if (size > slot_size) return false;
+
+    ThreadCache* cache = GetThreadCache();
+    if (!cache) {
+        std::lock_guard<std::mutex> lock(mutex);
+        free_slots.push_back(slot);
+        return true;
+    }
+
+    cache->free_slots.push_back(slot);
+
+    // Give half back so that slots freed by one thread can be reused by the others.
+    if (cache->free_slots.size() >= CACHE_MAX_FREE_SLOTS) {
+        size_t count = CACHE_MAX_FREE_SLOTS / 2;
+        std::lock_guard<std::mutex> lock(mutex);
+        free_slots.insert(free_slots.end(), cache->free_slots.end() - count, cache->free_slots.end());
+        cache->free_slots.resize(cache->free_slots.size() - count);
+    }
+    return true;
+}
+
+
+// ========================================================================================
+// Make sure that at least count slots can be allocated without adding another slab.
+// The missing slots are added as one slab.
+// ========================================================================================
+void CSlabPool::Reserve(size_t count) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (slot_size == 0) {
+        pending_reserve = std::max(pending_reserve, count);
+        return;
+    }
+
+    size_t size = slot_size;
+    size_t available = free_slots.size() + (size_t)(slab_end - next_unused) / size;
+    if (available >= count) return;
+
+    // Slots left at the end of the current slab would be skipped by the new slab so
+    // move them to the free list first.
+    for (; next_unused < slab_end; next_unused += size) {
+        free_slots.push_back(next_unused);
+    }
+
+    AddSlab(count - available);
+}
+
+
+// ========================================================================================
+// Create a new Trade, Transaction or Leg in the arena.
+// ========================================================================================
+std::shared_ptr<Trade> CModelArena::NewTrade() {
+    return trades.Make();
+}
+
+std::shared_ptr<Transaction> CModelArena::NewTransaction() {
+    return transactions.Make();
+}
+
+std::shared_ptr<Leg> CModelArena::NewLeg() {
+    return legs.Make();
+}
+
+
+// ========================================================================================
+// Reserve room for a bulk load of the given number of records.
+// ========================================================================================
+void CModelArena::Reserve(size_t trade_count, size_t trans_count, size_t leg_count) {
+    trades.Reserve(trade_count);
+    transactions.Reserve(trans_count);
+    legs.Reserve(leg_count);
+}
@@ -0,0 +1,165 @@
+/*
+
+MIT License
+
+Copyright(c) 2023-2025 Paul Squires
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef MODEL_ARENA_H
+#define MODEL_ARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+class Trade;
+class Transaction;
+class Leg;
+
+
+// Fixed size slots carved out of large contiguous slabs. Each slab is a single allocation
+// that holds many slots and the slabs are only released when the pool is destroyed.
+// Each thread takes a run of slots (or a batch of freed slots) from the pool at a time and
+// then allocates and frees from its own cache without locking, so the parallel database
+// load does not serialize on the pool.
+class CSlabPool {
+public:
+    void* Allocate(size_t size);
+    bool Free(void* slot, size_t size);
+    void Reserve(size_t count);
+
+    explicit CSlabPool(size_t size = 0);
+    ~CSlabPool();
+
+    CSlabPool(const CSlabPool&) = delete;
+    CSlabPool& operator=(const CSlabPool&) = delete;
+
+    // Slots cached by one thread (see model_arena.cpp)
+    struct ThreadCache {
+        std::byte* next = nullptr;           // unused run of slots taken from a slab
+        std::byte* end = nullptr;
+        std::vector<void*> free_slots;
+    };
+
+    void ReleaseCache(ThreadCache& cache);
+
+private:
+    ThreadCache* GetThreadCache();
+    void SetSlotSize(size_t size);
+    void RefillCache(ThreadCache& cache);
+    void AddSlab(size_t capacity);
+
+    int pool_index = -1;                     // index of this pool's cache in each thread (-1 = none)
+
+    std::mutex mutex;                        // protects everything below
+    std::atomic<size_t> slot_size = 0;       // set by the first Allocate() when not known up front
+    size_t pending_reserve = 0;              // Reserve() made before the slot size was known
+    size_t total_capacity = 0;
+    std::byte* next_unused = nullptr;        // never used slots at the end of the last slab
+    std::byte* slab_end = nullptr;
+    std::vector<std::byte*> slabs;
+    std::vector<void*> free_slots;
+};
+
+
+// Pool for one of the model classes. The objects live in their own slabs so that walking
+// the Trades, Transactions or Legs touches contiguous memory. The shared_ptr control
+// blocks are taken from a second pool instead of the general heap.
+template <typename T>
+class CModelPool {
+public:
+    CModelPool() : objects(sizeof(T)) {}
+
+    std::shared_ptr<T> Make() {
+        void* slot = objects.Allocate(sizeof(T));
+        T* object = new (slot) T();
+        return std::shared_ptr<T>(object, Deleter{this}, BlockAllocator<T>{this});
+    }
+
+    void Reserve(size_t count) {
+        objects.Reserve(count);
+        control_blocks.Reserve(count);
+    }
+
+private:
+    struct Deleter {
+        CModelPool* pool;
+        void operator()(T* object) const {
+            object->~T();
+            pool->objects.Free(object, sizeof(T));
+        }
+    };
+
+    template <typename U>
+    struct BlockAllocator {
+        using value_type = U;
+        template <typename V> struct rebind { using other = BlockAllocator<V>; };
+
+        CModelPool* pool;
+
+        BlockAllocator(CModelPool* p) : pool(p) {}
+        template <typename V> BlockAllocator(const BlockAllocator<V>& other) : pool(other.pool) {}
+
+        U* allocate(size_t n) {
+            static_assert(alignof(U) <= alignof(std::max_align_t));
+            void* block = pool->control_blocks.Allocate(n * sizeof(U));
+            return static_cast<U*>(block ? block : ::operator new(n * sizeof(U)));
+        }
+
+        void deallocate(U* block, size_t n) {
+            if (!pool->control_blocks.Free(block, n * sizeof(U))) ::operator delete(block);
+        }
+
+        template <typename V> bool operator==(const BlockAllocator<V>& other) const { return pool == other.pool; }
+        template <typename V> bool operator!=(const BlockAllocator<V>& other) const { return pool != other.pool; }
+    };
+
+    CSlabPool objects;
+    CSlabPool control_blocks;
+};
+
+
+// Owns the storage for every Trade, Transaction and Leg in the application. Objects are
+// still handed out as shared_ptr so that the UI can hold on to them, but the memory comes
+// from per class slabs. The database loaders Reserve() the record counts up front so that
+// a bulk load needs only one allocation per slab.
+class CModelArena {
+public:
+    std::shared_ptr<Trade> NewTrade();
+    std::shared_ptr<Transaction> NewTransaction();
+    std::shared_ptr<Leg> NewLeg();
+
+    void Reserve(size_t trade_count, size_t trans_count, size_t leg_count);
+
+private:
+    CModelPool<Trade> trades;
+    CModelPool<Transaction> transactions;
+    CModelPool<Leg> legs;
+};
+
+extern CModelArena model_arena;
+
+#endif //MODEL_ARENA_H
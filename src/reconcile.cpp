@@ -32,6 +32,7 @@ SOFTWARE.
 #include "reconcile.h"
 
 // #include <iostream>
+#include <unordered_map>
 
 
 #ifdef __WXMSW__
@@ -50,6 +51,46 @@ double intelDecimalToDouble(Decimal decimal) {
 std::vector<positionStruct> ibkr_positions;    // persistent 
 std::vector<positionStruct> local_positions;   // persistent 
 
+// Index of each IBKR position by contract id and of each aggregated LOCAL position by
+// its key. Both are kept in step with the vectors above.
+static std::unordered_map<int, size_t> ibkr_index;
+static std::unordered_map<PositionKey, size_t, PositionKeyHash> local_index;
+
+
+// ========================================================================================
+// Hash of the packed position key.
+// ========================================================================================
+size_t PositionKeyHash::operator()(const PositionKey& key) const {
+	uint64_t h = key.symbol_id;
+	h = h * 0x9E3779B97F4A7C15ULL + (uint64_t)key.sec_type;
+	h = h * 0x9E3779B97F4A7C15ULL + (uint64_t)(uint8_t)key.put_call;
+	h = h * 0x9E3779B97F4A7C15ULL + (uint64_t)(uint32_t)key.expiry_date;
+	h = h * 0x9E3779B97F4A7C15ULL + (uint64_t)key.strike_price;
+	return (size_t)(h ^ (h >> 32));
+}
+
+
+// ========================================================================================
+// Build the packed key of a position from its text fields.
+// ========================================================================================
+static PositionKey MakePositionKey(const positionStruct& p) {
+	PositionKey key{};
+	key.symbol_id = symbol_table.Intern(p.ticker_symbol);
+
+	if (p.underlying == "STK") key.sec_type = PositionSecType::stock;
+	else if (p.underlying == "FUT") key.sec_type = PositionSecType::future;
+	else if (p.underlying == "OPT") key.sec_type = PositionSecType::option;
+	else if (p.underlying == "FOP") key.sec_type = PositionSecType::future_option;
+
+	if (key.sec_type == PositionSecType::option || key.sec_type == PositionSecType::future_option) {
+		key.put_call = p.put_call.empty() ? 0 : p.put_call[0];
+		key.expiry_date = AfxValInteger(p.expiry_date);
+		key.strike_price = p.strike_price.Value();
+	}
+	return key;
+}
+
+
 // ========================================================================================
 // Load one open trades into the local_positions vector
 // ========================================================================================
@@ -65,8 +106,8 @@ void Reconcile_LoadOneLocalPosition(AppState& state, const auto& trade) {
 		if (leg->underlying == Underlying::Options) p.underlying = "OPT";
 		if (leg->underlying == Underlying::Shares) p.underlying = "STK";
 
-		p.strike_price = AfxValDouble(leg->strike_price);
-		p.expiry_date = AfxRemoveDateHyphens(leg->expiry_date);
+		p.strike_price = leg->strike_price;
+		p.expiry_date = leg->expiry_date.ToCompactString();
 		p.put_call = state.db.PutCallToString(leg->put_call);
 
 		// Check if the ticker is a future
@@ -75,39 +116,24 @@ void Reconcile_LoadOneLocalPosition(AppState& state, const auto& trade) {
 			if (p.underlying == "OPT") p.underlying = "FOP";
 		}
 
+		p.key = MakePositionKey(p);
+
 		// Check to see if the LOCAL position already exists in the vector. If it
 		// does then simply update the Local quantity. We need to do this because IBKR
 		// aggregates all similar positions.
-		bool found = false;
-		for (auto& local : local_positions) {
-			if (p.underlying == "OPT" ||
-				p.underlying == "FOP") {
-				if (p.strike_price == local.strike_price &&
-					p.ticker_symbol == local.ticker_symbol &&
-					p.expiry_date == local.expiry_date &&
-					p.put_call == local.put_call) {
-					found = true;
-					local.open_quantity += p.open_quantity;
-					local.legs.push_back(leg);
-					break;
-				}
-			}
-			if (p.underlying == "STK" ||
-				p.underlying == "FUT") {
-				if (p.ticker_symbol == local.ticker_symbol &&
-					p.underlying == local.underlying) {
-					found = true;
-					local.open_quantity += p.open_quantity;
-					local.legs.push_back(leg);
-					break;
-				}
+		if (p.key.sec_type != PositionSecType::other) {
+			auto it = local_index.find(p.key);
+			if (it != local_index.end()) {
+				positionStruct& local = local_positions[it->second];
+				local.open_quantity += p.open_quantity;
+				local.legs.push_back(leg);
+				continue;
 			}
+			local_index[p.key] = local_positions.size();
 		}
 
-		if (found == false) {
-			p.legs.push_back(leg);
-			local_positions.push_back(p);
-		}
+		p.legs.push_back(leg);
+		local_positions.push_back(p);
 	}
 }
 
@@ -118,6 +144,7 @@ void Reconcile_LoadOneLocalPosition(AppState& state, const auto& trade) {
 void Reconcile_LoadAllLocalPositions(AppState& state) {
 	// Add all of the current LOCAL "Open" positions to the local_positions vector
 	local_positions.clear();
+	local_index.clear();
 	for (const auto& trade : state.db.trades) {
 		if (!trade->is_open) continue;
 		Reconcile_LoadOneLocalPosition(state, trade);
@@ -134,16 +161,6 @@ void Reconcile_position(const Contract& contract, Decimal position, double avg_c
 	// store them in the IBKRPositions vector for later processing.
 	// This function is also called whenever the position data on IBKR server changes. We update
 	// positions here as they are received.
-
-	// Remove any existing version of the contract before adding it again
-	auto end = std::remove_if(ibkr_positions.begin(),
-		ibkr_positions.end(),
-		[contract](positionStruct const& p) {
-			return (p.contract_id == contract.conId) ? true : false;
-		});
-	ibkr_positions.erase(end, ibkr_positions.end());
-
-	// Add the position the vector
 	positionStruct p{};
 	p.contract_id   = contract.conId;
 	p.contract      = contract;
@@ -151,45 +168,49 @@ void Reconcile_position(const Contract& contract, Decimal position, double avg_c
 	p.ticker_symbol = contract.symbol;
 	p.underlying    = contract.secType;
 	p.expiry_date   = contract.lastTradeDateOrContractMonth;   // YYYYMMDD
-	p.strike_price  = contract.strike;
 	p.put_call      = contract.right;
 	// If this is a Lean Hog Futures contract then we multiply the strike by 100 b/c IBKR
 	// stores it as cents but we placed the trade as "dollars".  eg. .85 vs. 85
+	double strike = contract.strike;
 	if (p.ticker_symbol == "HE" && p.underlying == "FOP") {
-		p.strike_price *= 100;
+		strike *= 100;
 	}
 	if (p.ticker_symbol == "LE" && p.underlying == "FOP") {
-		p.strike_price *= 100;
+		strike *= 100;
 	}
-	ibkr_positions.push_back(p);
+	// Rounded to the same fixed point scale as the strikes of the local legs.
+	p.strike_price  = FixedPrice::FromDouble(strike);
+	p.key = MakePositionKey(p);
+
+	// Replace any existing version of the contract
+	auto it = ibkr_index.find(p.contract_id);
+	if (it != ibkr_index.end()) {
+		ibkr_positions[it->second] = std::move(p);
+		return;
+	}
+	ibkr_index[p.contract_id] = ibkr_positions.size();
+	ibkr_positions.push_back(std::move(p));
 }
 
 
 // ========================================================================================
 // Test if IBKR and LOCAL position are equal
 // ========================================================================================
-bool Reconcile_ArePositionsEqual(positionStruct ibkr, positionStruct local) {
-	if (ibkr.underlying == "OPT" ||
-		ibkr.underlying == "FOP") {
-		if (ibkr.strike_price == local.strike_price &&
-			ibkr.open_quantity == local.open_quantity &&
-			ibkr.ticker_symbol == local.ticker_symbol &&
-			ibkr.expiry_date == local.expiry_date &&
-			ibkr.put_call == local.put_call &&
-			ibkr.underlying == local.underlying) {
-			return true;
-		}
-	}
-	if (ibkr.underlying == "STK" ||
-		ibkr.underlying == "FUT") {
-		if (ibkr.open_quantity == local.open_quantity &&
-			ibkr.ticker_symbol == local.ticker_symbol &&
-			ibkr.underlying == local.underlying) {
-			return true;
-		}
-	}
+bool Reconcile_ArePositionsEqual(const positionStruct& ibkr, const positionStruct& local) {
+	if (ibkr.key.sec_type == PositionSecType::other) return false;
+	return (ibkr.key == local.key && ibkr.open_quantity == local.open_quantity);
+}
 
-	return false;
+
+// ========================================================================================
+// Find the LOCAL position equal to the IBKR position. Returns -1 if there is none.
+// ========================================================================================
+static int FindEqualLocalPosition(const positionStruct& ibkr) {
+	if (ibkr.key.sec_type == PositionSecType::other) return -1;
+	auto it = local_index.find(ibkr.key);
+	if (it == local_index.end()) return -1;
+	if (local_positions[it->second].open_quantity != ibkr.open_quantity) return -1;
+	return (int)it->second;
 }
 
 
@@ -198,23 +219,44 @@ bool Reconcile_ArePositionsEqual(positionStruct ibkr, positionStruct local) {
 // is requested to be run.
 // ========================================================================================
 void Reconcile_doPositionMatching() {
+	// Position of the first LOCAL position that has already been assigned each contract id.
+	std::unordered_map<int, size_t> assigned;
+	assigned.reserve(local_positions.size());
+	for (size_t i = 0; i < local_positions.size(); ++i) {
+		if (local_positions[i].contract_id != 0) assigned.try_emplace(local_positions[i].contract_id, i);
+	}
+
 	for (const auto& ibkr : ibkr_positions) {
 		if (ibkr.open_quantity == 0) continue;
-		bool found = false;
-		for (auto& local : local_positions) {
-			// Check if the contract has previously already been assigned.
-			if (local.contract_id == ibkr.contract_id) break;
-			found = Reconcile_ArePositionsEqual(ibkr, local);
-			// If found, then update the Local vector to point to the contract_id of the 
-			// actual IBKR position. We use this when dealing with UpdatePortfolio() callbacks.
-			if (found) {
-				local.contract_id = ibkr.contract_id;
-				for (auto& leg : local.legs) {
-					leg->contract_id = ibkr.contract_id;
+
+		int index = FindEqualLocalPosition(ibkr);
+		if (index < 0) continue;
+
+		// Check if the contract has previously already been assigned.
+		auto it = assigned.find(ibkr.contract_id);
+		if (it != assigned.end() && it->second <= (size_t)index) continue;
+
+		// Update the Local vector to point to the contract_id of the actual IBKR position.
+		// We use this when dealing with UpdatePortfolio() callbacks.
+		positionStruct& local = local_positions[index];
+		if (local.contract_id != 0) {
+			// Rare: the LOCAL position was assigned a different contract earlier in this pass.
+			auto prev = assigned.find(local.contract_id);
+			if (prev != assigned.end() && prev->second == (size_t)index) {
+				assigned.erase(prev);
+				for (size_t i = index + 1; i < local_positions.size(); ++i) {
+					if (local_positions[i].contract_id == local.contract_id) {
+						assigned[local.contract_id] = i;
+						break;
+					}
 				}
-				break;
 			}
 		}
+		local.contract_id = ibkr.contract_id;
+		for (auto& leg : local.legs) {
+			leg->contract_id = ibkr.contract_id;
+		}
+		assigned[ibkr.contract_id] = index;
 	}
 }
 
@@ -231,11 +273,7 @@ void Reconcile_doReconciliation(AppState& state) {
 
 	for (const auto& ibkr : ibkr_positions) {
 		if (ibkr.open_quantity == 0) continue;
-		bool found = false;
-		for (auto& local : local_positions) {
-			found = Reconcile_ArePositionsEqual(ibkr, local);
-			if (found) break;
-		}
+		bool found = (FindEqualLocalPosition(ibkr) >= 0);
 		if (!found) {
 			text += sp + 
 				AfxRSet(std::to_string(ibkr.open_quantity), 8) +
@@ -245,7 +283,7 @@ void Reconcile_doReconciliation(AppState& state) {
 			if (ibkr.underlying == "OPT" || ibkr.underlying == "FOP") {
 				text += sp + 
 					AfxLSet(AfxInsertDateHyphens(ibkr.expiry_date), 12) + 
-					AfxRSet(std::to_string(ibkr.strike_price), 16) +
+					AfxRSet(std::to_string(ibkr.strike_price.ToDouble()), 16) +
 					AfxRSet(ibkr.put_call, 3);
 			}
 			text += "\n";
@@ -259,11 +297,21 @@ void Reconcile_doReconciliation(AppState& state) {
 	// (2) Determine what Local positions do not exist in the IBKR "real" database.
 	state.reconciliation_results_text += sp + "Local that do not exist in IBKR:\n";
 	text = "";
+
+	// IBKR positions can share a key (eg. an expired contract reported with zero quantity)
+	// so collect the quantities of every IBKR position having each key.
+	std::unordered_multimap<PositionKey, int, PositionKeyHash> ibkr_keys;
+	ibkr_keys.reserve(ibkr_positions.size());
+	for (const auto& ibkr : ibkr_positions) {
+		if (ibkr.key.sec_type == PositionSecType::other) continue;
+		ibkr_keys.emplace(ibkr.key, ibkr.open_quantity);
+	}
 	for (const auto& local : local_positions) {
 		bool found = false;
-		for (const auto& ibkr : ibkr_positions) {
-			found = Reconcile_ArePositionsEqual(ibkr, local);
-			if (found == true) break;
+		auto [first, last] = ibkr_keys.equal_range(local.key);
+		for (auto it = first; it != last; ++it) {
+			found = (it->second == local.open_quantity);
+			if (found) break;
 		}
 		if (!found) {
 			if (local.open_quantity != 0) {   // test b/c local may aggregate to zero and may already disappeard from IB
@@ -275,7 +323,7 @@ void Reconcile_doReconciliation(AppState& state) {
 				if (local.underlying == "OPT" || local.underlying == "FOP") {
 					text += sp +
 						AfxLSet(AfxInsertDateHyphens(local.expiry_date), 12) +
-						AfxRSet(std::to_string(local.strike_price), 16) +
+						AfxRSet(std::to_string(local.strike_price.ToDouble()), 16) +
 						AfxRSet(local.put_call, 3);
 				}
 				text += "\n";
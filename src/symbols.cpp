@@ -0,0 +1,106 @@
+/*
+
+MIT License
+
+Copyright(c) 2023-2025 Paul Squires
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <algorithm>
+#include <numeric>
+
+#include "symbols.h"
+
+
+CSymbolTable symbol_table;
+
+
+// ========================================================================================
+// Construct the table with the empty symbol as id 0.
+// ========================================================================================
+CSymbolTable::CSymbolTable() {
+    names.emplace_back();
+    ids.emplace(std::string(), 0);
+}
+
+
+// ========================================================================================
+// Return the id of the symbol. A new id is assigned the first time a symbol is seen.
+// ========================================================================================
+SymbolId CSymbolTable::Intern(const std::string& symbol) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto [it, inserted] = ids.try_emplace(symbol, (SymbolId)names.size());
+    if (inserted) {
+        names.push_back(symbol);
+        is_ranks_dirty = true;
+    }
+    return it->second;
+}
+
+
+// ========================================================================================
+// Return the id of the symbol without adding it. Returns SYMBOL_NONE if not interned.
+// ========================================================================================
+SymbolId CSymbolTable::Find(const std::string& symbol) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = ids.find(symbol);
+    return (it == ids.end()) ? SYMBOL_NONE : it->second;
+}
+
+
+// ========================================================================================
+// Return the text of the symbol.
+// ========================================================================================
+const std::string& CSymbolTable::Name(SymbolId id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return (id < names.size()) ? names[id] : names[0];
+}
+
+
+// ========================================================================================
+// Return the number of interned symbols (including the empty symbol).
+// ========================================================================================
+size_t CSymbolTable::Count() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return names.size();
+}
+
+
+// ========================================================================================
+// Return the alphabetical rank of every symbol. Ranks are only rebuilt after new symbols
+// have been interned.
+// ========================================================================================
+std::vector<uint32_t> CSymbolTable::SortRanks() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (is_ranks_dirty) {
+        std::vector<SymbolId> order(names.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(),
+            [this](SymbolId a, SymbolId b) { return names[a] < names[b]; });
+
+        ranks.resize(names.size());
+        for (uint32_t i = 0; i < order.size(); ++i) {
+            ranks[order[i]] = i;
+        }
+        is_ranks_dirty = false;
+    }
+    return ranks;
+}
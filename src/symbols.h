@@ -0,0 +1,71 @@
+/*
+
+MIT License
+
+Copyright(c) 2023-2025 Paul Squires
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef SYMBOLS_H
+#define SYMBOLS_H
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+// Dense integer id of an interned ticker symbol. Id 0 is always the empty symbol.
+using SymbolId = uint32_t;
+
+constexpr SymbolId SYMBOL_NONE = UINT32_MAX;      // returned by Find() for unknown symbols
+
+
+// Global table of every ticker symbol used by the application. Each distinct symbol is
+// stored once and identified by a SymbolId so that comparisons and per-symbol lookups are
+// integer operations. Symbols are interned from both the UI thread and the TWS thread.
+class CSymbolTable {
+public:
+    SymbolId Intern(const std::string& symbol);
+    SymbolId Find(const std::string& symbol);
+    const std::string& Name(SymbolId id);
+    size_t Count();
+
+    // Alphabetical rank of every symbol indexed by SymbolId. Comparing ranks gives the same
+    // ordering as comparing the symbol strings. The vector is a copy so that it can be used
+    // by a sort while other threads continue to intern symbols.
+    std::vector<uint32_t> SortRanks();
+
+    CSymbolTable();
+
+private:
+    std::mutex mutex;
+    std::deque<std::string> names;                  // deque keeps references stable
+    std::unordered_map<std::string, SymbolId> ids;
+    std::vector<uint32_t> ranks;
+    bool is_ranks_dirty = true;
+};
+
+extern CSymbolTable symbol_table;
+
+#endif //SYMBOLS_H
@@ -218,8 +218,11 @@ void DisplayIconButtons(AppState& state) {
         }
     }
     ImGui::PopStyleColor();
-    Tooltip(state, is_connected ? "Click to Disconnect" : "Click to Connect",
-        clrTextLightWhite(state), clrBackMediumGray(state));
+    bool is_reconnecting = (state.tws_connection_state == TwsConnectionState::Backoff ||
+                            state.tws_connection_state == TwsConnectionState::Connecting);
+    std::string tooltip_text = is_connected ? "Click to Disconnect" : "Click to Connect";
+    if (!is_connected && is_reconnecting) tooltip_text = "Connection lost. Reconnecting... Click to Connect now";
+    Tooltip(state, tooltip_text.c_str(), clrTextLightWhite(state), clrBackMediumGray(state));
 
     ImGui::SameLine(state.dpi(34.0f));
     ImGui::PushStyleColor(ImGuiCol_Text, clrGreen(state));
@@ -0,0 +1,373 @@
+/*
+
+MIT License
+
+Copyright(c) 2023-2025 Paul Squires
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+// Recording format (little endian, fields packed without padding):
+//
+//   "TTTICK1\0"                                  8 byte file header
+//   type (u8) timestamp (u64 microseconds since the recording started) payload
+//
+//   TICK_PRICE                ticker_id (i32) field (u8) price (f64)
+//   TICK_OPTION_COMPUTATION   ticker_id (i32) tick_type (u8) implied_vol (f64) delta (f64)
+//   UPDATE_PORTFOLIO          contract_id (i32) position (Decimal u64) market_price market_value
+//                             average_cost unrealized_pnl realized_pnl (f64 each)
+//   POSITION                  contract_id (i32) strike (f64) position (Decimal u64) avg_cost (f64)
+//                             symbol sec_type expiry right multiplier exchange currency
+//                             local_symbol trading_class (u8 length + characters each)
+
+#include <cfloat>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <algorithm>
+
+#if defined(_WIN32) // win32 and win64
+	#include "tws-api/windows/Contract.h"
+#else
+	#include "tws-api/linux/Contract.h"
+#endif
+
+#include "tick_recorder.h"
+
+
+CTickRecorder tick_recorder;
+
+static const char TICK_RECORDING_MAGIC[8] = { 'T', 'T', 'T', 'I', 'C', 'K', '1', '\0' };
+
+enum class TickRecordType : uint8_t {
+    tick_price = 1,
+    tick_option_computation,
+    update_portfolio,
+    position
+};
+
+// Buffered records are written when the buffer reaches this size or every flush interval.
+static const size_t TICK_RECORDER_FLUSH_SIZE = 256 * 1024;
+static const int TICK_RECORDER_FLUSH_INTERVAL = 250;   // milliseconds
+
+
+template <typename T>
+static void PutValue(std::vector<char>& buffer, T value) {
+    const char* p = reinterpret_cast<const char*>(&value);
+    buffer.insert(buffer.end(), p, p + sizeof(T));
+}
+
+static void PutString(std::vector<char>& buffer, const std::string& text) {
+    size_t length = std::min<size_t>(text.length(), 255);
+    buffer.push_back((char)length);
+    buffer.insert(buffer.end(), text.begin(), text.begin() + length);
+}
+
+
+// ========================================================================================
+// Open the recording file and start the background writer thread.
+// ========================================================================================
+bool CTickRecorder::Start(const std::string& filename) {
+    if (IsRecording()) return true;
+
+    file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cout << "Could not open tick recording file " << filename << std::endl;
+        return false;
+    }
+    file.write(TICK_RECORDING_MAGIC, sizeof(TICK_RECORDING_MAGIC));
+
+    buffer.clear();
+    buffer.reserve(TICK_RECORDER_FLUSH_SIZE * 2);
+    stop_requested = false;
+    start_time = std::chrono::steady_clock::now();
+    writer_thread = std::thread(&CTickRecorder::WriterFunction, this);
+    is_recording = true;
+
+    std::cout << "Recording ticks to " << filename << std::endl;
+    return true;
+}
+
+
+// ========================================================================================
+// Stop recording. The remaining buffered records are written before the file is closed.
+// ========================================================================================
+void CTickRecorder::Stop() {
+    if (!IsRecording()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        is_recording = false;
+        stop_requested = true;
+    }
+    cv.notify_all();
+
+    if (writer_thread.joinable()) writer_thread.join();
+    file.close();
+}
+
+
+CTickRecorder::~CTickRecorder() {
+    Stop();
+}
+
+
+// ========================================================================================
+// Background thread that moves the buffered records to disk.
+// ========================================================================================
+void CTickRecorder::WriterFunction() {
+    std::vector<char> writing;
+    writing.reserve(TICK_RECORDER_FLUSH_SIZE * 2);
+
+    while (true) {
+        bool is_stopping = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait_for(lock, std::chrono::milliseconds(TICK_RECORDER_FLUSH_INTERVAL), [this] {
+                return stop_requested || buffer.size() >= TICK_RECORDER_FLUSH_SIZE;
+            });
+            buffer.swap(writing);
+            is_stopping = stop_requested;
+        }
+
+        if (!writing.empty()) {
+            file.write(writing.data(), writing.size());
+            file.flush();
+            writing.clear();
+        }
+
+        if (is_stopping) break;
+    }
+}
+
+
+// ========================================================================================
+// Start a record. Must be called with the mutex held.
+// ========================================================================================
+void CTickRecorder::BeginRecord(uint8_t type) {
+    uint64_t timestamp = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start_time).count();
+    buffer.push_back((char)type);
+    PutValue(buffer, timestamp);
+}
+
+
+// ========================================================================================
+// Finish a record. Must be called with the mutex held. The writer is woken early when the
+// buffer is full.
+// ========================================================================================
+void CTickRecorder::EndRecord() {
+    if (buffer.size() >= TICK_RECORDER_FLUSH_SIZE) cv.notify_one();
+}
+
+
+void CTickRecorder::RecordTickPrice(TickerId ticker_id, TickType field, double price) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!IsRecording()) return;
+    BeginRecord((uint8_t)TickRecordType::tick_price);
+    PutValue(buffer, (int32_t)ticker_id);
+    PutValue(buffer, (uint8_t)field);
+    PutValue(buffer, price);
+    EndRecord();
+}
+
+
+void CTickRecorder::RecordTickOptionComputation(TickerId ticker_id, TickType tick_type, double implied_vol, double delta) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!IsRecording()) return;
+    BeginRecord((uint8_t)TickRecordType::tick_option_computation);
+    PutValue(buffer, (int32_t)ticker_id);
+    PutValue(buffer, (uint8_t)tick_type);
+    PutValue(buffer, implied_vol);
+    PutValue(buffer, delta);
+    EndRecord();
+}
+
+
+void CTickRecorder::RecordUpdatePortfolio(const Contract& contract, Decimal position, double market_price,
+    double market_value, double average_cost, double unrealized_pnl, double realized_pnl) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!IsRecording()) return;
+    BeginRecord((uint8_t)TickRecordType::update_portfolio);
+    PutValue(buffer, (int32_t)contract.conId);
+    PutValue(buffer, position);
+    PutValue(buffer, market_price);
+    PutValue(buffer, market_value);
+    PutValue(buffer, average_cost);
+    PutValue(buffer, unrealized_pnl);
+    PutValue(buffer, realized_pnl);
+    EndRecord();
+}
+
+
+void CTickRecorder::RecordPosition(const Contract& contract, Decimal position, double avg_cost) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!IsRecording()) return;
+    BeginRecord((uint8_t)TickRecordType::position);
+    PutValue(buffer, (int32_t)contract.conId);
+    PutValue(buffer, contract.strike);
+    PutValue(buffer, position);
+    PutValue(buffer, avg_cost);
+    PutString(buffer, contract.symbol);
+    PutString(buffer, contract.secType);
+    PutString(buffer, contract.lastTradeDateOrContractMonth);
+    PutString(buffer, contract.right);
+    PutString(buffer, contract.multiplier);
+    PutString(buffer, contract.exchange);
+    PutString(buffer, contract.currency);
+    PutString(buffer, contract.localSymbol);
+    PutString(buffer, contract.tradingClass);
+    EndRecord();
+}
+
+
+// ========================================================================================
+// Sequential reader over the bytes of a recording. Reads past the end fail (truncated
+// final record of an interrupted recording).
+// ========================================================================================
+class CTickRecordReader {
+public:
+    CTickRecordReader(const std::vector<char>& data) : ptr(data.data()), end(data.data() + data.size()) {}
+
+    bool AtEnd() const { return ptr >= end; }
+
+    template <typename T>
+    bool Get(T& value) {
+        if ((size_t)(end - ptr) < sizeof(T)) return false;
+        memcpy(&value, ptr, sizeof(T));
+        ptr += sizeof(T);
+        return true;
+    }
+
+    bool GetString(std::string& text) {
+        uint8_t length = 0;
+        if (!Get(length) || (size_t)(end - ptr) < length) return false;
+        text.assign(ptr, length);
+        ptr += length;
+        return true;
+    }
+
+private:
+    const char* ptr;
+    const char* end;
+};
+
+
+// ========================================================================================
+// Wait until the record is due. Waits in short steps so that a stop request is noticed.
+// ========================================================================================
+static bool WaitUntilDue(std::chrono::steady_clock::time_point due, const std::atomic<bool>& stop_requested) {
+    while (!stop_requested) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= due) return true;
+        std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(due - now, std::chrono::milliseconds(100)));
+    }
+    return false;
+}
+
+
+// ========================================================================================
+// Feed a recorded log back into the callbacks of the wrapper.
+// ========================================================================================
+size_t TickReplay_Run(EWrapper* wrapper, const std::string& filename, double speed, const std::atomic<bool>& stop_requested) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cout << "Could not open tick recording file " << filename << std::endl;
+        return 0;
+    }
+
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() < sizeof(TICK_RECORDING_MAGIC) ||
+        memcmp(data.data(), TICK_RECORDING_MAGIC, sizeof(TICK_RECORDING_MAGIC)) != 0) {
+        std::cout << "Not a tick recording file " << filename << std::endl;
+        return 0;
+    }
+    data.erase(data.begin(), data.begin() + sizeof(TICK_RECORDING_MAGIC));
+
+    CTickRecordReader reader(data);
+    auto start = std::chrono::steady_clock::now();
+    size_t num_records = 0;
+
+    TickAttrib attrib{};
+    Contract contract;
+
+    while (!reader.AtEnd() && !stop_requested) {
+        uint8_t type = 0;
+        uint64_t timestamp = 0;
+        if (!reader.Get(type) || !reader.Get(timestamp)) break;
+
+        if (speed > 0) {
+            auto due = start + std::chrono::microseconds((long long)(timestamp / speed));
+            if (!WaitUntilDue(due, stop_requested)) break;
+        }
+
+        int32_t id = 0;
+        uint8_t tick_type = 0;
+        double value1 = 0, value2 = 0;
+
+        switch ((TickRecordType)type) {
+        case TickRecordType::tick_price:
+            if (!reader.Get(id) || !reader.Get(tick_type) || !reader.Get(value1)) return num_records;
+            wrapper->tickPrice(id, (TickType)tick_type, value1, attrib);
+            break;
+
+        case TickRecordType::tick_option_computation:
+            if (!reader.Get(id) || !reader.Get(tick_type) || !reader.Get(value1) || !reader.Get(value2)) return num_records;
+            wrapper->tickOptionComputation(id, (TickType)tick_type, 0, value1, value2,
+                DBL_MAX, DBL_MAX, DBL_MAX, DBL_MAX, DBL_MAX, DBL_MAX);
+            break;
+
+        case TickRecordType::update_portfolio: {
+            Decimal position = 0;
+            double market_price = 0, market_value = 0, average_cost = 0, unrealized_pnl = 0, realized_pnl = 0;
+            if (!reader.Get(id) || !reader.Get(position) || !reader.Get(market_price) ||
+                !reader.Get(market_value) || !reader.Get(average_cost) ||
+                !reader.Get(unrealized_pnl) || !reader.Get(realized_pnl)) return num_records;
+            contract = Contract();
+            contract.conId = id;
+            wrapper->updatePortfolio(contract, position, market_price, market_value,
+                average_cost, unrealized_pnl, realized_pnl, "");
+            break;
+        }
+
+        case TickRecordType::position: {
+            Decimal position = 0;
+            contract = Contract();
+            if (!reader.Get(id) || !reader.Get(contract.strike) || !reader.Get(position) || !reader.Get(value1) ||
+                !reader.GetString(contract.symbol) || !reader.GetString(contract.secType) ||
+                !reader.GetString(contract.lastTradeDateOrContractMonth) || !reader.GetString(contract.right) ||
+                !reader.GetString(contract.multiplier) || !reader.GetString(contract.exchange) ||
+                !reader.GetString(contract.currency) || !reader.GetString(contract.localSymbol) ||
+                !reader.GetString(contract.tradingClass)) return num_records;
+            contract.conId = id;
+            wrapper->position("", contract, position, value1);
+            break;
+        }
+
+        default:
+            std::cout << "Unknown tick record type " << (int)type << std::endl;
+            return num_records;
+        }
+
+        num_records++;
+    }
+
+    return num_records;
+}
@@ -0,0 +1,88 @@
+/*
+
+MIT License
+
+Copyright(c) 2023-2025 Paul Squires
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef TICK_RECORDER_H
+#define TICK_RECORDER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32) // win32 and win64
+	#include "tws-api/windows/EWrapper.h"
+#else
+	#include "tws-api/linux/EWrapper.h"
+#endif
+
+
+// Records the market data and position callbacks received from TWS into a compact binary
+// log (see tick_recorder.cpp for the format). The callbacks only append to a memory
+// buffer. A background thread writes the buffer to disk.
+class CTickRecorder {
+public:
+    bool Start(const std::string& filename);
+    void Stop();
+    bool IsRecording() const { return is_recording.load(std::memory_order_relaxed); }
+
+    void RecordTickPrice(TickerId ticker_id, TickType field, double price);
+    void RecordTickOptionComputation(TickerId ticker_id, TickType tick_type, double implied_vol, double delta);
+    void RecordUpdatePortfolio(const Contract& contract, Decimal position, double market_price,
+        double market_value, double average_cost, double unrealized_pnl, double realized_pnl);
+    void RecordPosition(const Contract& contract, Decimal position, double avg_cost);
+
+    ~CTickRecorder();
+
+private:
+    void BeginRecord(uint8_t type);
+    void EndRecord();
+    void WriterFunction();
+
+    std::atomic<bool> is_recording{false};
+    bool stop_requested = false;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<char> buffer;          // records waiting to be written
+    std::thread writer_thread;
+    std::ofstream file;
+    std::chrono::steady_clock::time_point start_time;
+};
+
+extern CTickRecorder tick_recorder;
+
+
+// Feed a recorded log back into the callbacks of the wrapper. speed is a multiple of the
+// recorded rate (1 = real time). Zero replays as fast as possible. Returns the number of
+// records replayed.
+size_t TickReplay_Run(EWrapper* wrapper, const std::string& filename, double speed, const std::atomic<bool>& stop_requested);
+
+#endif //TICK_RECORDER_H
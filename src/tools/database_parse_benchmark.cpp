@@ -0,0 +1,184 @@
+/*
+
+MIT License
+
+Copyright(c) 2023-2025 Paul Squires
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+// Parse throughput benchmark for the text database loader (CDatabase::LoadDatabaseText).
+//
+// A synthetic database is generated (100,000 Trades by default, each with one to four
+// Transactions of one to three Legs) and written to a temporary file. The file is then
+// loaded several times and the time and throughput in MB/s of every run is printed. The
+// snapshot and journal are not involved, only the text parser.
+//
+// Build with -DBUILD_BENCHMARK_TOOLS=ON.
+//
+// Usage: database-parse-benchmark [--trades N] [--runs N] [--keep <file>]
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "appstate.h"
+#include "messagebox.h"
+
+
+// ========================================================================================
+// The loader reports a missing file through a message box. Print it instead.
+// ========================================================================================
+void CustomMessageBox(AppState&, const std::string& caption, const std::string& message) {
+    std::cerr << caption << ": " << message << "\n";
+}
+
+
+// ========================================================================================
+// Build a synthetic text database holding num_trades Trades. The same seed always
+// produces the same file so that runs can be compared.
+// ========================================================================================
+static std::string GenerateDatabase(int num_trades) {
+    static const char* tickers[] = { "AAPL", "SPY", "/ES", "MSFT", "SPX", "TSLA", "QQQ", "/CL" };
+    static const int underlyings[] = { 0, 0, 1, 3 };
+
+    std::mt19937 rng(1);
+    auto rand_int = [&rng](int lo, int hi) { return std::uniform_int_distribution<int>(lo, hi)(rng); };
+    auto rand_real = [&rng](double lo, double hi) { return std::uniform_real_distribution<double>(lo, hi)(rng); };
+
+    std::string text;
+    text.reserve((size_t)num_trades * 400);
+    text += "// TRADE          T|isOpen|nextleg_id|TickerSymbol|TickerName|FutureExpiry|Category|TradeBP|Notes|3dteWarning|21dteWarning|ProfitPercentage\n";
+
+    char line[512];
+    for (int i = 0; i < num_trades; ++i) {
+        const char* ticker = tickers[rand_int(0, 7)];
+        bool is_open = (rand_int(0, 9) == 0);
+        bool is_future = (ticker[0] == '/');
+
+        std::snprintf(line, sizeof(line), "T|%d|3|%s|%s Inc|%s|%d|%d|note %d~~line2|1|0|%.4f\n",
+            is_open ? 1 : 0, ticker, ticker, is_future ? "20251219" : "",
+            rand_int(0, 5), rand_int(0, 5000), i, rand_real(0, 1));
+        text += line;
+
+        int num_trans = rand_int(1, 4);
+        for (int x = 0; x < num_trans; ++x) {
+            int year = rand_int(2015, 2025);
+            int month = rand_int(1, 12);
+            int day = rand_int(1, 28);
+            int underlying = underlyings[rand_int(0, 3)];
+
+            std::snprintf(line, sizeof(line), "%sX|%d%02d%02d|Iron Condor|%d|%d|%.4f|100.0000|1.2500|%.4f|%d\n",
+                is_open ? "  " : "", year, month, day, underlying, rand_int(1, 10),
+                rand_real(0, 10), rand_real(-1000, 1000), rand_int(0, 3));
+            text += line;
+
+            int num_legs = rand_int(1, 3);
+            for (int l = 0; l < num_legs; ++l) {
+                std::snprintf(line, sizeof(line), "%sL|%d|0|%d|%d|%d%02d%02d|%d%s|%c|%d|%d\n",
+                    is_open ? "    " : "", l + 1, rand_int(-5, 5), is_open ? rand_int(-5, 5) : 0,
+                    year, month, day, rand_int(50, 500), rand_int(0, 1) ? ".5" : "",
+                    rand_int(0, 1) ? 'P' : 'C', rand_int(0, 3), underlying);
+                text += line;
+            }
+        }
+    }
+
+    return text;
+}
+
+
+int main(int argc, char* argv[]) {
+    int num_trades = 100000;
+    int num_runs = 5;
+    std::string keep_filename;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--trades") == 0 && i + 1 < argc) {
+            num_trades = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            num_runs = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--keep") == 0 && i + 1 < argc) {
+            keep_filename = argv[++i];
+        } else {
+            std::cerr << "Usage: database-parse-benchmark [--trades N] [--runs N] [--keep <file>]\n";
+            return 1;
+        }
+    }
+
+    std::string filename = keep_filename;
+    if (filename.empty()) {
+        filename = (std::filesystem::temp_directory_path() / "tt-parse-benchmark.db").string();
+    }
+
+    std::string text = GenerateDatabase(num_trades);
+    {
+        std::ofstream db(filename, std::ios::out | std::ios::trunc | std::ios::binary);
+        db << text;
+        if (!db) {
+            std::cerr << "Could not write " << filename << "\n";
+            return 1;
+        }
+    }
+
+    double megabytes = (double)text.size() / (1024.0 * 1024.0);
+    std::printf("Generated %d trades, %.1f MB (%s)\n", num_trades, megabytes, filename.c_str());
+
+    AppState state;
+    state.db.dbFilename = filename;
+
+    double best_ms = 0;
+    double total_ms = 0;
+    for (int run = 1; run <= num_runs; ++run) {
+        state.db.trades.clear();
+
+        auto start = std::chrono::steady_clock::now();
+        bool is_loaded = state.db.LoadDatabaseText(state);
+        auto finish = std::chrono::steady_clock::now();
+
+        if (!is_loaded || (int)state.db.trades.size() != num_trades) {
+            std::cerr << "Run " << run << ": expected " << num_trades << " trades, loaded "
+                      << state.db.trades.size() << "\n";
+            return 1;
+        }
+
+        double ms = std::chrono::duration<double, std::milli>(finish - start).count();
+        if (run == 1 || ms < best_ms) best_ms = ms;
+        total_ms += ms;
+        std::printf("Run %d: %8.1f ms  %7.1f MB/s\n", run, ms, megabytes / (ms / 1000.0));
+    }
+
+    if (num_runs > 0) {
+        std::printf("Best:  %8.1f ms  %7.1f MB/s\n", best_ms, megabytes / (best_ms / 1000.0));
+        std::printf("Mean:  %8.1f ms  %7.1f MB/s\n", total_ms / num_runs, megabytes / (total_ms / num_runs / 1000.0));
+    }
+
+    state.db.trades.clear();
+    if (keep_filename.empty()) std::filesystem::remove(filename);
+
+    return 0;
+}
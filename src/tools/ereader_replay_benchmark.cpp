@@ -0,0 +1,415 @@
+/*
+
+MIT License
+
+Copyright(c) 2023-2025 Paul Squires
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+// Replay benchmark for the buffered socket read loop of the TWS API EReader.
+//
+// A byte stream of V100+ messages (4 byte big endian length followed by the body) is fed
+// through two copies of the EReader read loop: the previous bufferedRead, which shifted
+// all of the unread bytes down to the front of m_buf after every read, and the current
+// one, which advances m_bufOffset and compacts once per socket receive. The read loop is
+// reproduced here (see src/tws-api/*/EReader.cpp) because the real EReader can only read
+// from a connected EClientSocket. Keep the two in step when EReader changes.
+//
+// The stream arrives in bursts: each burst makes the given number of messages available
+// at once and the reader drains it one receive (at most m_nMaxBufSize bytes) at a time.
+// Both readers must return the same messages. The time and throughput of each reader is
+// printed for every burst size.
+//
+// The stream is either generated (tickPrice messages) or loaded from a session recorded
+// with mock-tws-server --upstream ... --record FILE.
+//
+// Build with -DBUILD_BENCHMARK_TOOLS=ON.
+//
+// Usage: ereader-replay-benchmark [--session FILE] [--messages N] [--buffer BYTES]
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+static const int MSG_TICK_PRICE = 1;
+static const int TICK_LAST = 4;
+static const unsigned int IN_BUF_SIZE_DEFAULT = 8192;      // as in EReader.cpp
+static const int MAX_MSG_LEN = 0xFFFFFF;                    // as in EDecoder.h
+
+// Magic at the start of a session file recorded by mock-tws-server. Each record that
+// follows is a uint64 microsecond offset, a uint32 length and the message body.
+static const char RECORDING_MAGIC[8] = { 'T', 'T', 'W', 'I', 'R', 'E', '1', '\0' };
+
+
+// ========================================================================================
+// Append one message (length prefix plus body) to the wire stream.
+// ========================================================================================
+static void AppendMessage(std::vector<char>& stream, const char* body, uint32_t len) {
+    char prefix[4] = { (char)(len >> 24), (char)(len >> 16), (char)(len >> 8), (char)len };
+    stream.insert(stream.end(), prefix, prefix + 4);
+    stream.insert(stream.end(), body, body + len);
+}
+
+
+// ========================================================================================
+// Generate tickPrice messages like those TWS streams for subscribed market data.
+// ========================================================================================
+static void GenerateStream(int num_messages, std::vector<char>& stream, std::vector<size_t>& offsets) {
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> ticker_ids(100, 2100);
+    std::uniform_real_distribution<double> prices(1.0, 500.0);
+
+    char body[128];
+    for (int i = 0; i < num_messages; ++i) {
+        offsets.push_back(stream.size());
+        int len = std::snprintf(body, sizeof(body), "%d%c6%c%d%c%d%c%.2f%c0%c0%c",
+            MSG_TICK_PRICE, 0, 0, ticker_ids(rng), 0, TICK_LAST, 0, prices(rng), 0, 0, 0);
+        AppendMessage(stream, body, (uint32_t)len);
+    }
+    offsets.push_back(stream.size());
+}
+
+
+// ========================================================================================
+// Load a session recorded by mock-tws-server.
+// ========================================================================================
+static bool LoadSession(const std::string& filename, std::vector<char>& stream, std::vector<size_t>& offsets) {
+    std::ifstream file(filename, std::ios::binary);
+    char magic[8] = {};
+    if (!file.read(magic, sizeof(magic)) || memcmp(magic, RECORDING_MAGIC, sizeof(magic)) != 0) {
+        std::cerr << "Not a recorded session file: " << filename << "\n";
+        return false;
+    }
+
+    std::vector<char> body;
+    uint64_t offset_us = 0;
+    uint32_t len = 0;
+
+    while (file.read((char*)&offset_us, sizeof(offset_us)) && file.read((char*)&len, sizeof(len))) {
+        body.resize(len);
+        if (!file.read(body.data(), len)) break;
+        offsets.push_back(stream.size());
+        AppendMessage(stream, body.data(), len);
+    }
+    offsets.push_back(stream.size());
+
+    return offsets.size() > 1;
+}
+
+
+// ========================================================================================
+// Stands in for the socket. A new burst of messages becomes available only once the
+// previous burst has been received in full.
+// ========================================================================================
+class ReplaySource {
+public:
+    ReplaySource(const std::vector<char>& stream, const std::vector<size_t>& offsets, size_t burst_size)
+        : stream(stream), offsets(offsets), burst_size(burst_size) {}
+
+    int receive(char* buf, size_t sz) {
+        if (pos == burst_end) {
+            if (pos == stream.size()) return 0;
+            next_message = std::min(next_message + burst_size, offsets.size() - 1);
+            burst_end = offsets[next_message];
+        }
+        size_t n = std::min(sz, burst_end - pos);
+        memcpy(buf, stream.data() + pos, n);
+        pos += n;
+        return (int)n;
+    }
+
+    bool isSocketOK() const { return pos < stream.size(); }
+
+private:
+    const std::vector<char>& stream;
+    const std::vector<size_t>& offsets;
+    size_t burst_size;
+    size_t next_message = 0;
+    size_t burst_end = 0;
+    size_t pos = 0;
+};
+
+
+static uint32_t NetworkToHost(uint32_t value) {
+    const unsigned char* p = (const unsigned char*)&value;
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+
+// ========================================================================================
+// The read loop before the change: every read shifts the unread bytes to the front.
+// ========================================================================================
+class PreviousReader {
+public:
+    PreviousReader(ReplaySource& source, unsigned int max_buf_size) : m_source(source), m_nMaxBufSize(max_buf_size) {
+        m_buf.reserve(max_buf_size);
+    }
+
+    bool readSingleMsg(std::vector<char>& msg) {
+        int msgSize;
+
+        if (!bufferedRead((char*)&msgSize, sizeof(msgSize)))
+            return false;
+
+        msgSize = (int)NetworkToHost((uint32_t)msgSize);
+
+        if (msgSize <= 0 || msgSize > MAX_MSG_LEN)
+            return false;
+
+        msg.resize(msgSize);
+        return bufferedRead(msg.data(), msgSize);
+    }
+
+private:
+    // The socket is readable while any of the stream is left.
+    bool processNonBlockingSelect() {
+        if (!m_source.isSocketOK())
+            return false;
+
+        onReceive();
+        return true;
+    }
+
+    void onReceive() {
+        int nOffset = (int)m_buf.size();
+
+        m_buf.resize(m_nMaxBufSize);
+
+        int nRes = m_source.receive(m_buf.data() + nOffset, m_buf.size() - nOffset);
+
+        if (nRes <= 0)
+            return;
+
+        m_buf.resize(nRes + nOffset);
+    }
+
+    bool bufferedRead(char* buf, unsigned int size) {
+        while (size > 0) {
+            while (m_buf.size() < size && m_buf.size() < m_nMaxBufSize) {
+                if (!processNonBlockingSelect() && !m_source.isSocketOK())
+                    return false;
+            }
+
+            int nBytes = (std::min<unsigned int>)(m_nMaxBufSize, size);
+
+            std::copy(m_buf.begin(), m_buf.begin() + nBytes, buf);
+            std::copy(m_buf.begin() + nBytes, m_buf.end(), m_buf.begin());
+            m_buf.resize(m_buf.size() - nBytes);
+
+            size -= nBytes;
+            buf += nBytes;
+        }
+
+        return true;
+    }
+
+    ReplaySource& m_source;
+    std::vector<char> m_buf;
+    unsigned int m_nMaxBufSize;
+};
+
+
+// ========================================================================================
+// The current read loop: reads advance m_bufOffset, the buffer is compacted per receive.
+// ========================================================================================
+class CurrentReader {
+public:
+    CurrentReader(ReplaySource& source, unsigned int max_buf_size) : m_source(source), m_nMaxBufSize(max_buf_size) {
+        m_buf.reserve(max_buf_size);
+    }
+
+    bool readSingleMsg(std::vector<char>& msg) {
+        int msgSize;
+
+        if (!bufferedRead((char*)&msgSize, sizeof(msgSize)))
+            return false;
+
+        msgSize = (int)NetworkToHost((uint32_t)msgSize);
+
+        if (msgSize <= 0 || msgSize > MAX_MSG_LEN)
+            return false;
+
+        msg.resize(msgSize);
+        return bufferedRead(msg.data(), msgSize);
+    }
+
+private:
+    // The socket is readable while any of the stream is left.
+    bool processNonBlockingSelect() {
+        if (!m_source.isSocketOK())
+            return false;
+
+        onReceive();
+        return true;
+    }
+
+    void onReceive() {
+        compactBuffer();
+
+        int nOffset = (int)m_buf.size();
+
+        m_buf.resize(m_nMaxBufSize);
+
+        int nRes = m_source.receive(m_buf.data() + nOffset, m_buf.size() - nOffset);
+
+        if (nRes <= 0)
+            return;
+
+        m_buf.resize(nRes + nOffset);
+    }
+
+    size_t unreadSize() const {
+        return m_buf.size() - m_bufOffset;
+    }
+
+    void compactBuffer() {
+        if (m_bufOffset == 0)
+            return;
+
+        size_t nUnread = unreadSize();
+
+        if (nUnread > 0)
+            memmove(m_buf.data(), m_buf.data() + m_bufOffset, nUnread);
+
+        m_buf.resize(nUnread);
+        m_bufOffset = 0;
+    }
+
+    bool bufferedRead(char* buf, unsigned int size) {
+        while (size > 0) {
+            while (unreadSize() < size && unreadSize() < m_nMaxBufSize) {
+                if (!processNonBlockingSelect() && !m_source.isSocketOK())
+                    return false;
+            }
+
+            size_t nBytes = (std::min<size_t>)(unreadSize(), size);
+
+            memcpy(buf, m_buf.data() + m_bufOffset, nBytes);
+            m_bufOffset += nBytes;
+
+            if (m_bufOffset == m_buf.size()) {
+                m_buf.clear();
+                m_bufOffset = 0;
+            }
+
+            size -= nBytes;
+            buf += nBytes;
+        }
+
+        return true;
+    }
+
+    ReplaySource& m_source;
+    std::vector<char> m_buf;
+    size_t m_bufOffset = 0;
+    unsigned int m_nMaxBufSize;
+};
+
+
+struct ReplayResult {
+    double ms = 0;
+    size_t num_messages = 0;
+    uint64_t checksum = 0;
+};
+
+
+// ========================================================================================
+// Read every message of the stream and checksum the bodies.
+// ========================================================================================
+template <typename Reader>
+static ReplayResult Replay(const std::vector<char>& stream, const std::vector<size_t>& offsets,
+                           size_t burst_size, unsigned int max_buf_size) {
+    ReplaySource source(stream, offsets, burst_size);
+    Reader reader(source, max_buf_size);
+    std::vector<char> msg;
+    ReplayResult result;
+
+    auto start = std::chrono::steady_clock::now();
+    while (reader.readSingleMsg(msg)) {
+        result.num_messages++;
+        for (const auto& c : msg) result.checksum = result.checksum * 31 + (unsigned char)c;
+    }
+    auto finish = std::chrono::steady_clock::now();
+
+    result.ms = std::chrono::duration<double, std::milli>(finish - start).count();
+    return result;
+}
+
+
+int main(int argc, char* argv[]) {
+    std::string session_file;
+    int num_messages = 200000;
+    unsigned int max_buf_size = IN_BUF_SIZE_DEFAULT;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--session") == 0 && i + 1 < argc) {
+            session_file = argv[++i];
+        } else if (std::strcmp(argv[i], "--messages") == 0 && i + 1 < argc) {
+            num_messages = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--buffer") == 0 && i + 1 < argc) {
+            max_buf_size = (unsigned int)std::atoi(argv[++i]);
+        } else {
+            std::cerr << "Usage: ereader-replay-benchmark [--session FILE] [--messages N] [--buffer BYTES]\n";
+            return 1;
+        }
+    }
+
+    std::vector<char> stream;
+    std::vector<size_t> offsets;
+
+    if (!session_file.empty()) {
+        if (!LoadSession(session_file, stream, offsets)) return 1;
+    } else {
+        GenerateStream(num_messages, stream, offsets);
+    }
+
+    double megabytes = (double)stream.size() / (1024.0 * 1024.0);
+    std::printf("Replaying %zu messages, %.1f MB, read buffer %u bytes\n", offsets.size() - 1, megabytes, max_buf_size);
+    std::printf("%12s  %12s %10s  %12s %10s\n", "burst (msgs)", "previous ms", "MB/s", "current ms", "MB/s");
+
+    bool is_identical = true;
+    const size_t burst_sizes[] = { 1, 16, 256, 4096, 65536 };
+
+    for (const auto& burst_size : burst_sizes) {
+        ReplayResult previous = Replay<PreviousReader>(stream, offsets, burst_size, max_buf_size);
+        ReplayResult current = Replay<CurrentReader>(stream, offsets, burst_size, max_buf_size);
+
+        std::printf("%12zu  %12.1f %10.1f  %12.1f %10.1f\n", burst_size,
+            previous.ms, megabytes / (previous.ms / 1000.0), current.ms, megabytes / (current.ms / 1000.0));
+
+        if (previous.num_messages != offsets.size() - 1 || current.num_messages != previous.num_messages ||
+            current.checksum != previous.checksum) {
+            std::printf("MISMATCH at burst size %zu: previous read %zu messages, current read %zu\n",
+                burst_size, previous.num_messages, current.num_messages);
+            is_identical = false;
+        }
+    }
+
+    return is_identical ? 0 : 1;
+}
@@ -0,0 +1,849 @@
+/*
+
+MIT License
+
+Copyright(c) 2023-2025 Paul Squires
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+// Mock TWS server for load testing TradeTracker without a live TWS or IB Gateway.
+//
+// It listens on localhost, performs the V100+ socket handshake and answers the requests
+// that TradeTracker makes (positions, portfolio updates, account summary and market data)
+// with generated data. Every market data subscription receives a stream of LAST prices
+// (plus option computations for OPT/FOP contracts) at a fixed rate. Connect/subscribe
+// timings and the achieved message throughput are printed to the console.
+//
+// A session with a real TWS can be recorded by running in proxy mode (--upstream) and
+// later replayed to the client with its original timing (--replay).
+//
+// Wire format reminder: after the "API\0" prefix every message in both directions is a
+// 4 byte big endian length followed by null terminated text fields.
+//
+// Build with -DBUILD_MOCK_TWS_SERVER=ON. Connect TradeTracker with paper trading enabled
+// (port 7497) or pass --port 7496.
+
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <thread>
+#include <random>
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+using socket_t = SOCKET;
+static const socket_t INVALID_SOCKET_VALUE = INVALID_SOCKET;
+static void CloseSocket(socket_t s) { closesocket(s); }
+#else
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <signal.h>
+using socket_t = int;
+static const socket_t INVALID_SOCKET_VALUE = -1;
+static void CloseSocket(socket_t s) { close(s); }
+#endif
+
+
+using Clock = std::chrono::steady_clock;
+
+// Values from the TWS API (EDecoder.h / EClient.h).
+static const int SERVER_VERSION = 176;      // MAX_CLIENT_VER of the bundled API
+
+static const int MSG_TICK_PRICE = 1;
+static const int MSG_PORTFOLIO_VALUE = 7;
+static const int MSG_NEXT_VALID_ID = 9;
+static const int MSG_MANAGED_ACCTS = 15;
+static const int MSG_TICK_OPTION_COMPUTATION = 21;
+static const int MSG_ACCT_DOWNLOAD_END = 54;
+static const int MSG_POSITION_DATA = 61;
+static const int MSG_POSITION_END = 62;
+static const int MSG_ACCOUNT_SUMMARY = 63;
+static const int MSG_ACCOUNT_SUMMARY_END = 64;
+
+static const int REQ_MKT_DATA = 1;
+static const int CANCEL_MKT_DATA = 2;
+static const int REQ_ACCT_DATA = 6;
+static const int REQ_POSITIONS = 61;
+static const int REQ_ACCOUNT_SUMMARY = 62;
+static const int START_API = 71;
+
+static const int TICK_LAST = 4;
+static const int TICK_CLOSE = 9;
+static const int TICK_OPEN = 14;
+static const int TICK_MODEL_OPTION = 13;
+
+static const char* ACCOUNT_NAME = "DU0000001";
+
+// Magic at the start of a recorded session file. Each record that follows is a uint64
+// microsecond offset, a uint32 length and the message body (little endian).
+static const char RECORDING_MAGIC[8] = { 'T', 'T', 'W', 'I', 'R', 'E', '1', '\0' };
+
+
+struct Options {
+    int port = 7497;
+    int legs = 2000;                    // option positions served by reqPositions/reqAccountUpdates
+    int tick_rate = 50;                 // ticks per second per market data subscription
+    int portfolio_interval = 3000;      // milliseconds between portfolio update rounds (0 = once)
+    int duration = 0;                   // seconds to stream after connect (0 = until disconnect)
+    unsigned int seed = 1;
+    std::string replay_file;
+    double replay_speed = 1.0;          // 0 = as fast as possible
+    std::string upstream;               // host:port of a real TWS (proxy/record mode)
+    std::string record_file;
+};
+
+
+struct Position {
+    int conid = 0;
+    std::string symbol;
+    std::string expiry;
+    double strike = 0;
+    char right = 'P';
+    int quantity = 0;
+    double average_cost = 0;
+};
+
+
+struct Subscription {
+    int ticker_id = 0;
+    bool is_option = false;
+    double price = 0;
+    double delta = 0;
+};
+
+
+struct SessionStats {
+    Clock::time_point accepted;
+    Clock::time_point start_api;
+    Clock::time_point first_mkt_data;
+    Clock::time_point last_mkt_data;
+    uint64_t messages_sent = 0;
+    uint64_t bytes_sent = 0;
+    uint64_t requests_received = 0;
+};
+
+
+// Microseconds between two time points (0 if the later one has not happened).
+static long long ElapsedMicros(Clock::time_point from, Clock::time_point to) {
+    if (to.time_since_epoch().count() == 0) return 0;
+    return std::chrono::duration_cast<std::chrono::microseconds>(to - from).count();
+}
+
+
+// ========================================================================================
+// Outgoing message builder. Fields are appended as null terminated text and the length
+// prefix is filled in by Finish().
+// ========================================================================================
+class MessageBuilder {
+public:
+    MessageBuilder& Begin() {
+        start = buffer.size();
+        buffer.resize(start + 4);
+        return *this;
+    }
+
+    MessageBuilder& Field(std::string_view value) {
+        buffer.insert(buffer.end(), value.begin(), value.end());
+        buffer.push_back('\0');
+        return *this;
+    }
+
+    MessageBuilder& Field(int value) {
+        return Field(std::string_view(std::to_string(value)));
+    }
+
+    MessageBuilder& Field(double value) {
+        char text[32];
+        int len = snprintf(text, sizeof(text), "%.6g", value);
+        return Field(std::string_view(text, len));
+    }
+
+    void Finish() {
+        uint32_t len = (uint32_t)(buffer.size() - start - 4);
+        unsigned char* p = (unsigned char*)buffer.data() + start;
+        p[0] = (unsigned char)(len >> 24);
+        p[1] = (unsigned char)(len >> 16);
+        p[2] = (unsigned char)(len >> 8);
+        p[3] = (unsigned char)(len);
+        num_messages++;
+    }
+
+    std::vector<char> buffer;
+    size_t start = 0;
+    uint64_t num_messages = 0;
+};
+
+
+// ========================================================================================
+// Send the whole buffer (blocking). Returns false if the client has gone away.
+// ========================================================================================
+static bool SendAll(socket_t s, const char* data, size_t size) {
+    while (size > 0) {
+        int sent = send(s, data, (int)size, 0);
+        if (sent <= 0) return false;
+        data += sent;
+        size -= sent;
+    }
+    return true;
+}
+
+
+static bool Flush(socket_t s, MessageBuilder& out, SessionStats& stats) {
+    if (out.buffer.empty()) return true;
+    bool ok = SendAll(s, out.buffer.data(), out.buffer.size());
+    stats.messages_sent += out.num_messages;
+    stats.bytes_sent += out.buffer.size();
+    out.buffer.clear();
+    out.num_messages = 0;
+    return ok;
+}
+
+
+// ========================================================================================
+// Wait until the socket is readable or the timeout expires.
+// ========================================================================================
+static bool WaitReadable(socket_t s, int timeout_ms) {
+    fd_set read_set;
+    FD_ZERO(&read_set);
+    FD_SET(s, &read_set);
+    timeval tv{ timeout_ms / 1000, (timeout_ms % 1000) * 1000 };
+    return select((int)s + 1, &read_set, nullptr, nullptr, &tv) > 0;
+}
+
+
+// ========================================================================================
+// Incoming byte stream from the client, split into framed messages.
+// ========================================================================================
+class MessageReader {
+public:
+    // Read whatever is available. Returns false when the connection is closed.
+    bool Receive(socket_t s) {
+        char chunk[16384];
+        int received = recv(s, chunk, sizeof(chunk), 0);
+        if (received <= 0) return false;
+        buffer.insert(buffer.end(), chunk, chunk + received);
+        return true;
+    }
+
+    // Remove the "API\0" prefix sent before the first message.
+    bool TakePrefix() {
+        if (buffer.size() - offset < 4) return false;
+        if (memcmp(buffer.data() + offset, "API\0", 4) != 0) return false;
+        offset += 4;
+        return true;
+    }
+
+    // Next complete message split into fields, or false if one is not available yet.
+    bool Next(std::vector<std::string_view>& fields) {
+        if (buffer.size() - offset < 4) return false;
+        const unsigned char* p = (const unsigned char*)buffer.data() + offset;
+        size_t len = ((size_t)p[0] << 24) | ((size_t)p[1] << 16) | ((size_t)p[2] << 8) | p[3];
+        if (buffer.size() - offset - 4 < len) return false;
+
+        fields.clear();
+        const char* field = buffer.data() + offset + 4;
+        const char* end = field + len;
+        while (field < end) {
+            const char* null = (const char*)memchr(field, '\0', end - field);
+            if (!null) null = end;
+            fields.emplace_back(field, null - field);
+            field = null + 1;
+        }
+        offset += 4 + len;
+        return true;
+    }
+
+    // Drop the messages already handed out (keeps the string_views of the last batch valid
+    // until the next Receive).
+    void Compact() {
+        buffer.erase(buffer.begin(), buffer.begin() + offset);
+        offset = 0;
+    }
+
+private:
+    std::vector<char> buffer;
+    size_t offset = 0;
+};
+
+
+// ========================================================================================
+// Generate the option positions served to the client.
+// ========================================================================================
+static std::vector<Position> CreatePositions(const Options& opt, std::mt19937& rng) {
+    static const char* symbols[] = { "SPY", "QQQ", "IWM", "AAPL", "MSFT", "AMZN", "TSLA", "NVDA", "META", "GOOGL" };
+    static const char* expiries[] = { "20251121", "20251219", "20260116", "20260220", "20260320", "20260618" };
+
+    std::uniform_int_distribution<int> strike_offset(-40, 40);
+    std::uniform_int_distribution<int> quantity(1, 10);
+
+    std::vector<Position> positions;
+    positions.reserve(opt.legs);
+
+    for (int i = 0; i < opt.legs; ++i) {
+        Position p;
+        p.conid = 700000000 + i;
+        p.symbol = symbols[i % std::size(symbols)];
+        p.expiry = expiries[(i / std::size(symbols)) % std::size(expiries)];
+        p.strike = 100 + 5 * (20 + strike_offset(rng));
+        p.right = (i % 2) ? 'C' : 'P';
+        p.quantity = -quantity(rng);
+        p.average_cost = 50.0 + (i % 400);
+        positions.push_back(p);
+    }
+    return positions;
+}
+
+
+static void AppendPosition(MessageBuilder& out, const Position& p) {
+    out.Begin().Field(MSG_POSITION_DATA).Field(3).Field(ACCOUNT_NAME)
+        .Field(p.conid).Field(p.symbol).Field("OPT").Field(p.expiry).Field(p.strike)
+        .Field(std::string_view(&p.right, 1)).Field("100").Field("SMART").Field("USD")
+        .Field(p.symbol).Field(p.symbol)
+        .Field(p.quantity).Field(p.average_cost);
+    out.Finish();
+}
+
+
+static void AppendPortfolioValue(MessageBuilder& out, const Position& p, double market_price) {
+    double market_value = market_price * 100 * p.quantity;
+    out.Begin().Field(MSG_PORTFOLIO_VALUE).Field(8)
+        .Field(p.conid).Field(p.symbol).Field("OPT").Field(p.expiry).Field(p.strike)
+        .Field(std::string_view(&p.right, 1)).Field("100").Field("").Field("USD")
+        .Field(p.symbol).Field(p.symbol)
+        .Field(p.quantity).Field(market_price).Field(market_value).Field(p.average_cost)
+        .Field(market_value - p.average_cost * p.quantity).Field(0.0).Field(ACCOUNT_NAME);
+    out.Finish();
+}
+
+
+// ========================================================================================
+// Read the client hello ("API\0" + version range). Returns false if the client left.
+// ========================================================================================
+static bool ReadHandshake(socket_t client, MessageReader& reader, std::vector<std::string_view>& fields) {
+    bool has_prefix = false;
+    while (true) {
+        if (!has_prefix) has_prefix = reader.TakePrefix();
+        if (has_prefix && reader.Next(fields)) {
+            std::cout << "Client hello: " << (fields.empty() ? "" : std::string(fields[0])) << std::endl;
+            return true;
+        }
+        if (!WaitReadable(client, 1000)) continue;
+        if (!reader.Receive(client)) return false;
+    }
+}
+
+
+static void AppendConnectAck(MessageBuilder& out) {
+    out.Begin().Field(SERVER_VERSION).Field("20251017 09:30:00 America/New_York");
+    out.Finish();
+}
+
+
+// ========================================================================================
+// Serve one client with generated data until it disconnects or the duration expires.
+// ========================================================================================
+static void ServeGenerated(socket_t client, const Options& opt) {
+    SessionStats stats;
+    stats.accepted = Clock::now();
+
+    std::mt19937 rng(opt.seed);
+    std::vector<Position> positions = CreatePositions(opt, rng);
+    std::normal_distribution<double> walk(0.0, 0.02);
+
+    MessageReader reader;
+    MessageBuilder out;
+    std::vector<std::string_view> fields;
+
+    if (!ReadHandshake(client, reader, fields)) return;
+    AppendConnectAck(out);
+    if (!Flush(client, out, stats)) return;
+
+    std::vector<Subscription> subscriptions;
+    std::unordered_map<int, size_t> subscription_index;
+    bool is_portfolio_subscribed = false;
+
+    Clock::time_point last_pass = Clock::now();
+    Clock::time_point next_portfolio = last_pass;
+    Clock::time_point next_report = last_pass + std::chrono::seconds(1);
+    double ticks_due = 0;
+    uint64_t last_report_messages = 0;
+    size_t next_subscription = 0;
+
+    while (true) {
+        // Requests from the client.
+        while (WaitReadable(client, 0)) {
+            if (!reader.Receive(client)) {
+                std::cout << "Client disconnected" << std::endl;
+                goto finished;
+            }
+            while (reader.Next(fields)) {
+                if (fields.empty()) continue;
+                stats.requests_received++;
+                int msg_id = atoi(std::string(fields[0]).c_str());
+
+                switch (msg_id) {
+                case START_API:
+                    stats.start_api = Clock::now();
+                    out.Begin().Field(MSG_MANAGED_ACCTS).Field(1).Field(ACCOUNT_NAME);
+                    out.Finish();
+                    out.Begin().Field(MSG_NEXT_VALID_ID).Field(1).Field(1);
+                    out.Finish();
+                    break;
+
+                case REQ_POSITIONS:
+                    for (const auto& p : positions) AppendPosition(out, p);
+                    out.Begin().Field(MSG_POSITION_END).Field(1);
+                    out.Finish();
+                    break;
+
+                case REQ_ACCT_DATA:
+                    is_portfolio_subscribed = (fields.size() > 2 && fields[2] == "1");
+                    next_portfolio = Clock::now();
+                    break;
+
+                case REQ_ACCOUNT_SUMMARY: {
+                    int req_id = (fields.size() > 2) ? atoi(std::string(fields[2]).c_str()) : 0;
+                    const char* tags[] = { "NetLiquidation", "ExcessLiquidity", "MaintMarginReq" };
+                    const double values[] = { 250000.0, 180000.0, 45000.0 };
+                    for (size_t i = 0; i < std::size(tags); ++i) {
+                        out.Begin().Field(MSG_ACCOUNT_SUMMARY).Field(1).Field(req_id).Field(ACCOUNT_NAME)
+                            .Field(tags[i]).Field(values[i]).Field("USD");
+                        out.Finish();
+                    }
+                    out.Begin().Field(MSG_ACCOUNT_SUMMARY_END).Field(1).Field(req_id);
+                    out.Finish();
+                    break;
+                }
+
+                case REQ_MKT_DATA: {
+                    // 1, version, tickerId, conId, symbol, secType, ...
+                    if (fields.size() < 6) break;
+                    int ticker_id = atoi(std::string(fields[2]).c_str());
+                    if (subscription_index.count(ticker_id)) break;
+
+                    Clock::time_point now = Clock::now();
+                    if (subscriptions.empty()) stats.first_mkt_data = now;
+                    stats.last_mkt_data = now;
+
+                    Subscription sub;
+                    sub.ticker_id = ticker_id;
+                    sub.is_option = (fields[5] == "OPT" || fields[5] == "FOP");
+                    sub.price = sub.is_option ? 2.5 : 100.0 + (ticker_id % 400);
+                    sub.delta = sub.is_option ? 0.30 : 1.0;
+                    subscription_index[ticker_id] = subscriptions.size();
+                    subscriptions.push_back(sub);
+
+                    out.Begin().Field(MSG_TICK_PRICE).Field(6).Field(ticker_id).Field(TICK_CLOSE)
+                        .Field(sub.price).Field(0).Field(0);
+                    out.Finish();
+                    out.Begin().Field(MSG_TICK_PRICE).Field(6).Field(ticker_id).Field(TICK_OPEN)
+                        .Field(sub.price).Field(0).Field(0);
+                    out.Finish();
+                    break;
+                }
+
+                case CANCEL_MKT_DATA: {
+                    if (fields.size() < 3) break;
+                    auto it = subscription_index.find(atoi(std::string(fields[2]).c_str()));
+                    if (it == subscription_index.end()) break;
+                    size_t index = it->second;
+                    subscription_index.erase(it);
+                    if (index != subscriptions.size() - 1) {
+                        subscriptions[index] = subscriptions.back();
+                        subscription_index[subscriptions[index].ticker_id] = index;
+                    }
+                    subscriptions.pop_back();
+                    break;
+                }
+                }
+            }
+            reader.Compact();
+        }
+
+        Clock::time_point now = Clock::now();
+
+        // Periodic portfolio updates.
+        if (is_portfolio_subscribed && now >= next_portfolio) {
+            for (const auto& p : positions) AppendPortfolioValue(out, p, 2.5 + (p.conid % 100) * 0.05);
+            out.Begin().Field(MSG_ACCT_DOWNLOAD_END).Field(1).Field(ACCOUNT_NAME);
+            out.Finish();
+            if (opt.portfolio_interval > 0)
+                next_portfolio = now + std::chrono::milliseconds(opt.portfolio_interval);
+            else
+                is_portfolio_subscribed = false;
+        }
+
+        // Tick streams. The ticks due accumulate with the elapsed time so the rate stays
+        // exact regardless of how long each pass of the loop takes.
+        double elapsed = std::chrono::duration<double>(now - last_pass).count();
+        last_pass = now;
+
+        if (!subscriptions.empty() && opt.tick_rate > 0) {
+            ticks_due += elapsed * opt.tick_rate * subscriptions.size();
+
+            while (ticks_due >= 1) {
+                if (next_subscription >= subscriptions.size()) next_subscription = 0;
+                Subscription& sub = subscriptions[next_subscription++];
+
+                sub.price = std::max(0.01, sub.price + walk(rng));
+                out.Begin().Field(MSG_TICK_PRICE).Field(6).Field(sub.ticker_id).Field(TICK_LAST)
+                    .Field(sub.price).Field(1).Field(0);
+                out.Finish();
+
+                if (sub.is_option) {
+                    sub.delta = std::min(0.99, std::max(-0.99, sub.delta + walk(rng) * 0.1));
+                    out.Begin().Field(MSG_TICK_OPTION_COMPUTATION).Field(sub.ticker_id).Field(TICK_MODEL_OPTION)
+                        .Field(0).Field(0.25).Field(sub.delta).Field(sub.price).Field(0.0)
+                        .Field(0.01).Field(0.05).Field(-0.02).Field(100.0);
+                    out.Finish();
+                }
+                ticks_due -= 1;
+
+                if (out.buffer.size() > 256 * 1024 && !Flush(client, out, stats)) goto finished;
+            }
+        }
+
+        if (!Flush(client, out, stats)) {
+            std::cout << "Client disconnected" << std::endl;
+            break;
+        }
+
+        if (now >= next_report) {
+            std::cout << "subscriptions: " << subscriptions.size()
+                << "  messages/s: " << (stats.messages_sent - last_report_messages)
+                << "  total: " << stats.messages_sent << std::endl;
+            last_report_messages = stats.messages_sent;
+            next_report += std::chrono::seconds(1);
+        }
+
+        if (opt.duration > 0 && now - stats.accepted >= std::chrono::seconds(opt.duration)) {
+            std::cout << "Duration reached" << std::endl;
+            break;
+        }
+
+        // Sleep until the next tick is due (or a request arrives).
+        int wait_ms = (subscriptions.empty() || opt.tick_rate <= 0) ? 50 : 1;
+        WaitReadable(client, wait_ms);
+    }
+
+finished:
+    double seconds = std::chrono::duration<double>(Clock::now() - stats.accepted).count();
+    std::cout << "\nSession summary" << std::endl
+        << "  connect to startApi:        " << ElapsedMicros(stats.accepted, stats.start_api) << " us" << std::endl
+        << "  connect to first reqMktData: " << ElapsedMicros(stats.accepted, stats.first_mkt_data) << " us" << std::endl
+        << "  subscription burst:         " << ElapsedMicros(stats.first_mkt_data, stats.last_mkt_data) << " us ("
+        << subscriptions.size() << " active)" << std::endl
+        << "  requests received:          " << stats.requests_received << std::endl
+        << "  messages sent:              " << stats.messages_sent << " (" << (uint64_t)(stats.messages_sent / seconds) << "/s)" << std::endl
+        << "  bytes sent:                 " << stats.bytes_sent << std::endl;
+}
+
+
+// ========================================================================================
+// Replay a recorded session to the client with its original timing (scaled by speed).
+// Requests from the client are read and ignored.
+// ========================================================================================
+static void ServeReplay(socket_t client, const Options& opt) {
+    std::ifstream file(opt.replay_file, std::ios::binary);
+    char magic[8] = {};
+    if (!file.read(magic, sizeof(magic)) || memcmp(magic, RECORDING_MAGIC, sizeof(magic)) != 0) {
+        std::cout << "Not a recorded session file: " << opt.replay_file << std::endl;
+        return;
+    }
+
+    SessionStats stats;
+    stats.accepted = Clock::now();
+
+    MessageReader reader;
+    MessageBuilder out;
+    std::vector<std::string_view> fields;
+
+    if (!ReadHandshake(client, reader, fields)) return;
+
+    Clock::time_point start = Clock::now();
+    std::vector<char> body;
+    uint64_t offset_us = 0;
+    uint64_t start_offset_us = 0;
+    uint32_t len = 0;
+    bool is_first = true;
+
+    while (file.read((char*)&offset_us, sizeof(offset_us)) && file.read((char*)&len, sizeof(len))) {
+        body.resize(len);
+        if (!file.read(body.data(), len)) break;
+
+        if (is_first) {
+            // The first record is the connect ack. The client discards anything received
+            // along with it, so send it alone and wait for startApi before the rest.
+            out.Begin();
+            out.buffer.insert(out.buffer.end(), body.begin(), body.end());
+            out.Finish();
+            if (!Flush(client, out, stats)) return;
+
+            bool is_started = false;
+            while (!is_started) {
+                if (!WaitReadable(client, 5000) || !reader.Receive(client)) return;
+                while (reader.Next(fields)) {
+                    stats.requests_received++;
+                    if (!fields.empty() && fields[0] == std::to_string(START_API)) is_started = true;
+                }
+                reader.Compact();
+            }
+            is_first = false;
+            continue;
+        }
+
+        if (start_offset_us == 0) {
+            // Replay timing starts with the first message after the connect ack.
+            start_offset_us = offset_us;
+            start = Clock::now();
+        }
+
+        if (opt.replay_speed > 0) {
+            Clock::time_point due = start + std::chrono::microseconds((long long)((offset_us - start_offset_us) / opt.replay_speed));
+            if (due > Clock::now()) {
+                if (!Flush(client, out, stats)) break;
+                std::this_thread::sleep_until(due);
+            }
+        }
+
+        out.Begin();
+        out.buffer.insert(out.buffer.end(), body.begin(), body.end());
+        out.Finish();
+        if (out.buffer.size() > 256 * 1024 && !Flush(client, out, stats)) break;
+
+        while (WaitReadable(client, 0)) {
+            if (!reader.Receive(client)) goto finished;
+            while (reader.Next(fields)) stats.requests_received++;
+            reader.Compact();
+        }
+    }
+    Flush(client, out, stats);
+
+finished:
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << "Replay finished: " << stats.messages_sent << " messages in " << seconds << " s ("
+        << (uint64_t)(stats.messages_sent / std::max(seconds, 1e-9)) << "/s)" << std::endl;
+}
+
+
+// ========================================================================================
+// Forward a client to a real TWS and record every message TWS sends.
+// ========================================================================================
+static void ServeProxy(socket_t client, const Options& opt) {
+    std::string host = "127.0.0.1";
+    std::string port = opt.upstream;
+    size_t sep = opt.upstream.rfind(':');
+    if (sep != std::string::npos) {
+        host = opt.upstream.substr(0, sep);
+        port = opt.upstream.substr(sep + 1);
+    }
+
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &result) != 0 || !result) {
+        std::cout << "Could not resolve upstream " << opt.upstream << std::endl;
+        return;
+    }
+
+    socket_t upstream = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+    bool is_connected = (upstream != INVALID_SOCKET_VALUE &&
+        connect(upstream, result->ai_addr, (int)result->ai_addrlen) == 0);
+    freeaddrinfo(result);
+    if (!is_connected) {
+        std::cout << "Could not connect to upstream " << opt.upstream << std::endl;
+        if (upstream != INVALID_SOCKET_VALUE) CloseSocket(upstream);
+        return;
+    }
+
+    std::ofstream file;
+    if (!opt.record_file.empty()) {
+        file.open(opt.record_file, std::ios::binary | std::ios::trunc);
+        file.write(RECORDING_MAGIC, sizeof(RECORDING_MAGIC));
+    }
+
+    Clock::time_point start = Clock::now();
+    std::vector<char> pending;   // bytes from upstream not yet split into messages
+    uint64_t num_recorded = 0;
+    char chunk[16384];
+
+    while (true) {
+        fd_set read_set;
+        FD_ZERO(&read_set);
+        FD_SET(client, &read_set);
+        FD_SET(upstream, &read_set);
+        int max_fd = (int)std::max(client, upstream);
+        if (select(max_fd + 1, &read_set, nullptr, nullptr, nullptr) <= 0) break;
+
+        if (FD_ISSET(client, &read_set)) {
+            int received = recv(client, chunk, sizeof(chunk), 0);
+            if (received <= 0 || !SendAll(upstream, chunk, received)) break;
+        }
+
+        if (FD_ISSET(upstream, &read_set)) {
+            int received = recv(upstream, chunk, sizeof(chunk), 0);
+            if (received <= 0 || !SendAll(client, chunk, received)) break;
+
+            if (!file.is_open()) continue;
+            pending.insert(pending.end(), chunk, chunk + received);
+
+            uint64_t offset_us = (uint64_t)ElapsedMicros(start, Clock::now());
+            size_t pos = 0;
+            while (pending.size() - pos >= 4) {
+                const unsigned char* p = (const unsigned char*)pending.data() + pos;
+                uint32_t len = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+                if (pending.size() - pos - 4 < len) break;
+                file.write((const char*)&offset_us, sizeof(offset_us));
+                file.write((const char*)&len, sizeof(len));
+                file.write(pending.data() + pos + 4, len);
+                pos += 4 + len;
+                num_recorded++;
+            }
+            pending.erase(pending.begin(), pending.begin() + pos);
+        }
+    }
+
+    CloseSocket(upstream);
+    std::cout << "Proxy session ended. Messages recorded: " << num_recorded << std::endl;
+}
+
+
+static void PrintUsage() {
+    std::cout <<
+        "Usage: mock-tws-server [options]\n"
+        "  --port N                 listen port (default 7497)\n"
+        "  --legs N                 option positions to serve (default 2000)\n"
+        "  --tick-rate N            ticks per second per subscription (default 50)\n"
+        "  --portfolio-interval MS  milliseconds between portfolio updates, 0 = once (default 3000)\n"
+        "  --duration S             seconds to stream after connect, 0 = until disconnect\n"
+        "  --seed N                 random seed for the generated data (default 1)\n"
+        "  --replay FILE            replay a recorded session instead of generating data\n"
+        "  --speed X                replay speed multiplier, 0 = as fast as possible (default 1)\n"
+        "  --upstream HOST:PORT     proxy to a real TWS ...\n"
+        "  --record FILE            ... and record the messages it sends\n";
+}
+
+
+static bool ParseOptions(int argc, char* argv[], Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") return false;
+        if (i + 1 >= argc) {
+            std::cout << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--port") opt.port = atoi(value.c_str());
+        else if (arg == "--legs") opt.legs = atoi(value.c_str());
+        else if (arg == "--tick-rate") opt.tick_rate = atoi(value.c_str());
+        else if (arg == "--portfolio-interval") opt.portfolio_interval = atoi(value.c_str());
+        else if (arg == "--duration") opt.duration = atoi(value.c_str());
+        else if (arg == "--seed") opt.seed = (unsigned int)strtoul(value.c_str(), nullptr, 10);
+        else if (arg == "--replay") opt.replay_file = value;
+        else if (arg == "--speed") opt.replay_speed = atof(value.c_str());
+        else if (arg == "--upstream") opt.upstream = value;
+        else if (arg == "--record") opt.record_file = value;
+        else {
+            std::cout << "Unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    if (!ParseOptions(argc, argv, opt)) {
+        PrintUsage();
+        return 1;
+    }
+
+#if defined(_WIN32)
+    WSADATA wsa_data;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0) return 1;
+#else
+    signal(SIGPIPE, SIG_IGN);
+#endif
+
+    socket_t listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (listener == INVALID_SOCKET_VALUE) return 1;
+
+    int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons((unsigned short)opt.port);
+
+    if (bind(listener, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listener, 1) != 0) {
+        std::cout << "Could not listen on port " << opt.port << std::endl;
+        CloseSocket(listener);
+        return 1;
+    }
+
+    std::cout << "Mock TWS server listening on 127.0.0.1:" << opt.port << std::endl;
+
+    // One client at a time. TradeTracker reconnects after a disconnect so keep accepting.
+    while (true) {
+        socket_t client = accept(listener, nullptr, nullptr);
+        if (client == INVALID_SOCKET_VALUE) continue;
+
+        int no_delay = 1;
+        setsockopt(client, IPPROTO_TCP, TCP_NODELAY, (const char*)&no_delay, sizeof(no_delay));
+
+        std::cout << "Client connected" << std::endl;
+
+        if (!opt.upstream.empty()) {
+            ServeProxy(client, opt);
+        }
+        else if (!opt.replay_file.empty()) {
+            ServeReplay(client, opt);
+        }
+        else {
+            ServeGenerated(client, opt);
+        }
+
+        CloseSocket(client);
+    }
+
+    return 0;
+}
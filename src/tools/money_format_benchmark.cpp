@@ -0,0 +1,246 @@
+/*
+
+MIT License
+
+Copyright(c) 2023-2025 Paul Squires
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+// Benchmark and equivalence check for AfxFormatMoney / AfxMoney.
+//
+// The previous AfxMoney imbued an ostringstream with the en_US.UTF-8 or de_DE.UTF-8 locale
+// on every call. That implementation is kept here as the reference. Both American and
+// European formats are checked over a sweep of values (negatives, -0.00, rounding ties,
+// tiny and very large magnitudes, NaN and infinities) at precisions 0 to 4, and any output
+// that is not byte-identical is reported. The timing of both implementations follows.
+//
+// When a named locale is not installed an equivalent numpunct facet is used instead, and
+// the reference timing then excludes the cost of looking up the named locale.
+//
+// Build with -DBUILD_BENCHMARK_TOOLS=ON. The exit code is non-zero if any output differs.
+//
+// Usage: money-format-benchmark [--values N]
+
+#include <string>
+#include <vector>
+#include <locale>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <limits>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "appstate.h"
+#include "messagebox.h"
+#include "utilities.h"
+
+
+// ========================================================================================
+// Config and database code report errors through a message box. Print it instead.
+// ========================================================================================
+void CustomMessageBox(AppState&, const std::string& caption, const std::string& message) {
+    std::cerr << caption << ": " << message << "\n";
+}
+
+
+// ========================================================================================
+// Separators of the en_US and de_DE locales for systems where they are not installed.
+// ========================================================================================
+class MoneyNumpunct : public std::numpunct<char> {
+public:
+    MoneyNumpunct(char decimal_point, char thousands_sep)
+        : decimal_point(decimal_point), thousands_sep(thousands_sep) {}
+
+protected:
+    char do_decimal_point() const override { return decimal_point; }
+    char do_thousands_sep() const override { return thousands_sep; }
+    std::string do_grouping() const override { return "\3"; }
+
+private:
+    char decimal_point;
+    char thousands_sep;
+};
+
+
+struct ReferenceLocale {
+    NumberFormatType format;
+    const char* name;
+    bool is_installed = false;
+    std::locale locale;
+};
+
+
+// ========================================================================================
+// Build the locale that the previous AfxMoney imbued for the NumberFormatType.
+// ========================================================================================
+static std::locale MakeReferenceLocale(const ReferenceLocale& ref) {
+    if (ref.is_installed) return std::locale(ref.name);
+    if (ref.format == NumberFormatType::European) {
+        return std::locale(std::locale::classic(), new MoneyNumpunct(',', '.'));
+    }
+    return std::locale(std::locale::classic(), new MoneyNumpunct('.', ','));
+}
+
+
+// ========================================================================================
+// The previous AfxMoney implementation. A fresh locale is built for every call.
+// ========================================================================================
+static std::string ReferenceMoney(double value, int num_decimal_places, const ReferenceLocale& ref) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(num_decimal_places);
+    oss.imbue(MakeReferenceLocale(ref));
+    oss << value;
+    return oss.str();
+}
+
+
+// ========================================================================================
+// The previous formatting with an already constructed locale (used for the sweep).
+// ========================================================================================
+static std::string ReferenceMoneyPrebuilt(double value, int num_decimal_places, const std::locale& locale) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(num_decimal_places);
+    oss.imbue(locale);
+    oss << value;
+    return oss.str();
+}
+
+
+// ========================================================================================
+// Values that exercise signs, rounding, separators and the edges of the double range.
+// ========================================================================================
+static std::vector<double> SweepValues(int num_random_values) {
+    std::vector<double> values = {
+        0.0, 0.004, 0.005, 0.0049999, 0.05, 0.125, 0.5, 1.5, 2.5, 0.1, 0.7, 9.995, 99.995,
+        999.5, 999.9999, 1000.0, 12345.678, 99999.99999, 100000.0, 999999.995, 1234567.891,
+        123456789012.345, 1e15, 123456789012345678.0, 1e18, 1e22, 1e100,
+        std::numeric_limits<double>::min(),
+        std::numeric_limits<double>::denorm_min(),
+        std::numeric_limits<double>::max(),
+        std::numeric_limits<double>::infinity(),
+        std::numeric_limits<double>::quiet_NaN(),
+    };
+
+    // Every value is also checked negated, which includes -0.0 and values that round to -0.00
+    size_t num_fixed = values.size();
+    for (size_t i = 0; i < num_fixed; ++i) values.push_back(-values[i]);
+
+    std::mt19937_64 rng(1);
+    std::uniform_real_distribution<double> mantissa(1.0, 10.0);
+    std::uniform_int_distribution<int> exponent(-6, 18);
+    std::uniform_int_distribution<int> cents(-10000000, 10000000);
+
+    for (int i = 0; i < num_random_values; ++i) {
+        double value = (i % 2 == 0) ? mantissa(rng) * std::pow(10.0, exponent(rng)) : cents(rng) / 100.0;
+        values.push_back((i % 4 < 2) ? value : -value);
+    }
+
+    return values;
+}
+
+
+int main(int argc, char* argv[]) {
+    int num_random_values = 200000;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--values") == 0 && i + 1 < argc) {
+            num_random_values = std::atoi(argv[++i]);
+        } else {
+            std::cerr << "Usage: money-format-benchmark [--values N]\n";
+            return 1;
+        }
+    }
+
+    std::vector<ReferenceLocale> references = {
+        { NumberFormatType::American, "en_US.UTF-8", false, std::locale() },
+        { NumberFormatType::European, "de_DE.UTF-8", false, std::locale() },
+    };
+
+    for (auto& ref : references) {
+        try {
+            std::locale test(ref.name);
+            ref.is_installed = true;
+        } catch (const std::runtime_error&) {
+            ref.is_installed = false;
+            std::printf("Locale %s is not installed, using an equivalent numpunct facet\n", ref.name);
+        }
+        ref.locale = MakeReferenceLocale(ref);
+    }
+
+    // Equivalence sweep
+    std::vector<double> values = SweepValues(num_random_values);
+    size_t num_checked = 0;
+    size_t num_mismatches = 0;
+    char buffer[512];
+
+    for (const auto& ref : references) {
+        for (int precision = 0; precision <= 4; ++precision) {
+            for (const auto& value : values) {
+                std::string expected = ReferenceMoneyPrebuilt(value, precision, ref.locale);
+                size_t length = AfxFormatMoney(buffer, sizeof(buffer), value, precision, ref.format);
+                num_checked++;
+
+                if (expected != std::string_view(buffer, length)) {
+                    if (++num_mismatches <= 20) {
+                        std::printf("MISMATCH %s precision %d value %.17g: expected \"%s\" got \"%.*s\"\n",
+                            ref.name, precision, value, expected.c_str(), (int)length, buffer);
+                    }
+                }
+            }
+        }
+    }
+
+    std::printf("Checked %zu values: %zu mismatches\n", num_checked, num_mismatches);
+
+    // Timing. Money values as they appear in the lists, at 2 decimal places.
+    const int num_timed = 100000;
+    std::vector<double> timed_values(values.end() - std::min<size_t>(values.size(), num_timed), values.end());
+    AppState state;
+
+    for (const auto& ref : references) {
+        state.config.number_format_type = ref.format;
+        size_t total_length = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& value : timed_values) total_length += ReferenceMoney(value, 2, ref).size();
+        auto middle = std::chrono::steady_clock::now();
+        for (const auto& value : timed_values) total_length += AfxMoney(value, 2, state).size();
+        auto finish = std::chrono::steady_clock::now();
+        for (const auto& value : timed_values) total_length += AfxFormatMoney(buffer, sizeof(buffer), value, 2, ref.format);
+        auto finish_buffer = std::chrono::steady_clock::now();
+
+        double count = (double)timed_values.size();
+        std::printf("%s  previous AfxMoney: %8.1f ns/call  AfxMoney: %6.1f ns/call  AfxFormatMoney: %6.1f ns/call  (%zu chars)\n",
+            ref.name,
+            std::chrono::duration<double, std::nano>(middle - start).count() / count,
+            std::chrono::duration<double, std::nano>(finish - middle).count() / count,
+            std::chrono::duration<double, std::nano>(finish_buffer - finish).count() / count,
+            total_length);
+    }
+
+    return (num_mismatches == 0) ? 0 : 1;
+}
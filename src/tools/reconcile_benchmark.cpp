@@ -0,0 +1,501 @@
+/*
+
+MIT License
+
+Copyright(c) 2023-2025 Paul Squires
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+// Benchmark for position reconciliation (src/reconcile.cpp).
+//
+// Generates a set of open option and share positions, loads them as LOCAL positions from
+// a synthetic database and reports the same positions back through Reconcile_position as
+// TWS would (with some quantities changed, some positions missing and some extra). The
+// previous nested loop implementation, kept here as the reference, and the current hash
+// join implementation then each load, match and reconcile the positions. The time of each
+// step is printed, and the contract ids assigned to the legs and the report text of both
+// implementations must be identical.
+//
+// Build with -DBUILD_BENCHMARK_TOOLS=ON. The exit code is non-zero if the results differ.
+//
+// Usage: reconcile-benchmark [--positions N]
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "appstate.h"
+#include "messagebox.h"
+#include "utilities.h"
+#include "reconcile.h"
+
+extern std::vector<positionStruct> ibkr_positions;
+extern std::vector<positionStruct> local_positions;
+
+
+// ========================================================================================
+// Config and database code report errors through a message box. Print it instead.
+// ========================================================================================
+void CustomMessageBox(AppState&, const std::string& caption, const std::string& message) {
+    std::cerr << caption << ": " << message << "\n";
+}
+
+
+// ========================================================================================
+// The previous implementation: positions are compared field by field in nested loops.
+// ========================================================================================
+namespace previous {
+
+struct Position {
+    int contract_id = 0;
+    Contract contract;
+    std::vector<std::shared_ptr<Leg>> legs;
+    int open_quantity = 0;
+    std::string ticker_symbol;
+    std::string underlying;
+    std::string expiry_date;
+    double strike_price = 0;
+    std::string put_call;
+    std::shared_ptr<Trade> trade;
+    std::shared_ptr<Leg> leg;
+};
+
+std::vector<Position> ibkr_positions;
+std::vector<Position> local_positions;
+
+
+void LoadOneLocalPosition(AppState& state, const std::shared_ptr<Trade>& trade) {
+    for (const auto& leg : trade->open_legs) {
+        Position p{};
+        p.open_quantity = leg->open_quantity;
+        p.ticker_symbol = trade->ticker_symbol;
+        p.trade = trade;
+        p.leg = leg;
+
+        if (leg->underlying == Underlying::Futures) p.underlying = "FUT";
+        if (leg->underlying == Underlying::Options) p.underlying = "OPT";
+        if (leg->underlying == Underlying::Shares) p.underlying = "STK";
+
+        p.strike_price = leg->strike_price.ToDouble();
+        p.expiry_date = leg->expiry_date.ToCompactString();
+        p.put_call = state.db.PutCallToString(leg->put_call);
+
+        if (state.config.IsFuturesTicker(p.ticker_symbol)) {
+            p.ticker_symbol = trade->ticker_symbol.substr(1);
+            if (p.underlying == "OPT") p.underlying = "FOP";
+        }
+
+        bool found = false;
+        for (auto& local : local_positions) {
+            if (p.underlying == "OPT" ||
+                p.underlying == "FOP") {
+                if (p.strike_price == local.strike_price &&
+                    p.ticker_symbol == local.ticker_symbol &&
+                    p.expiry_date == local.expiry_date &&
+                    p.put_call == local.put_call) {
+                    found = true;
+                    local.open_quantity += p.open_quantity;
+                    local.legs.push_back(leg);
+                    break;
+                }
+            }
+            if (p.underlying == "STK" ||
+                p.underlying == "FUT") {
+                if (p.ticker_symbol == local.ticker_symbol &&
+                    p.underlying == local.underlying) {
+                    found = true;
+                    local.open_quantity += p.open_quantity;
+                    local.legs.push_back(leg);
+                    break;
+                }
+            }
+        }
+
+        if (found == false) {
+            p.legs.push_back(leg);
+            local_positions.push_back(p);
+        }
+    }
+}
+
+
+void LoadAllLocalPositions(AppState& state) {
+    local_positions.clear();
+    for (const auto& trade : state.db.trades) {
+        if (!trade->is_open) continue;
+        LoadOneLocalPosition(state, trade);
+    }
+}
+
+
+// The quantity is passed as an int. The Decimal conversion is the same for both versions.
+void position(const Contract& contract, int quantity) {
+    auto end = std::remove_if(ibkr_positions.begin(),
+        ibkr_positions.end(),
+        [contract](Position const& p) {
+            return (p.contract_id == contract.conId) ? true : false;
+        });
+    ibkr_positions.erase(end, ibkr_positions.end());
+
+    Position p{};
+    p.contract_id   = contract.conId;
+    p.contract      = contract;
+    p.open_quantity = quantity;
+    p.ticker_symbol = contract.symbol;
+    p.underlying    = contract.secType;
+    p.expiry_date   = contract.lastTradeDateOrContractMonth;
+    p.strike_price  = contract.strike;
+    p.put_call      = contract.right;
+    if (p.ticker_symbol == "HE" && p.underlying == "FOP") {
+        p.strike_price *= 100;
+    }
+    if (p.ticker_symbol == "LE" && p.underlying == "FOP") {
+        p.strike_price *= 100;
+    }
+    ibkr_positions.push_back(p);
+}
+
+
+bool ArePositionsEqual(Position ibkr, Position local) {
+    if (ibkr.underlying == "OPT" ||
+        ibkr.underlying == "FOP") {
+        if (ibkr.strike_price == local.strike_price &&
+            ibkr.open_quantity == local.open_quantity &&
+            ibkr.ticker_symbol == local.ticker_symbol &&
+            ibkr.expiry_date == local.expiry_date &&
+            ibkr.put_call == local.put_call &&
+            ibkr.underlying == local.underlying) {
+            return true;
+        }
+    }
+    if (ibkr.underlying == "STK" ||
+        ibkr.underlying == "FUT") {
+        if (ibkr.open_quantity == local.open_quantity &&
+            ibkr.ticker_symbol == local.ticker_symbol &&
+            ibkr.underlying == local.underlying) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+void doPositionMatching() {
+    for (const auto& ibkr : ibkr_positions) {
+        if (ibkr.open_quantity == 0) continue;
+        bool found = false;
+        for (auto& local : local_positions) {
+            if (local.contract_id == ibkr.contract_id) break;
+            found = ArePositionsEqual(ibkr, local);
+            if (found) {
+                local.contract_id = ibkr.contract_id;
+                for (auto& leg : local.legs) {
+                    leg->contract_id = ibkr.contract_id;
+                }
+                break;
+            }
+        }
+    }
+}
+
+
+std::string doReconciliation() {
+    std::string results;
+    std::string text;
+    std::string sp = "  ";
+
+    results = sp + "IBKR that do not exist in Local:\r\n";
+
+    for (const auto& ibkr : ibkr_positions) {
+        if (ibkr.open_quantity == 0) continue;
+        bool found = false;
+        for (auto& local : local_positions) {
+            found = ArePositionsEqual(ibkr, local);
+            if (found) break;
+        }
+        if (!found) {
+            text += sp +
+                AfxRSet(std::to_string(ibkr.open_quantity), 8) +
+                "  " +
+                AfxLSet(ibkr.ticker_symbol, 8) +
+                AfxLSet(ibkr.underlying, 5);
+            if (ibkr.underlying == "OPT" || ibkr.underlying == "FOP") {
+                text += sp +
+                    AfxLSet(AfxInsertDateHyphens(ibkr.expiry_date), 12) +
+                    AfxRSet(std::to_string(ibkr.strike_price), 16) +
+                    AfxRSet(ibkr.put_call, 3);
+            }
+            text += "\n";
+        }
+    }
+    if (text.length() == 0) text = sp + "** Everything matches correctly **";
+    results += text;
+
+    results += "\n\n";
+
+    results += sp + "Local that do not exist in IBKR:\n";
+    text = "";
+    for (const auto& local : local_positions) {
+        bool found = false;
+        for (const auto& ibkr : ibkr_positions) {
+            found = ArePositionsEqual(ibkr, local);
+            if (found == true) break;
+        }
+        if (!found) {
+            if (local.open_quantity != 0) {
+                text += sp +
+                    AfxRSet(std::to_string(local.open_quantity), 8) +
+                    "  " +
+                    AfxLSet(local.ticker_symbol, 8) +
+                    AfxLSet(local.underlying, 5);
+                if (local.underlying == "OPT" || local.underlying == "FOP") {
+                    text += sp +
+                        AfxLSet(AfxInsertDateHyphens(local.expiry_date), 12) +
+                        AfxRSet(std::to_string(local.strike_price), 16) +
+                        AfxRSet(local.put_call, 3);
+                }
+                text += "\n";
+            }
+        }
+    }
+    if (text.length() == 0) text = sp + "** Everything matches correctly **";
+    results += text;
+    return "\n" + results;
+}
+
+}   // namespace previous
+
+
+struct GeneratedPosition {
+    Contract contract;
+    int quantity = 0;
+};
+
+
+// ========================================================================================
+// Build the text database of the LOCAL positions and the matching IBKR positions.
+// Every 20th position is a share position, the rest are options. Every 7th option
+// position is split across two legs that LOCAL has to aggregate. Every 50th IBKR
+// quantity differs, every 50th LOCAL position is missing from IBKR and IBKR also holds
+// positions that do not exist in LOCAL.
+// ========================================================================================
+static void GeneratePositions(int num_positions, std::string& text, std::vector<GeneratedPosition>& ibkr) {
+    static const char* expiries[] = {
+        "20270115", "20270219", "20270319", "20270416", "20270521", "20270618", "20270716", "20270820"
+    };
+
+    text = "// TRADE          T|isOpen|nextleg_id|TickerSymbol|TickerName|FutureExpiry|Category|TradeBP|Notes|3dteWarning|21dteWarning|ProfitPercentage\n";
+    char line[256];
+
+    for (int i = 0; i < num_positions; ++i) {
+        bool is_shares = (i % 20 == 0);
+        int quantity = (i % 2 == 0) ? -(1 + i % 5) : (1 + i % 5);
+
+        char symbol[16];
+        std::snprintf(symbol, sizeof(symbol), is_shares ? "STK%d" : "SYM%d", is_shares ? i / 20 : i % 250);
+        const char* expiry = expiries[(i / 250) % 8];
+        double strike = 50.0 + (i / 2000) * 0.5;
+        const char* put_call = (i % 2 == 0) ? "P" : "C";
+
+        std::snprintf(line, sizeof(line), "T|1|3|%s|%s Inc||0|0||1|0|0.0000\n", symbol, symbol);
+        text += line;
+        std::snprintf(line, sizeof(line), "  X|20260105|Position %d|%d|1|1.0000|100.0000|0.0000|0.0000|0\n",
+            i, is_shares ? 1 : 0);
+        text += line;
+
+        if (is_shares) {
+            std::snprintf(line, sizeof(line), "    L|1|0|%d|%d||0|||1\n", quantity * 100, quantity * 100);
+            text += line;
+        } else if (i % 7 == 0 && quantity != 1 && quantity != -1) {
+            int first = quantity / 2;
+            std::snprintf(line, sizeof(line), "    L|1|0|%d|%d|%s|%.1f|%s|0|0\n", first, first, expiry, strike, put_call);
+            text += line;
+            std::snprintf(line, sizeof(line), "    L|2|0|%d|%d|%s|%.1f|%s|0|0\n",
+                quantity - first, quantity - first, expiry, strike, put_call);
+            text += line;
+        } else {
+            std::snprintf(line, sizeof(line), "    L|1|0|%d|%d|%s|%.1f|%s|0|0\n", quantity, quantity, expiry, strike, put_call);
+            text += line;
+        }
+
+        if (i % 50 == 2) continue;
+
+        GeneratedPosition p;
+        p.contract.conId = 100000 + i;
+        p.contract.symbol = symbol;
+        p.contract.secType = is_shares ? "STK" : "OPT";
+        if (!is_shares) {
+            p.contract.lastTradeDateOrContractMonth = expiry;
+            p.contract.strike = strike;
+            p.contract.right = put_call;
+        }
+        p.quantity = (is_shares ? quantity * 100 : quantity) + ((i % 50 == 1) ? 1 : 0);
+        ibkr.push_back(p);
+    }
+
+    for (int i = 0; i < num_positions / 50; ++i) {
+        GeneratedPosition p;
+        p.contract.conId = 900000 + i;
+        p.contract.symbol = "XTRA" + std::to_string(i);
+        p.contract.secType = "OPT";
+        p.contract.lastTradeDateOrContractMonth = expiries[i % 8];
+        p.contract.strike = 100.0 + i;
+        p.contract.right = "C";
+        p.quantity = 1;
+        ibkr.push_back(p);
+    }
+}
+
+
+static double ElapsedMs(std::chrono::steady_clock::time_point& start) {
+    auto now = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(now - start).count();
+    start = now;
+    return ms;
+}
+
+
+// ========================================================================================
+// Contract id assigned to every open leg, in database order.
+// ========================================================================================
+static std::vector<int> LegContractIds(AppState& state) {
+    std::vector<int> ids;
+    for (const auto& trade : state.db.trades) {
+        for (const auto& leg : trade->open_legs) ids.push_back(leg->contract_id);
+    }
+    return ids;
+}
+
+
+static void ClearLegContractIds(AppState& state) {
+    for (const auto& trade : state.db.trades) {
+        for (const auto& leg : trade->open_legs) leg->contract_id = 0;
+    }
+}
+
+
+int main(int argc, char* argv[]) {
+    int num_positions = 5000;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--positions") == 0 && i + 1 < argc) {
+            num_positions = std::atoi(argv[++i]);
+        } else {
+            std::cerr << "Usage: reconcile-benchmark [--positions N]\n";
+            return 1;
+        }
+    }
+
+    std::string text;
+    std::vector<GeneratedPosition> ibkr;
+    GeneratePositions(num_positions, text, ibkr);
+
+    std::filesystem::path folder = std::filesystem::temp_directory_path();
+    AppState state;
+    state.config.use_database_snapshot = false;
+    state.config.use_database_journal = false;
+    state.db.dbFilename = (folder / "tt-reconcile-benchmark.db").string();
+    state.db.dbJournal = (folder / "tt-reconcile-benchmark.journal").string();
+    std::filesystem::remove(state.db.dbJournal);
+
+    {
+        std::ofstream db(state.db.dbFilename, std::ios::out | std::ios::trunc | std::ios::binary);
+        db << text;
+    }
+    bool is_loaded = state.db.LoadDatabase(state);
+    std::filesystem::remove(state.db.dbFilename);
+    if (!is_loaded) return 1;
+
+    std::printf("%d LOCAL positions, %zu IBKR positions\n", num_positions, ibkr.size());
+    std::printf("%-10s %12s %12s %12s %12s\n", "", "load local", "positions", "matching", "reconcile");
+
+    // Previous implementation
+    auto start = std::chrono::steady_clock::now();
+    previous::LoadAllLocalPositions(state);
+    double previous_load_ms = ElapsedMs(start);
+    for (const auto& p : ibkr) previous::position(p.contract, p.quantity);
+    double previous_position_ms = ElapsedMs(start);
+    previous::doPositionMatching();
+    double previous_matching_ms = ElapsedMs(start);
+    std::string previous_text = previous::doReconciliation();
+    double previous_reconcile_ms = ElapsedMs(start);
+
+    std::printf("%-10s %12.1f %12.1f %12.1f %12.1f  ms\n", "previous",
+        previous_load_ms, previous_position_ms, previous_matching_ms, previous_reconcile_ms);
+
+    std::vector<int> previous_ids = LegContractIds(state);
+    ClearLegContractIds(state);
+
+    // Current implementation. The Decimal quantities are built before timing starts.
+    std::vector<Decimal> quantities;
+    for (const auto& p : ibkr) quantities.push_back(doubleToDecimal(p.quantity));
+
+    start = std::chrono::steady_clock::now();
+    Reconcile_LoadAllLocalPositions(state);
+    double current_load_ms = ElapsedMs(start);
+    for (size_t i = 0; i < ibkr.size(); ++i) Reconcile_position(ibkr[i].contract, quantities[i], 0);
+    double current_position_ms = ElapsedMs(start);
+    Reconcile_doPositionMatching();
+    double current_matching_ms = ElapsedMs(start);
+    Reconcile_doReconciliation(state);
+    double current_reconcile_ms = ElapsedMs(start);
+
+    std::printf("%-10s %12.1f %12.1f %12.1f %12.1f  ms\n", "current",
+        current_load_ms, current_position_ms, current_matching_ms, current_reconcile_ms);
+
+    std::vector<int> current_ids = LegContractIds(state);
+
+    size_t num_matched = 0;
+    for (const auto& id : current_ids) {
+        if (id != 0) num_matched++;
+    }
+
+    bool is_identical = true;
+    if (current_ids != previous_ids) {
+        std::printf("MISMATCH: the legs were assigned different contract ids\n");
+        is_identical = false;
+    }
+    if (state.reconciliation_results_text != previous_text) {
+        std::printf("MISMATCH: the reconciliation reports differ\n");
+        is_identical = false;
+    }
+
+    std::printf("%zu of %zu open legs matched, report %zu bytes, results %s\n", num_matched, current_ids.size(),
+        previous_text.size(), is_identical ? "identical" : "differ");
+
+    // The position vectors hold Legs allocated from model_arena. Release them now because
+    // the order in which globals of different files are destroyed is unspecified.
+    previous::ibkr_positions.clear();
+    previous::local_positions.clear();
+    ibkr_positions.clear();
+    local_positions.clear();
+
+    return is_identical ? 0 : 1;
+}
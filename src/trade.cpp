@@ -42,8 +42,9 @@ void Trade::CalculateTotalSharesProfit(AppState& state) {
             int quantity = abs(share.open_quantity);
             double price = share.trans->price;
 
-            if (state.config.IsFuturesTicker(ticker_symbol)) {
-                double multiplier = AfxValDouble(state.config.GetMultiplier(ticker_symbol));
+            const InstrumentInfo& info = state.config.GetInstrument(*this);
+            if (info.is_futures) {
+                double multiplier = info.multiplier;
                 price *= multiplier;
             }
 
@@ -57,6 +58,12 @@ void Trade::CalculateTotalSharesProfit(AppState& state) {
 }
 
 
+void Trade::SetTickerSymbol(std::string_view symbol) {
+    ticker_symbol = symbol;
+    symbol_id = symbol_table.Intern(ticker_symbol);
+}
+
+
 void Trade::SetTradeOpenStatus() {
     // default that the Trade is closed
     is_open = false;
@@ -101,7 +108,7 @@ void Trade::SetTradeOpenStatus() {
 
 #include <queue>
 
-void Trade::AddSharesHistory(std::shared_ptr<Transaction> trans, Action leg_action, int open_quantity, double average_cost) {
+void Trade::AddSharesHistory(const std::shared_ptr<Transaction>& trans, Action leg_action, int open_quantity, double average_cost) {
     SharesHistory shares{};
     shares.trans = trans;
     shares.leg_action = leg_action;
@@ -173,7 +180,7 @@ void Trade::FIFOCostACB(AppState& state) {
     this->acb_non_shares = 0;
 
     struct Shares {
-        std::string trans_date{};
+        Date trans_date{};
         int quantity_remaining{};
         double cost_per_share{};
     };
@@ -286,6 +293,53 @@ void Trade::CalculateAdjustedCostBase(AppState& state) {
 }
 
 
+// ========================================================================================
+// Determine the earliest and latest dates used for the BP ROI calculation. The database
+// loaders calculate these while parsing so this is only needed after a Trade is modified.
+// ========================================================================================
+void Trade::CalculateBuyingPowerDates() {
+    bp_start_date = Date();
+    bp_end_date = Date();
+    oldest_trade_trans_date = Date();
+
+    for (const auto& trans : transactions) {
+        Date trans_date = trans->trans_date;
+        if (trans_date.IsValid()) {
+            if (!bp_start_date.IsValid() || trans_date < bp_start_date) bp_start_date = trans_date;
+            if (trans_date > bp_end_date) bp_end_date = trans_date;
+            if (trans_date > oldest_trade_trans_date) oldest_trade_trans_date = trans_date;
+        }
+        for (const auto& leg : trans->legs) {
+            if (leg->expiry_date > bp_end_date) bp_end_date = leg->expiry_date;
+        }
+    }
+}
+
+
+// ========================================================================================
+// Calculate the values that are not stored in the database: the sorted open legs, the
+// BP end date of closed Trades, the ACB and the shares history.
+// ========================================================================================
+void Trade::CalculateDerivedValues(AppState& state) {
+    earliest_legs_DTE = 9999999;
+
+    if (is_open) {
+        CreateOpenLegsVector();
+    }
+    else {
+        // Trade is closed so set the BPendDate to be the oldest transaction in the Trade
+        open_legs.clear();
+        aggregate_shares = 0;
+        aggregate_futures = 0;
+        bp_end_date = oldest_trade_trans_date;
+    }
+
+    // Calculate the full trade ACB and also the Shares ACB depending on what costing
+    // method has been chosen.
+    CalculateAdjustedCostBase(state);
+}
+
+
 void Trade::CreateOpenLegsVector() {
     // Create the openLegs vector. We need this vector because we have to sort the
     // collection of open legs in order to have Puts before Calls. There could be
@@ -296,7 +350,7 @@ void Trade::CreateOpenLegsVector() {
     this->aggregate_shares = 0;
     this->aggregate_futures = 0;
 
-    std::string current_date = AfxCurrentDate();
+    Date current_date = Date::Today();
 
     for (const auto& trans : transactions) {
         if (trans->multiplier > 0) this->multiplier = trans->multiplier;
@@ -305,7 +359,6 @@ void Trade::CreateOpenLegsVector() {
         for (auto& leg : trans->legs) {
 
             if (leg->isOpen()) {
-                leg->trans = trans;
                 open_legs.push_back(leg);
 
                 switch (leg->underlying) {
@@ -313,7 +366,7 @@ void Trade::CreateOpenLegsVector() {
                     // Do check to calculate the DTE and compare to the earliest already calculated DTE
                     // for the Trade. We store the earliest DTE value because ActiveTrades uses it when
                     // sorted by Expiration.
-                    dte = AfxDaysBetween(current_date, leg->expiry_date);
+                    dte = current_date.DaysUntil(leg->expiry_date);
                     if (dte < this->earliest_legs_DTE) this->earliest_legs_DTE = dte;
                     break;
                 case Underlying::Shares:
@@ -336,10 +389,10 @@ void Trade::CreateOpenLegsVector() {
         [](const auto& leg1, const auto& leg2) {
             if (leg1->put_call == PutCall::Put && leg2->put_call == PutCall::Call) {return true;}
             if (leg1->put_call == PutCall::Put && leg2->put_call == PutCall::Put) {
-                if (AfxValDouble(leg1->strike_price) < AfxValDouble(leg2->strike_price)) return true;
+                if (leg1->strike_price < leg2->strike_price) return true;
             }
             if (leg1->put_call == PutCall::Call && leg2->put_call == PutCall::Call) {
-                if (AfxValDouble(leg1->strike_price) < AfxValDouble(leg2->strike_price)) return true;
+                if (leg1->strike_price < leg2->strike_price) return true;
             }
             return false;
         });
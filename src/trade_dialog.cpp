@@ -269,8 +269,11 @@ std::string LookupTickerName(AppState& state, std::string& ticker_symbol) {
     // Attempt to lookup the specified Ticker and fill in the corresponding ticker name.
     std::string ticker_name;
 
+    SymbolId symbol_id = symbol_table.Find(ticker_symbol);
+    if (symbol_id == SYMBOL_NONE) return ticker_name;
+
     auto iter = std::find_if(state.db.trades.begin(), state.db.trades.end(),
-        [&](const auto t) { return (t->ticker_symbol == ticker_symbol); });
+        [&](const auto& t) { return (t->symbol_id == symbol_id); });
 
     if (iter != state.db.trades.end()) {
         auto index = std::distance(state.db.trades.begin(), iter);
@@ -414,7 +414,7 @@ void InitializeCloseLegsDefaults(AppState& state, TradeDialogData& tdd, std::vec
     // Selected legs would have been loaded to state.activetrades_selected_legs
     // Filter the vector so that only OPTIONS legs remain.
     std::erase_if(state.activetrades_selected_legs, 
-        [](std::shared_ptr<Leg> leg) { 
+        [](const std::shared_ptr<Leg>& leg) { 
             return leg->underlying != Underlying::Options; 
         });
 
@@ -447,8 +447,8 @@ void InitializeCloseLegsDefaults(AppState& state, TradeDialogData& tdd, std::vec
 
         legdata.original_quantity = std::to_string(leg->original_quantity);
         legdata.quantity          = std::to_string(leg->open_quantity * -1);
-        legdata.expiry_date       = leg->expiry_date;
-        legdata.strike_price      = leg->strike_price;
+        legdata.expiry_date       = leg->expiry_date.ToString();
+        legdata.strike_price      = leg->strike_price.ToString();
         legdata.put_call          = state.db.PutCallToString(leg->put_call);
         legdata.action            = action;
 
@@ -464,7 +464,7 @@ void InitializeRollLegsDefaults(AppState& state, TradeDialogData& tdd, std::vect
     // Selected legs would have been loaded to state.activetrades_selected_legs
     // Filter the vector so that only OPTIONS legs remain.
     std::erase_if(state.activetrades_selected_legs, 
-        [](std::shared_ptr<Leg> leg) { 
+        [](const std::shared_ptr<Leg>& leg) { 
             return leg->underlying != Underlying::Options; 
         });
 
@@ -498,8 +498,8 @@ void InitializeRollLegsDefaults(AppState& state, TradeDialogData& tdd, std::vect
 
         legdata.original_quantity = std::to_string(leg->original_quantity);
         legdata.quantity          = std::to_string(leg->open_quantity * -1);
-        legdata.expiry_date       = leg->expiry_date;
-        legdata.strike_price      = leg->strike_price;
+        legdata.expiry_date       = leg->expiry_date.ToString();
+        legdata.strike_price      = leg->strike_price.ToString();
         legdata.put_call          = state.db.PutCallToString(leg->put_call);
         legdata.action            = action;
 
@@ -529,7 +529,7 @@ void InitializeEditTradeDefaults(AppState& state, TradeDialogData& tdd, std::vec
     tdd.ticker_symbol       = trade->ticker_symbol;
     tdd.ticker_name         = trade->ticker_name;
     tdd.futures_expiry_date = trade->future_expiry;
-    tdd.transaction_date    = trans->trans_date;
+    tdd.transaction_date    = trans->trans_date.ToString();
     tdd.description         = trans->description;
     tdd.short_long          = "";   // strategy. Not used in Edit.
     tdd.put_call            = "";   // strategy. Not used in Edit.
@@ -554,8 +554,8 @@ void InitializeEditTradeDefaults(AppState& state, TradeDialogData& tdd, std::vec
 
         legdata.original_quantity = std::to_string(leg->original_quantity / MAX(trans->quantity,1));
         legdata.quantity          = std::to_string(leg->open_quantity / MAX(trans->quantity,1));
-        legdata.expiry_date       = leg->expiry_date;
-        legdata.strike_price      = leg->strike_price;
+        legdata.expiry_date       = leg->expiry_date.ToString();
+        legdata.strike_price      = leg->strike_price.ToString();
         legdata.put_call          = state.db.PutCallToString(leg->put_call);
         legdata.action            = state.db.ActionToStringDescription(leg->action);
 
@@ -97,22 +97,24 @@ void CreateSharesFuturesTradeData(AppState& state, TradeDialogData& tdd, std::ve
     std::shared_ptr<Trade> trade;
 
     if (IsNewSharesFuturesTradeAction(state.trade_action)) {
-        trade = std::make_shared<Trade>();
+        trade = model_arena.NewTrade();
         state.db.trades.push_back(trade);
     }
     else {
         trade = state.trade_dialog_trade;
     }
 
-    trade->ticker_symbol = tdd.ticker_symbol;
+    state.db.SetTradeModified(trade);
+
+    trade->SetTickerSymbol(tdd.ticker_symbol);
     trade->ticker_name   = tdd.ticker_name;
     trade->future_expiry = tdd.futures_expiry_date;
     trade->category      = tdd.category;
     trade->trade_bp      = AfxValDouble(tdd.buying_power);
     trade->notes         = tdd.notes;
 
-    std::shared_ptr<Transaction> trans = std::make_shared<Transaction>();
-    trans->trans_date    = tdd.transaction_date;
+    std::shared_ptr<Transaction> trans = model_arena.NewTransaction();
+    trans->trans_date    = Date::FromString(tdd.transaction_date);
     trans->description   = tdd.description;
     trans->underlying    = SetTradeUnderlying(state);
     trans->quantity      = (int)tdd.quantity; 
@@ -125,7 +127,7 @@ void CreateSharesFuturesTradeData(AppState& state, TradeDialogData& tdd, std::ve
 
     trade->transactions.push_back(trans);
 
-    std::shared_ptr<Leg> leg = std::make_shared<Leg>();
+    std::shared_ptr<Leg> leg = model_arena.NewLeg();
     leg->underlying = trans->underlying;
 
     if (IsNewSharesFuturesTradeAction(state.trade_action) ||
@@ -135,14 +137,14 @@ void CreateSharesFuturesTradeData(AppState& state, TradeDialogData& tdd, std::ve
             trans->share_action == Action::BTC) {
             leg->original_quantity = trans->quantity;
             leg->open_quantity = trans->quantity;
-            leg->strike_price = std::to_string(trans->price);
+            leg->strike_price = FixedPrice::FromString(std::to_string(trans->price));
             leg->action = trans->share_action;
         }
         if (trans->share_action == Action::STO ||
             trans->share_action == Action::STC) {
             leg->original_quantity = trans->quantity * -1;
             leg->open_quantity = trans->quantity * -1;
-            leg->strike_price = std::to_string(trans->price);
+            leg->strike_price = FixedPrice::FromString(std::to_string(trans->price));
             leg->action = trans->share_action;
         }
     }
@@ -184,9 +186,9 @@ void CreateOtherIncomeExpenseData(AppState& state, TradeDialogData& tdd, std::ve
     std::shared_ptr<Trade> trade;
 
     if (IsOtherIncomeExpense(state.trade_action)) {
-        trade = std::make_shared<Trade>();
+        trade = model_arena.NewTrade();
         state.db.trades.push_back(trade);
-        trade->ticker_symbol = "OTHER";
+        trade->SetTickerSymbol("OTHER");
         trade->ticker_name = "Other Income/Expense";
         trade->is_open = false;
     }
@@ -194,13 +196,15 @@ void CreateOtherIncomeExpenseData(AppState& state, TradeDialogData& tdd, std::ve
         trade = state.trade_dialog_trade;
     }
 
+    state.db.SetTradeModified(trade);
+
     trade->category = CATEGORY_OTHER;
     trade->future_expiry = tdd.futures_expiry_date;
     trade->trade_bp = AfxValDouble(tdd.buying_power);
     trade->notes = tdd.notes;
 
-    std::shared_ptr<Transaction> trans = std::make_shared<Transaction>();
-    trans->trans_date = tdd.transaction_date;
+    std::shared_ptr<Transaction> trans = model_arena.NewTransaction();
+    trans->trans_date = Date::FromString(tdd.transaction_date);
     trans->description = tdd.description;
     trans->underlying = SetTradeUnderlying(state);
     trans->quantity = (int)tdd.quantity;
@@ -211,12 +215,12 @@ void CreateOtherIncomeExpenseData(AppState& state, TradeDialogData& tdd, std::ve
     if (tdd.dr_cr == "DR") { trans->total = trans->total * -1; }
     trade->transactions.push_back(trans);
 
-    std::shared_ptr<Leg> leg = std::make_shared<Leg>();
+    std::shared_ptr<Leg> leg = model_arena.NewLeg();
     leg->underlying = trans->underlying;
 
     leg->original_quantity = trans->quantity;
     leg->open_quantity = 0;
-    leg->strike_price = std::to_string(trans->total);
+    leg->strike_price = FixedPrice::FromString(std::to_string(trans->total));
     leg->action = Action::BTO;
 
     trans->legs.push_back(leg);
@@ -255,15 +259,16 @@ void CreateDividendTradeData(AppState& state, TradeDialogData& tdd, std::vector<
     // PROCEED TO SAVE THE TRADE DATA
 
     std::shared_ptr<Trade> trade = state.trade_dialog_trade;
+    state.db.SetTradeModified(trade);
 
-    trade->ticker_symbol = tdd.ticker_symbol;
+    trade->SetTickerSymbol(tdd.ticker_symbol);
     trade->ticker_name = tdd.ticker_name;
     trade->future_expiry = tdd.futures_expiry_date;
     trade->category = tdd.category;
     trade->trade_bp = AfxValDouble(tdd.buying_power);
 
-    std::shared_ptr<Transaction> trans = std::make_shared<Transaction>();
-    trans->trans_date = tdd.transaction_date;
+    std::shared_ptr<Transaction> trans = model_arena.NewTransaction();
+    trans->trans_date = Date::FromString(tdd.transaction_date);
     trans->description = tdd.description;
     trans->underlying = SetTradeUnderlying(state);
     trans->quantity = (int)tdd.quantity;
@@ -274,12 +279,12 @@ void CreateDividendTradeData(AppState& state, TradeDialogData& tdd, std::vector<
     if (tdd.dr_cr == "DR") { trans->total = trans->total * -1; }
     trade->transactions.push_back(trans);
 
-    std::shared_ptr<Leg> leg = std::make_shared<Leg>();
+    std::shared_ptr<Leg> leg = model_arena.NewLeg();
     leg->underlying = trans->underlying;
 
     leg->original_quantity = trans->quantity;
     leg->open_quantity = 0;
-    leg->strike_price = std::to_string(trans->total);
+    leg->strike_price = FixedPrice::FromString(std::to_string(trans->total));
     leg->action = Action::BTO;
 
     trans->legs.push_back(leg);
@@ -384,14 +389,16 @@ void CreateOptionsTradeData(AppState& state, TradeDialogData& tdd, std::vector<T
     std::shared_ptr<Trade> trade;
 
     if (IsNewOptionsTradeAction(state.trade_action)) {
-        trade = std::make_shared<Trade>();
+        trade = model_arena.NewTrade();
         state.db.trades.push_back(trade);
     }
     else {
         trade = state.trade_dialog_trade;
     }
 
-    trade->ticker_symbol = RemovePipeChar(tdd.ticker_symbol);
+    state.db.SetTradeModified(trade);
+
+    trade->SetTickerSymbol(RemovePipeChar(tdd.ticker_symbol));
     trade->ticker_name   = RemovePipeChar(tdd.ticker_name);
     trade->future_expiry = tdd.futures_expiry_date;
     trade->category      = tdd.category;
@@ -400,8 +407,8 @@ void CreateOptionsTradeData(AppState& state, TradeDialogData& tdd, std::vector<T
     trade->warning_3_dte = tdd.warning_3_dte;
     trade->warning_21_dte = tdd.warning_21_dte;
 
-    std::shared_ptr<Transaction> trans = std::make_shared<Transaction>();
-    trans->trans_date    = tdd.transaction_date;
+    std::shared_ptr<Transaction> trans = model_arena.NewTransaction();
+    trans->trans_date    = Date::FromString(tdd.transaction_date);
     trans->description   = RemovePipeChar(tdd.description);
     trans->underlying    = SetTradeUnderlying(state);
     
@@ -419,19 +426,17 @@ void CreateOptionsTradeData(AppState& state, TradeDialogData& tdd, std::vector<T
         int intQuantity = AfxValInteger(tgd.at(row).original_quantity) * trans->quantity;
         if (intQuantity == 0) continue;
         
-        std::shared_ptr<Leg> leg = std::make_shared<Leg>();
+        std::shared_ptr<Leg> leg = model_arena.NewLeg();
 
         trade->nextleg_id += 1;
         leg->leg_id       = trade->nextleg_id;
         leg->underlying   = trans->underlying;
-        leg->expiry_date  = tgd.at(row).expiry_date;
-        leg->strike_price = tgd.at(row).strike_price;
+        leg->expiry_date  = Date::FromString(tgd.at(row).expiry_date);
+        leg->strike_price = FixedPrice::FromString(tgd.at(row).strike_price);
         leg->put_call     = state.db.StringToPutCall(tgd.at(row).put_call);
         leg->action       = state.db.StringDescriptionToAction(tgd.at(row).action);
-        leg->trans        = trans;
 
-        std::string expiry_date = AfxRemoveDateHyphens(leg->expiry_date);
-        if (AfxValDouble(expiry_date) > AfxValDouble(trade->bp_end_date)) trade->bp_end_date = expiry_date;
+        if (leg->expiry_date > trade->bp_end_date) trade->bp_end_date = leg->expiry_date;
 
         switch (state.trade_action) {
         case TradeAction::new_options_trade:
@@ -479,19 +484,17 @@ void CreateOptionsTradeData(AppState& state, TradeDialogData& tdd, std::vector<T
             int intQuantity = AfxValInteger(tgd.at(row).quantity);
             if (intQuantity == 0) continue;
 
-            std::shared_ptr<Leg> leg = std::make_shared<Leg>();
+            std::shared_ptr<Leg> leg = model_arena.NewLeg();
 
             trade->nextleg_id += 1;
             leg->leg_id       = trade->nextleg_id;
             leg->underlying   = Underlying::Options;
-            leg->expiry_date  = tgd.at(row).expiry_date;
-            leg->strike_price = tgd.at(row).strike_price;
+            leg->expiry_date  = Date::FromString(tgd.at(row).expiry_date);
+            leg->strike_price = FixedPrice::FromString(tgd.at(row).strike_price);
             leg->put_call     = state.db.StringToPutCall(tgd.at(row).put_call);
             leg->action       = state.db.StringDescriptionToAction(tgd.at(row).action);
-            leg->trans        = trans;
 
-            std::string expiry_date = AfxRemoveDateHyphens(leg->expiry_date);
-            if (AfxValDouble(expiry_date) > AfxValDouble(trade->bp_end_date)) trade->bp_end_date = expiry_date;
+            if (leg->expiry_date > trade->bp_end_date) trade->bp_end_date = leg->expiry_date;
 
             leg->original_quantity = intQuantity;
             leg->open_quantity = intQuantity;
@@ -563,6 +566,7 @@ void CreateEditTradeData(AppState& state, TradeDialogData& tdd, std::vector<Trad
 
     std::shared_ptr<Trade> trade = state.trans_edit_trade;
     std::shared_ptr<Transaction> trans = state.trans_edit_transaction;
+    state.db.SetTradeModified(trade);
 
     trade->future_expiry  = tdd.futures_expiry_date;
     trade->category       = tdd.category;
@@ -570,7 +574,7 @@ void CreateEditTradeData(AppState& state, TradeDialogData& tdd, std::vector<Trad
     trade->warning_3_dte  = tdd.warning_3_dte;
     trade->warning_21_dte = tdd.warning_21_dte;
     
-    trans->trans_date  = tdd.transaction_date;
+    trans->trans_date  = Date::FromString(tdd.transaction_date);
     trans->description = tdd.description;
     trans->quantity    = (int)tdd.quantity;
     trans->price       = tdd.price;
@@ -588,14 +592,14 @@ void CreateEditTradeData(AppState& state, TradeDialogData& tdd, std::vector<Trad
             trans->share_action == Action::BTC) {
             trans->legs.at(0)->original_quantity = trans->quantity;
             trans->legs.at(0)->open_quantity = trans->quantity;
-            trans->legs.at(0)->strike_price = std::to_string(tdd.price);
+            trans->legs.at(0)->strike_price = FixedPrice::FromString(std::to_string(tdd.price));
             trans->legs.at(0)->action = tdd.share_action;
         }
         if (trans->share_action == Action::STO ||
             trans->share_action == Action::STC) {
             trans->legs.at(0)->original_quantity = trans->quantity * -1;
             trans->legs.at(0)->open_quantity = trans->quantity * -1;
-            trans->legs.at(0)->strike_price = std::to_string(tdd.price);
+            trans->legs.at(0)->strike_price = FixedPrice::FromString(std::to_string(tdd.price));
             trans->legs.at(0)->action = tdd.share_action;
         }
     }
@@ -636,7 +640,7 @@ void CreateEditTradeData(AppState& state, TradeDialogData& tdd, std::vector<Trad
                 leg = trans->legs.at(row);
             }
             else {
-                leg = std::make_shared<Leg>();
+                leg = model_arena.NewLeg();
                 trade->nextleg_id += 1;
                 leg->leg_id = trade->nextleg_id;
             }
@@ -645,13 +649,12 @@ void CreateEditTradeData(AppState& state, TradeDialogData& tdd, std::vector<Trad
             leg->open_quantity = int_open_quantity * trans->quantity;
 
             leg->underlying = trans->underlying;
-            leg->expiry_date = leg_expiry;
-            leg->strike_price = leg_strike;
+            leg->expiry_date = Date::FromString(leg_expiry);
+            leg->strike_price = FixedPrice::FromString(leg_strike);
             leg->put_call = leg_PutCall;
             leg->action = leg_action;
 
-            std::string expiry_date = AfxRemoveDateHyphens(leg_expiry);
-            if (AfxValDouble(expiry_date) > AfxValDouble(trade->bp_end_date)) trade->bp_end_date = expiry_date;
+            if (leg->expiry_date > trade->bp_end_date) trade->bp_end_date = leg->expiry_date;
 
             if (row >= (int)trans->legs.size()) {
                 trans->legs.push_back(leg);
@@ -668,6 +671,6 @@ void CreateEditTradeData(AppState& state, TradeDialogData& tdd, std::vector<Trad
 
 void SaveTradeData(AppState& state, TradeDialogData& tdd) {
     state.trade_dialog_trade->SetTradeOpenStatus();
-    ReloadAppState(state);
+    RefreshAppState(state);
 }
 
@@ -17,6 +17,7 @@ void SaveTradeHistoryNotes(AppState& state) {
     if (state.tradehistory_notes_modified) {
         state.tradehistory_trade->notes = state.tradehistory_notes;
         state.tradehistory_notes_modified = false;
+        state.db.SetTradeModified(state.tradehistory_trade);
         state.db.SaveDatabase(state);
     }
 }
@@ -39,7 +40,7 @@ void LoadTradeHistory(AppState& state, std::vector<CListPanelData>& vec, std::sh
     if (!trade) return;
 
     std::string ticker = trade->ticker_symbol + ": " + trade->ticker_name;
-    if (state.config.IsFuturesTicker(trade->ticker_symbol)) ticker += " (" + AfxFormatFuturesDate(trade->future_expiry) + ")";
+    if (state.config.GetInstrument(*trade).is_futures) ticker += " (" + AfxFormatFuturesDate(trade->future_expiry) + ")";
 
     state.tradehistory_ticker = ticker;
     state.tradehistory_notes = trade->notes;
@@ -62,7 +63,7 @@ void LoadTradeHistory(AppState& state, std::vector<CListPanelData>& vec, std::sh
     for (const auto& share : trade->shares_history) {
         HistoryItem item;
         item.trans_orig = share.trans;
-        item.trans = std::make_shared<Transaction>();
+        item.trans = model_arena.NewTransaction();
         item.trans->underlying = share.trans->underlying;
         item.trans->description = share.trans->description;
         item.trans->trans_date = share.trans->trans_date;
@@ -74,7 +75,7 @@ void LoadTradeHistory(AppState& state, std::vector<CListPanelData>& vec, std::sh
         item.trans->share_average_cost = share.average_cost;
         item.trans->share_action = share.trans->share_action;
 
-        std::shared_ptr<Leg> leg = std::make_shared<Leg>();
+        std::shared_ptr<Leg> leg = model_arena.NewLeg();
         leg->action = share.leg_action;
         leg->open_quantity = share.open_quantity;
         leg->underlying = item.trans->underlying;
@@ -89,7 +90,7 @@ void LoadTradeHistory(AppState& state, std::vector<CListPanelData>& vec, std::sh
             trans->underlying != Underlying::Futures) {
             HistoryItem item;
             item.trans_orig = trans;
-            item.trans = std::make_shared<Transaction>();
+            item.trans = model_arena.NewTransaction();
             item.trans = trans;
             trade_history.push_back(item);
         }
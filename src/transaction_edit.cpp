@@ -36,7 +36,7 @@ SOFTWARE.
 #include <iostream>
 
 
-std::shared_ptr<Leg> GetLegBackPointer(std::shared_ptr<Trade> trade, int back_pointer_id) {
+std::shared_ptr<Leg> GetLegBackPointer(const std::shared_ptr<Trade>& trade, int back_pointer_id) {
     if (back_pointer_id == 0) return nullptr;
     for (auto& trans : trade->transactions) {
         for (auto& leg : trans->legs) {
@@ -91,15 +91,17 @@ void DeleteTransaction(AppState& state) {
     if (trade->transactions.size() == 0) {
         auto it = std::find(state.db.trades.begin(), state.db.trades.end(), trade);
         if (it != state.db.trades.end()) state.db.trades.erase(it);
+        state.db.SetTradeDeleted(trade);
     }
     else {
         // Calculate the Trade open status because we may have just deleted the
         // transaction that sets the trades open_quantity to zero.
         trade->SetTradeOpenStatus();
+        state.db.SetTradeModified(trade);
     }
 
-    // Save/Load the modified data
-    ReloadAppState(state);
+    // Save the modified data and recalculate the modified Trade
+    RefreshAppState(state);
 }
 
 
@@ -118,7 +120,7 @@ std::string TransEditTransPrice(AppState& state, std::shared_ptr<Trade> trade, s
     std::string plus_minus = (trans->total < 0) ? " + " : " - ";
     std::string text;
     text = std::to_string(trans->quantity) + " @ " +
-                AfxMoney(trans->price, state.config.GetTickerDecimals(trade->ticker_symbol), state) + plus_minus +
+                AfxMoney(trans->price, state.config.GetInstrument(*trade).ticker_decimals, state) + plus_minus +
                 AfxMoney(trans->fees, 2, state) + " = " +
                 AfxMoney(std::abs(trans->total), 2, state) + dr_cr;
     return text;
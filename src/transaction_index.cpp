@@ -0,0 +1,215 @@
+/*
+
+MIT License
+
+Copyright(c) 2023-2025 Paul Squires
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <algorithm>
+#include <numeric>
+
+#include "appstate.h"
+#include "transaction_index.h"
+
+
+// ========================================================================================
+// Remove all rows from the index.
+// ========================================================================================
+void CTransactionIndex::Clear() {
+    trans_date.clear();
+    symbol_id.clear();
+    category.clear();
+    underlying.clear();
+    quantity.clear();
+    price.clear();
+    fees.clear();
+    total.clear();
+    row_trade.clear();
+    transactions.clear();
+
+    trades.clear();
+    first_row.clear();
+    latest_trans_date.clear();
+    trade_symbol_id.clear();
+    trade_category.clear();
+
+    row_order = DateOrder();
+    trade_order = DateOrder();
+}
+
+
+// ========================================================================================
+// Rebuild the columns from the Trades and their Transactions.
+// ========================================================================================
+void CTransactionIndex::Build(const std::vector<std::shared_ptr<Trade>>& source) {
+    Clear();
+
+    size_t row_count = 0;
+    for (const auto& trade : source) {
+        row_count += trade->transactions.size();
+    }
+
+    trans_date.reserve(row_count);
+    symbol_id.reserve(row_count);
+    category.reserve(row_count);
+    underlying.reserve(row_count);
+    quantity.reserve(row_count);
+    price.reserve(row_count);
+    fees.reserve(row_count);
+    total.reserve(row_count);
+    row_trade.reserve(row_count);
+    transactions.reserve(row_count);
+
+    trades.reserve(source.size());
+    first_row.reserve(source.size() + 1);
+    latest_trans_date.reserve(source.size());
+    trade_symbol_id.reserve(source.size());
+    trade_category.reserve(source.size());
+
+    for (const auto& trade : source) {
+        uint32_t trade_row = (uint32_t)trades.size();
+        int32_t latest_date = Date::NONE;
+
+        trades.push_back(trade);
+        first_row.push_back((uint32_t)trans_date.size());
+
+        for (const auto& trans : trade->transactions) {
+            int32_t date = trans->trans_date.DaysSinceEpoch();
+            if (date > latest_date) latest_date = date;
+
+            trans_date.push_back(date);
+            symbol_id.push_back(trade->symbol_id);
+            category.push_back(trade->category);
+            underlying.push_back((uint8_t)trans->underlying);
+            quantity.push_back(trans->quantity);
+            price.push_back(trans->price);
+            fees.push_back(trans->fees);
+            total.push_back(trans->total);
+            row_trade.push_back(trade_row);
+            transactions.push_back(trans);
+        }
+
+        latest_trans_date.push_back(latest_date);
+        trade_symbol_id.push_back(trade->symbol_id);
+        trade_category.push_back(trade->category);
+    }
+
+    first_row.push_back((uint32_t)trans_date.size());
+
+    BuildDateOrder(row_order, trans_date, symbol_id, category);
+    BuildDateOrder(trade_order, latest_trans_date, trade_symbol_id, trade_category);
+}
+
+
+// ========================================================================================
+// Sort the row (or Trade) numbers by date and split them into per ticker and per
+// category lists. The lists are filled in date order so they are sorted as well.
+// ========================================================================================
+void CTransactionIndex::BuildDateOrder(DateOrder& order, const std::vector<int32_t>& dates,
+            const std::vector<SymbolId>& symbols, const std::vector<int32_t>& categories) {
+    order.all.resize(dates.size());
+    std::iota(order.all.begin(), order.all.end(), 0);
+    std::stable_sort(order.all.begin(), order.all.end(),
+        [&dates](uint32_t a, uint32_t b) { return dates[a] < dates[b]; });
+
+    for (uint32_t n : order.all) {
+        order.by_symbol[symbols[n]].push_back(n);
+        order.by_category[categories[n]].push_back(n);
+    }
+}
+
+
+// ========================================================================================
+// Copy the numbers dated from start to end (inclusive) out of the narrowest list that
+// the filter allows. Only a filter on both ticker and category needs a further check.
+// ========================================================================================
+void CTransactionIndex::SelectDateRange(const DateOrder& order, const std::vector<int32_t>& dates,
+            const std::vector<int32_t>& categories, const TransactionFilter& filter,
+            int32_t start, int32_t end, std::vector<uint32_t>& out) {
+    out.clear();
+
+    const std::vector<uint32_t>* list = &order.all;
+    bool is_category_checked = false;
+
+    if (filter.is_symbol_filtered) {
+        auto it = order.by_symbol.find(filter.symbol_id);
+        if (it == order.by_symbol.end()) return;
+        list = &it->second;
+        is_category_checked = filter.is_category_filtered;
+    }
+    else if (filter.is_category_filtered) {
+        auto it = order.by_category.find(filter.category);
+        if (it == order.by_category.end()) return;
+        list = &it->second;
+    }
+
+    auto first = std::lower_bound(list->begin(), list->end(), start,
+        [&dates](uint32_t n, int32_t date) { return dates[n] < date; });
+    auto last = std::upper_bound(first, list->end(), end,
+        [&dates](int32_t date, uint32_t n) { return date < dates[n]; });
+
+    if (!is_category_checked) {
+        out.assign(first, last);
+        return;
+    }
+
+    out.reserve(last - first);
+    for (auto it = first; it != last; ++it) {
+        if (categories[*it] == filter.category) out.push_back(*it);
+    }
+}
+
+
+// ========================================================================================
+// Return the rows that fall within the filter's date range, ticker and category. The
+// rows are returned in date order.
+// ========================================================================================
+void CTransactionIndex::Select(const TransactionFilter& filter, std::vector<uint32_t>& rows) const {
+    SelectDateRange(row_order, trans_date, category, filter,
+        filter.start_date.DaysSinceEpoch(), filter.end_date.DaysSinceEpoch(), rows);
+}
+
+
+// ========================================================================================
+// Return the Trades that match the filter's ticker and category and that have no
+// Transaction after the filter's end date. The start date is not applied because the
+// Closed Trades panel still counts earlier closes in its year to date totals.
+// ========================================================================================
+void CTransactionIndex::SelectTrades(const TransactionFilter& filter, std::vector<uint32_t>& trade_rows) const {
+    SelectDateRange(trade_order, latest_trans_date, trade_category, filter,
+        Date::NONE, filter.end_date.DaysSinceEpoch(), trade_rows);
+}
+
+
+// ========================================================================================
+// Add up the gross, fees and net amounts of the rows.
+// ========================================================================================
+TransactionTotals CTransactionIndex::Sum(const std::vector<uint32_t>& rows) const {
+    TransactionTotals totals;
+
+    for (uint32_t row : rows) {
+        totals.net += total[row];
+        totals.fees += fees[row];
+        totals.gross += (total[row] + fees[row]);
+    }
+    return totals;
+}
@@ -0,0 +1,120 @@
+/*
+
+MIT License
+
+Copyright(c) 2023-2025 Paul Squires
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef TRANSACTION_INDEX_H
+#define TRANSACTION_INDEX_H
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "date.h"
+#include "symbols.h"
+
+class Trade;
+class Transaction;
+
+
+// Filter applied to the index. An empty symbol or a category of CATEGORY_ALL matches
+// every row.
+struct TransactionFilter {
+    Date     start_date;
+    Date     end_date;
+    SymbolId symbol_id = SYMBOL_NONE;
+    bool     is_symbol_filtered = false;
+    int      category = 0;
+    bool     is_category_filtered = false;
+};
+
+
+struct TransactionTotals {
+    double gross = 0;
+    double fees  = 0;
+    double net   = 0;
+};
+
+
+// Columnar copy of the fields of every Transaction that the Transactions and Closed Trades
+// panels filter and total on. Each column holds one value per row with rows grouped by
+// Trade. Scanning the columns avoids visiting every Trade and Transaction object just to
+// compare a date or add up a total. The object pointers are kept so that the matching
+// rows can still be displayed but the scans never touch them.
+//
+// The rows and the Trades are also kept in date order, overall and for each ticker and
+// category, so that a date range filter is two binary searches and a contiguous slice.
+//
+// CDatabase rebuilds the index on demand after the model has been loaded or modified
+// (see CDatabase::GetTransactionIndex).
+class CTransactionIndex {
+public:
+    // Transaction rows
+    std::vector<int32_t>      trans_date;       // Date::DaysSinceEpoch()
+    std::vector<SymbolId>     symbol_id;
+    std::vector<int32_t>      category;
+    std::vector<uint8_t>      underlying;
+    std::vector<int32_t>      quantity;
+    std::vector<double>       price;
+    std::vector<double>       fees;
+    std::vector<double>       total;
+    std::vector<uint32_t>     row_trade;        // index into the Trade columns below
+    std::vector<std::shared_ptr<Transaction>> transactions;
+
+    // Trade columns. The rows of Trade k are [first_row[k], first_row[k + 1]).
+    std::vector<std::shared_ptr<Trade>> trades;
+    std::vector<uint32_t>     first_row;
+    std::vector<int32_t>      latest_trans_date;
+    std::vector<SymbolId>     trade_symbol_id;
+    std::vector<int32_t>      trade_category;
+
+    void Build(const std::vector<std::shared_ptr<Trade>>& source);
+    void Clear();
+    size_t RowCount() const { return trans_date.size(); }
+    size_t TradeCount() const { return trades.size(); }
+
+    void Select(const TransactionFilter& filter, std::vector<uint32_t>& rows) const;
+    void SelectTrades(const TransactionFilter& filter, std::vector<uint32_t>& trade_rows) const;
+    TransactionTotals Sum(const std::vector<uint32_t>& rows) const;
+
+private:
+    // Row or Trade numbers sorted by date, overall and for each ticker and category.
+    struct DateOrder {
+        std::vector<uint32_t> all;
+        std::unordered_map<SymbolId, std::vector<uint32_t>> by_symbol;
+        std::unordered_map<int32_t, std::vector<uint32_t>> by_category;
+    };
+
+    static void BuildDateOrder(DateOrder& order, const std::vector<int32_t>& dates,
+                const std::vector<SymbolId>& symbols, const std::vector<int32_t>& categories);
+    static void SelectDateRange(const DateOrder& order, const std::vector<int32_t>& dates,
+                const std::vector<int32_t>& categories, const TransactionFilter& filter,
+                int32_t start, int32_t end, std::vector<uint32_t>& out);
+
+    DateOrder row_order;        // ordered by trans_date
+    DateOrder trade_order;      // ordered by latest_trans_date
+};
+
+#endif //TRANSACTION_INDEX_H
@@ -77,50 +77,40 @@ void SetFirstLineTransactions(AppState& state, std::vector<CListPanelData>& vec)
 
 
 void LoadTransactionsData(AppState& state, std::vector<CListPanelData>& vec) {
-    std::string start_date = state.filterpanel_start_date;
-    std::string end_date = state.filterpanel_end_date;
+    Date start_date = Date::FromString(state.filterpanel_start_date);
+    Date end_date = Date::FromString(state.filterpanel_end_date);
     std::string ticker = state.filterpanel_ticker_symbol;
+    SymbolId ticker_symbol_id = symbol_table.Find(ticker);
     int selected_category = state.filterpanel_selected_category;
 
     if (selected_category == CATEGORY_END + 1) selected_category = CATEGORY_OTHER;
     if (selected_category == CATEGORY_END + 2) selected_category = CATEGORY_ALL;
 
-    struct TransData {
-        std::shared_ptr<Trade> trade;
-        std::shared_ptr<Transaction> trans;
-    };
-    std::vector<TransData> tdata;
-    tdata.reserve(2000);    // reserve space for 2000 Transactions
-
-    for (auto& trade : state.db.trades) {
-        for (auto& trans : trade->transactions) {
-            if (ticker.length() > 0) {
-                if (ticker != trade->ticker_symbol) continue;
-            }
-
-            if (selected_category != CATEGORY_ALL) {
-                if (trade->category != selected_category) continue;
-            }
-
-            if (trans->trans_date < start_date || trans->trans_date > end_date) continue;
-
-            TransData td;
-            td.trade = trade;
-            td.trans = trans;
-            tdata.push_back(td);
-        }
-    }
-
-    // Sort the vector based on most recent date then by ticker
-    std::sort(tdata.begin(), tdata.end(),
-        [](const TransData data1, const TransData data2) {
+    TransactionFilter filter;
+    filter.start_date = start_date;
+    filter.end_date = end_date;
+    filter.symbol_id = ticker_symbol_id;
+    filter.is_symbol_filtered = (ticker.length() > 0);
+    filter.category = selected_category;
+    filter.is_category_filtered = (selected_category != CATEGORY_ALL);
+
+    // Filter on the columnar index rather than visiting every Trade and Transaction.
+    const CTransactionIndex& index = state.db.GetTransactionIndex();
+    std::vector<uint32_t> rows;
+    rows.reserve(2000);    // reserve space for 2000 Transactions
+    index.Select(filter, rows);
+
+    // Sort the rows based on most recent date then by ticker
+    const std::vector<uint32_t> ranks = symbol_table.SortRanks();
+    std::sort(rows.begin(), rows.end(),
+        [&index, &ranks](uint32_t row1, uint32_t row2) {
             {
-                if (data1.trans->trans_date > data2.trans->trans_date) return true;
-                if (data2.trans->trans_date > data1.trans->trans_date) return false;
+                if (index.trans_date[row1] > index.trans_date[row2]) return true;
+                if (index.trans_date[row2] > index.trans_date[row1]) return false;
 
                 // a=b for primary condition, go to secondary
-                if (data1.trade->ticker_symbol < data2.trade->ticker_symbol) return true;
-                if (data2.trade->ticker_symbol < data1.trade->ticker_symbol) return false;
+                if (ranks[index.symbol_id[row1]] < ranks[index.symbol_id[row2]]) return true;
+                if (ranks[index.symbol_id[row2]] < ranks[index.symbol_id[row1]]) return false;
 
                 return false;
             }
@@ -132,17 +122,12 @@ void LoadTransactionsData(AppState& state, std::vector<CListPanelData>& vec) {
     vec.reserve(128);
 
     // Create the new Listbox data that will display for the Transactions
-    double running_gross_total = 0;
-    double running_fees_total = 0;
-    double running_net_total = 0;
-
-    for (const auto& td : tdata) {
-        ListPanelData_OutputTransaction(state, vec, td.trade, td.trans);
-        running_net_total += td.trans->total;
-        running_fees_total += td.trans->fees;
-        running_gross_total += (td.trans->total + td.trans->fees);
+    for (uint32_t row : rows) {
+        ListPanelData_OutputTransaction(state, vec, index.trades[index.row_trade[row]], index.transactions[row]);
     }
-    ListPanelData_OutputTransactionRunningTotal(state, vec, running_gross_total, running_fees_total, running_net_total);
+
+    TransactionTotals totals = index.Sum(rows);
+    ListPanelData_OutputTransactionRunningTotal(state, vec, totals.gross, totals.fees, totals.net);
 
     // If no transactions then add at least one line
     if (vec.size() == 0) {
@@ -182,6 +167,7 @@ void ShowTransPanel(AppState& state) {
 
         // Default to display the Trade History for the first entry in the list.
         SetFirstLineTransactions(state, vec);
+        ScrollToSelectedGridRow(lp);
     }
 
     ImGui::BeginGroup();
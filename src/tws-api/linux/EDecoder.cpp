@@ -22,6 +22,7 @@
 #include <string>
 #include <bitset>
 #include <cmath>
+#include <charconv>
 
 
 EDecoder::EDecoder(int serverVersion, EWrapper *callback, EClientMsgSink *clientMsgSink) {
@@ -30,21 +31,38 @@ EDecoder::EDecoder(int serverVersion, EWrapper *callback, EClientMsgSink *client
 	m_pClientMsgSink = clientMsgSink;
 }
 
+void EDecoder::setTickFilter(const EDecoderTickFilter& filter) {
+	m_tickFilter = filter;
+}
+
 const char* EDecoder::processTickPriceMsg(const char* ptr, const char* endPtr) {
 	int version;
 	int tickerId;
 	int tickTypeInt;
 	double price;
 
-	Decimal size;
+	Decimal size = UNSET_DECIMAL;
 	int attrMask;
 
-	DECODE_FIELD( version);
-	DECODE_FIELD( tickerId);
-	DECODE_FIELD( tickTypeInt);
-	DECODE_FIELD( price);
-	DECODE_FIELD( size); // ver 2 field
-	DECODE_FIELD( attrMask); // ver 3 field
+	DECODE_FIELD_FAST( version);
+	DECODE_FIELD_FAST( tickerId);
+	DECODE_FIELD_FAST( tickTypeInt);
+
+	bool isPriceWanted = m_tickFilter.isTickPriceWanted(tickTypeInt);
+
+	if (!isPriceWanted && !m_tickFilter.tickPriceSizes) {
+		SKIP_FIELDS( 3); // price, size, attrMask
+		return ptr;
+	}
+
+	DECODE_FIELD_FAST( price);
+	if (m_tickFilter.tickPriceSizes) {
+		DECODE_FIELD( size); // ver 2 field
+	}
+	else {
+		SKIP_FIELDS( 1);
+	}
+	DECODE_FIELD_FAST( attrMask); // ver 3 field
 
 	TickAttrib attrib = {};
 
@@ -63,10 +81,11 @@ const char* EDecoder::processTickPriceMsg(const char* ptr, const char* endPtr) {
 		}
 	}
 
-	m_pEWrapper->tickPrice( tickerId, (TickType)tickTypeInt, price, attrib);
+	if (isPriceWanted)
+		m_pEWrapper->tickPrice( tickerId, (TickType)tickTypeInt, price, attrib);
 
 	// process ver 2 fields
-	{
+	if (m_tickFilter.tickPriceSizes) {
 		TickType sizeTickType = NOT_SET;
 		switch( (TickType)tickTypeInt) {
 		case BID:
@@ -103,9 +122,15 @@ const char* EDecoder::processTickSizeMsg(const char* ptr, const char* endPtr) {
 	int tickTypeInt;
 	Decimal size;
 
-	DECODE_FIELD( version);
-	DECODE_FIELD( tickerId);
-	DECODE_FIELD( tickTypeInt);
+	DECODE_FIELD_FAST( version);
+	DECODE_FIELD_FAST( tickerId);
+	DECODE_FIELD_FAST( tickTypeInt);
+
+	if (!m_tickFilter.tickSize) {
+		SKIP_FIELDS( 1);
+		return ptr;
+	}
+
 	DECODE_FIELD( size);
 
 	m_pEWrapper->tickSize( tickerId, (TickType)tickTypeInt, size);
@@ -131,19 +156,19 @@ const char* EDecoder::processTickOptionComputationMsg(const char* ptr, const cha
 
 	if (m_serverVersion < MIN_SERVER_VER_PRICE_BASED_VOLATILITY)
 	{
-		DECODE_FIELD(version);
+		DECODE_FIELD_FAST(version);
 	}
 
-	DECODE_FIELD( tickerId);
-	DECODE_FIELD( tickTypeInt);
+	DECODE_FIELD_FAST( tickerId);
+	DECODE_FIELD_FAST( tickTypeInt);
 
 	if (m_serverVersion >= MIN_SERVER_VER_PRICE_BASED_VOLATILITY)
 	{
-		DECODE_FIELD( tickAttrib);
+		DECODE_FIELD_FAST( tickAttrib);
 	}
 
-	DECODE_FIELD( impliedVol);
-	DECODE_FIELD( delta);
+	DECODE_FIELD_FAST( impliedVol);
+	DECODE_FIELD_FAST( delta);
 
 	if( impliedVol == -1) { // -1 is the "not computed" indicator
 		impliedVol = DBL_MAX;
@@ -152,10 +177,19 @@ const char* EDecoder::processTickOptionComputationMsg(const char* ptr, const cha
 		delta = DBL_MAX;
 	}
 
-	if( version >= 6 || tickTypeInt == MODEL_OPTION || tickTypeInt == DELAYED_MODEL_OPTION_COMPUTATION) { // introduced in version == 5
+	bool hasOptPrice = (version >= 6 || tickTypeInt == MODEL_OPTION || tickTypeInt == DELAYED_MODEL_OPTION_COMPUTATION); // introduced in version == 5
+
+	if (m_tickFilter.tickOptionDeltaOnly) {
+		SKIP_FIELDS( (hasOptPrice ? 2 : 0) + (version >= 6 ? 4 : 0));
+		m_pEWrapper->tickOptionComputation( tickerId, (TickType)tickTypeInt, tickAttrib,
+			impliedVol, delta, optPrice, pvDividend, gamma, vega, theta, undPrice);
+		return ptr;
+	}
+
+	if( hasOptPrice) {
 
-		DECODE_FIELD( optPrice);
-		DECODE_FIELD( pvDividend);
+		DECODE_FIELD_FAST( optPrice);
+		DECODE_FIELD_FAST( pvDividend);
 
 		if( optPrice == -1) { // -1 is the "not computed" indicator
 			optPrice = DBL_MAX;
@@ -166,10 +200,10 @@ const char* EDecoder::processTickOptionComputationMsg(const char* ptr, const cha
 	}
 	if( version >= 6) {
 
-		DECODE_FIELD( gamma);
-		DECODE_FIELD( vega);
-		DECODE_FIELD( theta);
-		DECODE_FIELD( undPrice);
+		DECODE_FIELD_FAST( gamma);
+		DECODE_FIELD_FAST( vega);
+		DECODE_FIELD_FAST( theta);
+		DECODE_FIELD_FAST( undPrice);
 
 		if( gamma == -2) { // -2 is the "not yet computed" indicator
 			gamma = DBL_MAX;
@@ -2677,6 +2711,54 @@ bool EDecoder::DecodeField(double& doubleValue, const char*& ptr, const char* en
 	return true;
 }
 
+bool EDecoder::DecodeFieldFast(int& intValue, const char*& ptr, const char* endPtr)
+{
+	if( !CheckOffset(ptr, endPtr))
+		return false;
+	const char* fieldBeg = ptr;
+	const char* fieldEnd = FindFieldEnd(fieldBeg, endPtr);
+	if( !fieldEnd)
+		return false;
+	std::from_chars_result res = std::from_chars(fieldBeg, fieldEnd, intValue);
+	if( res.ptr != fieldEnd || res.ec != std::errc()) // empty, leading '+' or whitespace
+		intValue = atoi(fieldBeg);
+	ptr = ++fieldEnd;
+	return true;
+}
+
+bool EDecoder::DecodeFieldFast(double& doubleValue, const char*& ptr, const char* endPtr)
+{
+#if defined(__cpp_lib_to_chars)
+	if( !CheckOffset(ptr, endPtr))
+		return false;
+	const char* fieldBeg = ptr;
+	const char* fieldEnd = FindFieldEnd(fieldBeg, endPtr);
+	if( !fieldEnd)
+		return false;
+	std::from_chars_result res = std::from_chars(fieldBeg, fieldEnd, doubleValue);
+	if( res.ptr != fieldEnd || res.ec != std::errc()) // empty, leading '+' or whitespace
+		doubleValue = atof(fieldBeg);
+	ptr = ++fieldEnd;
+	return true;
+#else
+	// standard library without floating point from_chars
+	return DecodeField(doubleValue, ptr, endPtr);
+#endif
+}
+
+bool EDecoder::SkipFields(int count, const char*& ptr, const char* endPtr)
+{
+	for( int i = 0; i < count; ++i) {
+		if( !CheckOffset(ptr, endPtr))
+			return false;
+		const char* fieldEnd = FindFieldEnd(ptr, endPtr);
+		if( !fieldEnd)
+			return false;
+		ptr = ++fieldEnd;
+	}
+	return true;
+}
+
 bool EDecoder::DecodeField(std::string& stringValue,
 						   const char*& ptr, const char* endPtr)
 {
@@ -261,11 +261,28 @@ struct ScanData {
 class EWrapper;
 struct EClientMsgSink;
 
+// Selects which parts of the high frequency tick messages are decoded and passed to the
+// EWrapper. Anything filtered out is skipped over without being decoded. The default
+// passes everything through.
+struct EDecoderTickFilter
+{
+    unsigned long long tickPriceTypes = ~0ULL;  // bit per TickType sent to tickPrice (types above 63 share bit 63)
+    bool tickPriceSizes = true;                 // send the size that accompanies a tickPrice to tickSize
+    bool tickSize = true;                       // send TICK_SIZE messages to tickSize
+    bool tickOptionDeltaOnly = false;           // decode only implied vol and delta of option computations
+
+    bool isTickPriceWanted(int tickType) const {
+        unsigned int bit = ((unsigned int)tickType < 63) ? (unsigned int)tickType : 63;
+        return ((tickPriceTypes >> bit) & 1) != 0;
+    }
+};
+
 class TWSAPIDLLEXP EDecoder
 {
     EWrapper *m_pEWrapper;
     int m_serverVersion;
     EClientMsgSink *m_pClientMsgSink;
+    EDecoderTickFilter m_tickFilter;
 
     const char* processTickPriceMsg(const char* ptr, const char* endPtr);
     const char* processTickSizeMsg(const char* ptr, const char* endPtr);
@@ -382,12 +399,21 @@ public:
     static bool DecodeFieldMax(long&, const char*& ptr, const char* endPtr);
     static bool DecodeFieldMax(double&, const char*& ptr, const char* endPtr);
 
+    // from_chars based decoders and field skipping for the tick messages
+    static bool DecodeFieldFast(int&, const char*& ptr, const char* endPtr);
+    static bool DecodeFieldFast(double&, const char*& ptr, const char* endPtr);
+    static bool SkipFields(int count, const char*& ptr, const char* endPtr);
+
     EDecoder(int serverVersion, EWrapper *callback, EClientMsgSink *clientMsgSink = 0);
 
+    void setTickFilter(const EDecoderTickFilter& filter);
+
     int parseAndProcessMsg(const char*& beginPtr, const char* endPtr);
 };
 
 #define DECODE_FIELD(x) if (!EDecoder::DecodeField(x, ptr, endPtr)) return 0;
 #define DECODE_FIELD_TIME(x) if (!EDecoder::DecodeFieldTime(x, ptr, endPtr)) return 0;
 #define DECODE_FIELD_MAX(x) if (!EDecoder::DecodeFieldMax(x, ptr, endPtr)) return 0;
+#define DECODE_FIELD_FAST(x) if (!EDecoder::DecodeFieldFast(x, ptr, endPtr)) return 0;
+#define SKIP_FIELDS(n) if (!EDecoder::SkipFields(n, ptr, endPtr)) return 0;
 #endif
@@ -12,9 +12,15 @@ class TWSAPIDLLEXP EMessage
 {
     std::vector<char> data;
 public:
+    EMessage();
     EMessage(const std::vector<char> &data);
     const char* begin(void) const;
     const char* end(void) const;
+
+    // Reusable buffer (pooled messages in EMessageRing). The capacity is kept between uses.
+    char* resize(size_t size);
+    size_t capacity(void) const;
+    void shrink(size_t max_capacity);
 };
 
 #endif
\ No newline at end of file
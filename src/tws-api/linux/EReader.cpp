@@ -2,6 +2,8 @@
  * and conditions of the IB API Non-Commercial License or the IB API Commercial License, as applicable. */
 
 #include "StdAfx.h"
+#include <thread>
+#include <cstring>
 #include "Contract.h"
 #include "EDecoder.h"
 #include "EMutex.h"
@@ -29,6 +31,7 @@ EReader::EReader(EClientSocket *clientSocket, EReaderSignal *signal)
 		m_pEReaderSignal = signal;
 		m_nMaxBufSize = IN_BUF_SIZE_DEFAULT;
 		m_buf.reserve(IN_BUF_SIZE_DEFAULT);
+		m_bufOffset = 0;
 }
 
 EReader::~EReader(void) {
@@ -75,7 +78,7 @@ void EReader::readToQueue() {
 	//EMessage *msg = 0;
 
 	while (m_isAlive) {
-		if (m_buf.size() == 0 && !processNonBlockingSelect() && m_pClientSocket->isSocketOK())
+		if (unreadSize() == 0 && !processNonBlockingSelect() && m_pClientSocket->isSocketOK())
 			continue;
 
         if (!putMessageToQueue())
@@ -87,24 +90,39 @@ void EReader::readToQueue() {
 }
 
 bool EReader::putMessageToQueue() {
-	EMessage *msg = 0;
+	// Wait for the consumer to free a slot rather than dropping the message. Every
+	// message matters (order status, position end, etc).
+	EMessage *msg = m_msgQueue.beginWrite();
 
-	if (m_pClientSocket->isSocketOK())
-		msg = readSingleMsg();
+	if (msg == 0) {
+		m_msgQueue.noteFull();
+		m_pEReaderSignal->issueSignal();
 
-	if (msg == 0)
-		return false;
+		while (m_isAlive && (msg = m_msgQueue.beginWrite()) == 0)
+			std::this_thread::yield();
 
-	{
-		EMutexGuard lock(m_csMsgQueue);
-		m_msgQueue.push_back(std::shared_ptr<EMessage>(msg));
+		if (msg == 0)
+			return false;
 	}
 
+	if (!m_pClientSocket->isSocketOK() || !readSingleMsg(*msg))
+		return false;
+
+	m_msgQueue.commitWrite();
+
 	m_pEReaderSignal->issueSignal();
 
 	return true;
 }
 
+EMessageQueueStats EReader::getQueueStats(void) const {
+	return m_msgQueue.stats();
+}
+
+void EReader::setTickFilter(const EDecoderTickFilter& filter) {
+	processMsgsDecoder_.setTickFilter(filter);
+}
+
 bool EReader::processNonBlockingSelect() {
 	fd_set readSet, writeSet, errorSet;
 	struct timeval tval;
@@ -169,6 +187,8 @@ void EReader::onSend() {
 }
 
 void EReader::onReceive() {
+	compactBuffer();
+
 	int nOffset = m_buf.size();
 
 	m_buf.resize(m_nMaxBufSize);
@@ -181,18 +201,41 @@ void EReader::onReceive() {
  	m_buf.resize(nRes + nOffset);	
 }
 
+size_t EReader::unreadSize(void) const {
+	return m_buf.size() - m_bufOffset;
+}
+
+// Move the unread data to the front of m_buf. Called once per socket receive (not once
+// per read) so that the cost stays proportional to the number of bytes received.
+void EReader::compactBuffer(void) {
+	if (m_bufOffset == 0)
+		return;
+
+	size_t nUnread = unreadSize();
+
+	if (nUnread > 0)
+		memmove(m_buf.data(), m_buf.data() + m_bufOffset, nUnread);
+
+	m_buf.resize(nUnread);
+	m_bufOffset = 0;
+}
+
 bool EReader::bufferedRead(char *buf, unsigned int size) {
 	while (size > 0) {
-		while (m_buf.size() < size && m_buf.size() < m_nMaxBufSize) {
+		while (unreadSize() < size && unreadSize() < m_nMaxBufSize) {
 			if (!processNonBlockingSelect() && !m_pClientSocket->isSocketOK())
 				return false;
 		}
 
-		int nBytes = (std::min<unsigned int>)(m_nMaxBufSize, size);
+		size_t nBytes = (std::min<size_t>)(unreadSize(), size);
 
-		std::copy(m_buf.begin(), m_buf.begin() + nBytes, buf);
-		std::copy(m_buf.begin() + nBytes, m_buf.end(), m_buf.begin());
-		m_buf.resize(m_buf.size() - nBytes);
+		memcpy(buf, m_buf.data() + m_bufOffset, nBytes);
+		m_bufOffset += nBytes;
+
+		if (m_bufOffset == m_buf.size()) {
+			m_buf.clear();
+			m_bufOffset = 0;
+		}
 
 		size -= nBytes;
 		buf += nBytes;
@@ -201,24 +244,19 @@ bool EReader::bufferedRead(char *buf, unsigned int size) {
 	return true;
 }
 
-EMessage * EReader::readSingleMsg() {
+bool EReader::readSingleMsg(EMessage &msg) {
 	if (m_pClientSocket->usingV100Plus()) {
 		int msgSize;
 
 		if (!bufferedRead((char *)&msgSize, sizeof(msgSize)))
-			return 0;
+			return false;
 
 		msgSize = ntohl(msgSize);
 
 		if (msgSize <= 0 || msgSize > MAX_MSG_LEN)
-			return 0;
-
-		std::vector<char> buf = std::vector<char>(msgSize);
-
-		if (!bufferedRead(buf.data(), buf.size()))
-			return 0;
+			return false;
 
-		return new EMessage(buf);
+		return bufferedRead(msg.resize(msgSize), msgSize);
 	}
 	else {
 		const char *pBegin = 0;
@@ -227,64 +265,43 @@ EMessage * EReader::readSingleMsg() {
 
 		while (msgSize == 0)
 		{
-			if (m_buf.size() >= m_nMaxBufSize * 3/4) 
+			if (unreadSize() >= m_nMaxBufSize * 3/4) 
 				m_nMaxBufSize *= 2;
 
 			if (!processNonBlockingSelect() && !m_pClientSocket->isSocketOK())
-				return 0;
+				return false;
 		
-			pBegin = m_buf.data();
-			pEnd = pBegin + m_buf.size();
+			pBegin = m_buf.data() + m_bufOffset;
+			pEnd = m_buf.data() + m_buf.size();
 			msgSize = EDecoder(m_pClientSocket->EClient::serverVersion(), &defaultWrapper).parseAndProcessMsg(pBegin, pEnd);
 		}
 	
-		std::vector<char> msgData(msgSize);
-
-		if (!bufferedRead(msgData.data(), msgSize))
-			return 0;
+		if (!bufferedRead(msg.resize(msgSize), msgSize))
+			return false;
 
-		if (m_buf.size() < IN_BUF_SIZE_DEFAULT && m_buf.capacity() > IN_BUF_SIZE_DEFAULT)
+		if (unreadSize() < IN_BUF_SIZE_DEFAULT && m_buf.capacity() > IN_BUF_SIZE_DEFAULT)
 		{
-			m_buf.resize(m_nMaxBufSize = IN_BUF_SIZE_DEFAULT);
+			compactBuffer();
+			m_nMaxBufSize = IN_BUF_SIZE_DEFAULT;
 			m_buf.shrink_to_fit();
 		}
 
-		EMessage * msg = new EMessage(msgData);
-
-		return msg;
-	}
-}
-
-std::shared_ptr<EMessage> EReader::getMsg(void) {
-	EMutexGuard lock(m_csMsgQueue);
-
-	if (m_msgQueue.size() == 0) {
-		return std::shared_ptr<EMessage>();
+		return true;
 	}
-
-	std::shared_ptr<EMessage> msg = m_msgQueue.front();
-	m_msgQueue.pop_front();
-
-	return msg;
 }
 
-
 void EReader::processMsgs(void) {
 	m_pClientSocket->onSend();
 
-	std::shared_ptr<EMessage> msg = getMsg();
-
-	if (!msg.get())
-		return;
+	EMessage *msg;
 
-	const char *pBegin = msg->begin();
+	while ((msg = m_msgQueue.front()) != 0) {
+		const char *pBegin = msg->begin();
+		int result = processMsgsDecoder_.parseAndProcessMsg(pBegin, msg->end());
 
-	while (processMsgsDecoder_.parseAndProcessMsg(pBegin, msg->end()) > 0) {
-		msg = getMsg();
+		m_msgQueue.pop();
 
-		if (!msg.get())
+		if (result <= 0)
 			break;
-
-		pBegin = msg->begin();
-	} 
+	}
 }
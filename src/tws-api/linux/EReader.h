@@ -6,11 +6,11 @@
 #define TWS_API_CLIENT_EREADER_H
 
 #include <atomic>
-#include <deque>
 #include "platformspecific.h"
 #include "EDecoder.h"
 #include "EMutex.h"
 #include "EReaderOSSignal.h"
+#include "EMessageRing.h"
 
 class EClientSocket;
 struct EReaderSignal;
@@ -21,9 +21,9 @@ class TWSAPIDLLEXP EReader
     EClientSocket *m_pClientSocket;
     EReaderSignal *m_pEReaderSignal;
     EDecoder processMsgsDecoder_;
-    std::deque<std::shared_ptr<EMessage>> m_msgQueue;
-    EMutex m_csMsgQueue;
+    EMessageRing m_msgQueue;
     std::vector<char> m_buf;
+    size_t m_bufOffset;    // start of the data in m_buf not yet consumed by bufferedRead
     std::atomic<bool> m_isAlive;
 #if defined(IB_POSIX)
     pthread_t m_hReadThread;
@@ -35,6 +35,8 @@ class TWSAPIDLLEXP EReader
 	void onReceive();
 	void onSend();
 	bool bufferedRead(char *buf, unsigned int size);
+	size_t unreadSize(void) const;
+	void compactBuffer(void);
 
 public:
     EReader(EClientSocket *clientSocket, EReaderSignal *signal);
@@ -42,7 +44,6 @@ public:
 
 protected:
 	bool processNonBlockingSelect();
-    std::shared_ptr<EMessage> getMsg(void);
     void readToQueue();
 #if defined(IB_POSIX)
     static void * readToQueueThread(void * lpParam);
@@ -52,11 +53,13 @@ protected:
 #   error "Not implemented on this platform"
 #endif
     
-    EMessage * readSingleMsg();
+    bool readSingleMsg(EMessage &msg);
 
 public:
     void processMsgs(void);
 	bool putMessageToQueue();
+	EMessageQueueStats getQueueStats(void) const;
+	void setTickFilter(const EDecoderTickFilter& filter);
 	void start();
 };
 
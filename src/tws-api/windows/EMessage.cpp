@@ -5,6 +5,9 @@
 #include "EMessage.h"
 
 
+EMessage::EMessage() {
+}
+
 EMessage::EMessage(const std::vector<char> &data) {
     this->data = data;
 }
@@ -18,3 +21,21 @@ const char* EMessage::end(void) const
 {
     return data.data() + data.size();
 }
+
+char* EMessage::resize(size_t size)
+{
+    data.resize(size);
+    return data.data();
+}
+
+size_t EMessage::capacity(void) const
+{
+    return data.capacity();
+}
+
+void EMessage::shrink(size_t max_capacity)
+{
+    if (data.capacity() > max_capacity) {
+        std::vector<char>().swap(data);
+    }
+}
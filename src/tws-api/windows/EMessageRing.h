@@ -0,0 +1,120 @@
+/*
+
+MIT License
+
+Copyright(c) 2023-2025 Paul Squires
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+#ifndef TWS_API_CLIENT_EMESSAGERING_H
+#define TWS_API_CLIENT_EMESSAGERING_H
+
+#include <atomic>
+#include <vector>
+#include "EMessage.h"
+
+// Counters reported by EMessageRing (and EReader::getQueueStats).
+struct EMessageQueueStats
+{
+    size_t depth = 0;           // messages currently waiting to be processed
+    size_t max_depth = 0;       // high water mark of depth
+    size_t total = 0;           // messages passed through the ring
+    size_t full_waits = 0;      // times the reader had to wait because the ring was full
+};
+
+// Single producer (EReader thread) / single consumer (EReader::processMsgs) ring of
+// preallocated EMessage buffers. The buffers are reused so no allocation occurs once
+// they have grown to the size of the messages being received, and no lock is taken.
+class EMessageRing
+{
+    std::vector<EMessage> m_slots;
+    size_t m_mask;
+
+    alignas(64) std::atomic<size_t> m_head{0};    // next slot written by the producer
+    alignas(64) std::atomic<size_t> m_tail{0};    // next slot read by the consumer
+
+    std::atomic<size_t> m_maxDepth{0};
+    std::atomic<size_t> m_fullWaits{0};
+
+    // Buffers larger than this are released after use rather than kept in the pool.
+    static const size_t MAX_POOLED_CAPACITY = 64 * 1024;
+
+public:
+    // capacity must be a power of 2
+    explicit EMessageRing(size_t capacity = 1024)
+        : m_slots(capacity), m_mask(capacity - 1) {}
+
+    // Producer: free slot to fill, or nullptr if the ring is full.
+    EMessage* beginWrite()
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) > m_mask)
+            return nullptr;
+        return &m_slots[head & m_mask];
+    }
+
+    // Producer: publish the slot returned by beginWrite.
+    void commitWrite()
+    {
+        size_t head = m_head.load(std::memory_order_relaxed) + 1;
+        m_head.store(head, std::memory_order_release);
+
+        size_t depth = head - m_tail.load(std::memory_order_relaxed);
+        if (depth > m_maxDepth.load(std::memory_order_relaxed))
+            m_maxDepth.store(depth, std::memory_order_relaxed);
+    }
+
+    // Producer: record that the ring was full.
+    void noteFull()
+    {
+        m_fullWaits.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Consumer: oldest message, or nullptr if the ring is empty.
+    EMessage* front()
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire))
+            return nullptr;
+        return &m_slots[tail & m_mask];
+    }
+
+    // Consumer: release the message returned by front back to the producer.
+    void pop()
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        m_slots[tail & m_mask].shrink(MAX_POOLED_CAPACITY);
+        m_tail.store(tail + 1, std::memory_order_release);
+    }
+
+    EMessageQueueStats stats() const
+    {
+        EMessageQueueStats s;
+        s.total = m_head.load(std::memory_order_acquire);
+        s.depth = s.total - m_tail.load(std::memory_order_acquire);
+        s.max_depth = m_maxDepth.load(std::memory_order_relaxed);
+        s.full_waits = m_fullWaits.load(std::memory_order_relaxed);
+        return s;
+    }
+};
+
+#endif
@@ -27,7 +27,11 @@ SOFTWARE.
 #include "tws-api/linux/EWrapper.h"
 #include <string>
 #include <thread>
+#include <atomic>
+#include <algorithm>
+#include <mutex>
 #include <chrono>
+#include <filesystem>
 
 #include <iostream>
 
@@ -47,14 +51,14 @@ SOFTWARE.
 #include "import_dialog.h"
 #include "reconcile.h"
 #include "messagebox.h"
+#include "market_data.h"
+#include "tick_recorder.h"
 
 
 // Unfortunately the following data structures have to
-// be made global because the data needs to be updated in the TwsClient::tickPrice
-// and TwsClient::updatePortfolio functions which are callbacks from the
-// Interactive Brokers library (therefore I can't pass AppState into it).
-std::unordered_map<TickerId, TickerData> mapTickerData;
-std::unordered_map<int, PortfolioData> mapPortfolioData;
+// be made global because the data needs to be updated in the TwsClient
+// callbacks from the Interactive Brokers library (therefore I can't pass
+// AppState into it). The ticker and portfolio data is held in market_data.cpp
 bool market_data_subscription_error = false;
 bool positionEnd_fired = false;
 bool is_connection_ready_for_data = false;
@@ -63,6 +67,13 @@ double netliq_value = 0;
 double excessliq_value = 0;
 double maintenance_value = 0;
 
+// Set by the callbacks (other than market data ticks) whose results are displayed by the
+// main loop so that the monitoring thread wakes it after processing the messages.
+std::atomic<bool> is_ui_update_needed = false;
+
+// Set while a tick recording is being replayed in place of a TWS connection.
+std::atomic<bool> is_tick_replay_active = false;
+
 
 //
 // Thread functions
@@ -76,11 +87,12 @@ void TickerUpdateFunction(AppState* state) {
 
 	while (!state->stop_ticker_update_thread_requested) {
 
-		// Sleep for 1 second
-		std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+		// Sleep for the configured interval. Only the Trades whose market data has
+		// changed during that time are updated.
+		std::this_thread::sleep_for(std::chrono::milliseconds(state->config.ticker_update_interval));
 
-		if (state->is_monitor_thread_active == true && client->IsConnected()) {
-			UpdateTickerPrices(*state);
+		if (state->is_monitor_thread_active == true && (client->IsConnected() || is_tick_replay_active)) {
+			UpdateChangedTickerPrices(*state);
 		}
 	}
 
@@ -88,6 +100,47 @@ void TickerUpdateFunction(AppState* state) {
 }
 
 
+// Delay (milliseconds) before trying to reconnect after the connection to TWS was lost.
+// Doubles after every failed attempt up to the maximum.
+static const int RECONNECT_BACKOFF_MIN = 1000;
+static const int RECONNECT_BACKOFF_MAX = 60000;
+
+
+int TwsPort(AppState& state) {
+	// If paper trading is enabled via command line then use different port
+	return (state.is_paper_trading) ? 7497 : 7496;
+}
+
+
+// Block the monitoring thread (no CPU use) until the timeout expires or it is asked to
+// stop or to reconnect immediately.
+void MonitorWait(AppState* state, int milliseconds) {
+	std::unique_lock<std::mutex> lock(state->monitor_mutex);
+	state->monitor_cv.wait_for(lock, std::chrono::milliseconds(milliseconds), [state] {
+		return state->stop_monitor_thread_requested.load() || state->is_reconnect_requested.load();
+	});
+}
+
+
+// Connect again after the connection was lost. The client state from the previous session
+// is reset so that the positions, portfolio updates and market data are requested again
+// (ShowActiveTrades does this once nextValidId sets is_connection_ready_for_data).
+bool ReconnectClient(AppState* state, TwsClient* client) {
+	client->Disconnect();
+
+	if (!client->Connect("", TwsPort(*state), client->client_id)) {
+		client->Disconnect();
+		return false;
+	}
+
+	client->had_previous_socket_exception = false;
+	positionEnd_fired = false;
+	is_positions_ready_for_data = false;
+	market_data_subscription_error = false;
+	return true;
+}
+
+
 void MonitoringFunction(AppState* state) {
 	std::cout << "Starting the monitoring thread" << std::endl;
 
@@ -95,14 +148,48 @@ void MonitoringFunction(AppState* state) {
 
     TwsClient* client = static_cast<TwsClient*>(state->client);
 
+	int backoff = RECONNECT_BACKOFF_MIN;
+
 	while (!state->stop_monitor_thread_requested) {
-		if (state->is_monitor_thread_active) {
-			if (tws_IsConnected(*state)) {
-				client->WaitForSignal();
+		switch (state->tws_connection_state) {
+		case TwsConnectionState::Connected:
+			if (!tws_IsConnected(*state)) {
+				std::cout << "Connection to TWS lost" << std::endl;
+				state->tws_connection_state = TwsConnectionState::Backoff;
+				state->RequestRedraw();
+				break;
 			}
+			client->WaitForSignal();
 			if (tws_IsConnected(*state)) {
 				client->ProcessMsgs();
+				if (is_ui_update_needed.exchange(false)) state->RequestRedraw();
+			}
+			break;
+
+		case TwsConnectionState::Backoff:
+			std::cout << "Reconnecting to TWS in " << backoff / 1000 << " seconds" << std::endl;
+			MonitorWait(state, backoff);
+			if (state->is_reconnect_requested.exchange(false)) backoff = RECONNECT_BACKOFF_MIN;
+			if (state->stop_monitor_thread_requested) break;
+			state->tws_connection_state = TwsConnectionState::Connecting;
+			break;
+
+		case TwsConnectionState::Connecting:
+			if (ReconnectClient(state, client)) {
+				backoff = RECONNECT_BACKOFF_MIN;
+				state->tws_connection_state = TwsConnectionState::Connected;
+			}
+			else {
+				backoff = std::min(backoff * 2, RECONNECT_BACKOFF_MAX);
+				state->tws_connection_state = TwsConnectionState::Backoff;
 			}
+			state->RequestRedraw();
+			break;
+
+		case TwsConnectionState::Disconnected:
+			// The user disconnected. Wait for the stop request.
+			MonitorWait(state, RECONNECT_BACKOFF_MAX);
+			break;
 		}
 	}
 
@@ -116,8 +203,49 @@ void MonitoringFunction(AppState* state) {
 }
 
 
+// Tick recording and replay file names are relative to the data files folder unless a
+// full path is given.
+std::string TickRecordingPath(const std::string& filename) {
+	std::filesystem::path path(filename);
+	if (path.is_absolute()) return filename;
+	return GetDataFilesFolder() + "/" + filename;
+}
+
+
+// Replays the configured tick recording into the client callbacks in place of a TWS
+// connection (runs on the monitoring thread). See tick_recorder.cpp.
+void TickReplayFunction(AppState* state) {
+	std::cout << "Starting the tick replay thread" << std::endl;
+
+	state->is_monitor_thread_active = true;
+	is_tick_replay_active = true;
+	is_connection_ready_for_data = true;
+	state->RequestRedraw();
+
+	TwsClient* client = static_cast<TwsClient*>(state->client);
+
+	auto start = std::chrono::steady_clock::now();
+	size_t num_records = TickReplay_Run(client, TickRecordingPath(state->config.tick_replay_file),
+		state->config.tick_replay_speed, state->stop_monitor_thread_requested);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << "Tick replay finished: " << num_records << " records in " << seconds << " seconds" << std::endl;
+	state->RequestRedraw();
+
+	// Keep the replayed data displayed until disconnected.
+	while (!state->stop_monitor_thread_requested) {
+		MonitorWait(state, RECONNECT_BACKOFF_MAX);
+	}
+
+	is_tick_replay_active = false;
+	state->is_monitor_thread_active = false;
+	state->stop_ticker_update_thread_requested = true;
+
+	std::cout << "Tick replay thread terminated" << std::endl;
+}
+
+
 #if defined(_WIN32) // win32 and win64
-#include <filesystem>
 #include <fstream>
 #include <wininet.h>
 #pragma comment(lib,"Wininet.lib")
@@ -218,8 +346,14 @@ void CheckForUpdateFunction(AppState* state) {
 }
 
 
+void JoinThread(std::thread& thread) {
+	if (thread.joinable()) thread.join();
+}
+
+
 void tws_StartCheckForUpdateThread(AppState& state) {
 	if (state.is_checkforupdate_thread_active) return;
+	JoinThread(state.check_for_update_thread);
 	AppState* ptr = &state;  // Convert reference to pointer
 	state.check_for_update_thread = std::thread(CheckForUpdateFunction, ptr);
 }
@@ -227,21 +361,39 @@ void tws_StartCheckForUpdateThread(AppState& state) {
 
 void tws_StartMonitorThread(AppState& state) {
 	if (state.is_monitor_thread_active) return;
+	JoinThread(state.monitoring_thread);
+	state.stop_monitor_thread_requested = false;
 	AppState* ptr = &state;  // Convert reference to pointer
 	state.monitoring_thread = std::thread(MonitoringFunction, ptr);
 }
 
 
+void tws_StartTickReplay(AppState& state) {
+	if (state.is_monitor_thread_active) return;
+	JoinThread(state.monitoring_thread);
+	state.stop_monitor_thread_requested = false;
+	state.tws_connection_state = TwsConnectionState::Connected;
+	AppState* ptr = &state;  // Convert reference to pointer
+	state.monitoring_thread = std::thread(TickReplayFunction, ptr);
+	tws_StartTickerUpdateThread(state);
+}
+
+
 void tws_EndMonitorThread(AppState& state) {
-	if (state.is_monitor_thread_active) {
-		state.is_monitor_thread_active = false;
+	if (state.monitoring_thread.joinable()) {
 		std::cout << "Monitoring thread will be stopped soon...." << std::endl;
-		state.stop_monitor_thread_requested = true;
+		{
+			std::lock_guard<std::mutex> lock(state.monitor_mutex);
+			state.stop_monitor_thread_requested = true;
+		}
+		state.monitor_cv.notify_all();
 	}
 }
 
 void tws_StartTickerUpdateThread(AppState& state) {
 	if (state.is_monitor_thread_active) return;
+	JoinThread(state.ticker_update_thread);
+	state.stop_ticker_update_thread_requested = false;
 	AppState* ptr = &state;  // Convert reference to pointer
 	state.ticker_update_thread = std::thread(TickerUpdateFunction, ptr);
 }
@@ -256,12 +408,27 @@ void tws_EndTickerUpdateThread(AppState& state) {
 bool tws_Connect(AppState& state) {
     if (tws_IsConnected(state)) return false;
 
-    const char* host = "";
+	// A tick recording replaces the TWS connection when one is configured.
+	if (!state.config.tick_replay_file.empty()) {
+		if (!is_tick_replay_active) tws_StartTickReplay(state);
+		return true;
+	}
 
-	int port = 7496;
+	// If the connection was lost then the monitoring thread is still running and waiting
+	// to reconnect. Ask it to try again immediately.
+	if (state.tws_connection_state == TwsConnectionState::Backoff ||
+		state.tws_connection_state == TwsConnectionState::Connecting) {
+		{
+			std::lock_guard<std::mutex> lock(state.monitor_mutex);
+			state.is_reconnect_requested = true;
+		}
+		state.monitor_cv.notify_all();
+		return true;
+	}
 
-	// If paper trading is enabled via command line then use different port
-	if (state.is_paper_trading) port = 7497;
+    const char* host = "";
+
+	int port = TwsPort(state);
 
 	bool res = false;
     TwsClient* client = static_cast<TwsClient*>(state.client);
@@ -288,6 +455,12 @@ bool tws_Connect(AppState& state) {
 		state.is_ticker_update_thread_active = false;
 
 		if (res) {
+			state.tws_connection_state = TwsConnectionState::Connected;
+
+			if (!state.config.tick_record_file.empty()) {
+				tick_recorder.Start(TickRecordingPath(state.config.tick_record_file));
+			}
+
 			// Start thread that will start messaging polling
 			// and poll if TWS remains connected. Also start thread
 			// that updates the ActiveTrades list every defined interval.
@@ -319,15 +492,21 @@ bool tws_Connect(AppState& state) {
 
 
 bool tws_Disconnect(AppState& state) {
-    if (tws_IsConnected(state) == false) return true;
+	// The monitoring thread may still be running (waiting to reconnect) even though the
+	// connection has been lost.
+    if (tws_IsConnected(state) == false && !state.monitoring_thread.joinable()) return true;
+
+	state.tws_connection_state = TwsConnectionState::Disconnected;
 
     TwsClient* client = static_cast<TwsClient*>(state.client);
-    client->Disconnect();
+    if (tws_IsConnected(state)) client->Disconnect();
     tws_EndMonitorThread(state);
 
-    state.monitoring_thread.join();
-    state.ticker_update_thread.join();
-    state.check_for_update_thread.join();
+    JoinThread(state.monitoring_thread);
+    JoinThread(state.ticker_update_thread);
+    JoinThread(state.check_for_update_thread);
+
+	tick_recorder.Stop();
 
     return (tws_IsConnected(state) ? false : true);
 }
@@ -396,11 +575,26 @@ bool TwsClient::Connect(const char* host, int port, int clientId) {
 	// trying to connect
 	printf("Connecting to %s:%d clientId:%d\n", !(host && *host) ? "127.0.0.1" : host, port, clientId);
 
+	// Destroy any reader from a previous connection first. Its destructor disconnects the
+	// socket so it must not run after the new connection is made.
+	if (m_pReader)
+		m_pReader.reset();
+
 	bool bRes = m_pClient->eConnect(host, port, clientId, m_extraAuth);
 
 	if (bRes) {
 		printf("Connected to %s:%d clientId:%d\n", m_pClient->host().c_str(), m_pClient->port(), clientId);
 		m_pReader = std::unique_ptr<EReader>(new EReader(m_pClient, &m_osSignal));
+
+		// Only LAST, OPEN and CLOSE prices and option deltas are used (see tickPrice and
+		// tickOptionComputation). Everything else is skipped without being decoded.
+		EDecoderTickFilter tick_filter;
+		tick_filter.tickPriceTypes = (1ULL << LAST) | (1ULL << OPEN) | (1ULL << CLOSE);
+		tick_filter.tickPriceSizes = false;
+		tick_filter.tickSize = false;
+		tick_filter.tickOptionDeltaOnly = true;
+		m_pReader->setTickFilter(tick_filter);
+
 		m_pReader->start();
 
 	}
@@ -414,6 +608,12 @@ void TwsClient::Disconnect() const {
 	m_pClient->eDisconnect();
 
 	printf("Disconnected\n");
+
+	if (m_pReader) {
+		EMessageQueueStats stats = m_pReader->getQueueStats();
+		printf("Message queue: %zu messages, max depth %zu, full waits %zu\n",
+			stats.total, stats.max_depth, stats.full_waits);
+	}
 }
 
 bool TwsClient::IsConnected() const {
@@ -451,6 +651,11 @@ void TwsClient::RequestMarketData(AppState& state, CListPanelData* ld) {
 	if (ld->line_type == LineType::options_leg) ticker_id = ld->leg->ticker_id;
 	if (ticker_id == -1) return;
 
+	if (!ticker_data_store.IsValidTickerId(ticker_id)) {
+		std::cout << "Market data not requested. TickerId exceeds maximum: " << ticker_id << std::endl;
+		return;
+	}
+
 	// Convert the unicode symbol to regular string type
 	std::string symbol = ld->trade->ticker_symbol;
 
@@ -459,23 +664,25 @@ void TwsClient::RequestMarketData(AppState& state, CListPanelData* ld) {
 
 	bool is_option_position = (ld->line_type == LineType::options_leg);
 
-	if (state.config.IsIndexTicker(symbol)) {
+	const InstrumentInfo& instrument = state.config.GetInstrument(*ld->trade);
+
+	if (instrument.is_index) {
 		contract.symbol = symbol;
 		contract.secType = (is_option_position) ? "OPT" : "IND";
 		contract.currency = "USD";
 		contract.exchange = "SMART";           // Use IB's SmartRouting
 		contract.primaryExchange = "CBOE";     // disambiguate the listing exchange when multiple securities have the same symbol.
-		contract.lastTradeDateOrContractMonth = (is_option_position) ? AfxRemoveDateHyphens(ld->leg->expiry_date) : "";
+		contract.lastTradeDateOrContractMonth = (is_option_position) ? ld->leg->expiry_date.ToCompactString() : "";
 	}
 	else {
-		if (state.config.IsFuturesTicker(symbol)) {
+		if (instrument.is_futures) {
 			contract.symbol = symbol.substr(1);
 			contract.secType =  (is_option_position) ? "FOP" : "FUT";
 			contract.currency = "USD";
 
 			contract.lastTradeDateOrContractMonth = AfxFormatFuturesDateMarketData(ld->trade->future_expiry);
 
-			std::string futExchange = state.config.GetFuturesExchange(symbol);
+			std::string futExchange = instrument.futures_exchange;
 			if (futExchange.length() == 0) futExchange = "CME";
 
 			contract.exchange = futExchange;
@@ -487,14 +694,14 @@ void TwsClient::RequestMarketData(AppState& state, CListPanelData* ld) {
 			contract.currency = "USD";
 			contract.exchange = "SMART";
 			contract.primaryExchange = "CBOE";
-			contract.lastTradeDateOrContractMonth = (is_option_position) ? AfxRemoveDateHyphens(ld->leg->expiry_date) : "";
+			contract.lastTradeDateOrContractMonth = (is_option_position) ? ld->leg->expiry_date.ToCompactString() : "";
 		}
 	}
 
 	if (is_option_position) {
 		contract.conId = ld->leg->contract_id;
 		contract.multiplier = std::to_string(ld->trade->multiplier);
-		contract.strike = AfxValDouble(ld->leg->strike_price);
+		contract.strike = ld->leg->strike_price.ToDouble();
 		contract.right = state.db.PutCallToString(ld->leg->put_call);
 	}
 
@@ -545,6 +752,8 @@ void TwsClient::tickByTickAllLast(int reqId, int tickType, time_t time,
 
 void TwsClient::tickPrice(TickerId ticker_id, TickType field, double price, const TickAttrib& attribs) {
 
+	if (tick_recorder.IsRecording()) tick_recorder.RecordTickPrice(ticker_id, field, price);
+
 	if (price == -1) return;   // no data currently available
 
 	// Market data tick price callback. Handles all price related ticks. Every tickPrice callback is followed
@@ -567,20 +776,9 @@ void TwsClient::tickPrice(TickerId ticker_id, TickType field, double price, cons
 		// if (field == OPEN) std::cout << "tickPrice OPEN " << ticker_id << " " << price << std::endl;
 		// if (field == CLOSE) std::cout << "tickPrice CLOSE " << ticker_id << " " << price << std::endl;
 
-		TickerData td{};
-
-		if (mapTickerData.count(ticker_id)) {
-			td = mapTickerData.at(ticker_id);
-		}
-
-		if (field == OPEN) {
-			td.open_price = price;
-			if (td.close_price == 0) td.close_price = price;
-		}
-		if (field == CLOSE) td.close_price = price;
-		if (field == LAST) td.last_price = price;
-
-		mapTickerData[ticker_id] = td;
+		if (field == OPEN) ticker_data_store.SetOpenPrice(ticker_id, price);
+		if (field == CLOSE) ticker_data_store.SetClosePrice(ticker_id, price);
+		if (field == LAST) ticker_data_store.SetLastPrice(ticker_id, price);
 	}
 }
 
@@ -589,12 +787,12 @@ void TwsClient::updatePortfolio(const Contract& contract, Decimal position,
 	double market_price, double market_value, double average_cost,
 	double unrealized_PNL, double realized_PNL, const std::string& account_name)
 {
-	PortfolioData pd{};
-
-	if (mapPortfolioData.count(contract.conId)) {
-		pd = mapPortfolioData.at(contract.conId);
+	if (tick_recorder.IsRecording()) {
+		tick_recorder.RecordUpdatePortfolio(contract, position, market_price, market_value,
+			average_cost, unrealized_PNL, realized_PNL);
 	}
 
+	PortfolioData pd{};
 	pd.position = position;
 	pd.market_price = market_price;
 	pd.market_value = market_value;
@@ -602,7 +800,7 @@ void TwsClient::updatePortfolio(const Contract& contract, Decimal position,
 	pd.unrealized_pnl = unrealized_PNL;
 	pd.realized_pnl = realized_PNL;
 
-	mapPortfolioData[contract.conId] = pd;
+	portfolio_data_store.Set(contract.conId, pd);
 }
 
 
@@ -610,12 +808,15 @@ void TwsClient::connectionClosed() {
 	printf("Connection Closed\n");
 	// TWS must have shut down while our application was still running.
 	had_previous_socket_exception = true;
+	is_ui_update_needed = true;
 }
 
 
 void TwsClient::error(int id, int error_code,
 	const std::string& error_string, const std::string& advanced_order_reject_json)
 {
+	is_ui_update_needed = true;
+
 	switch (error_code) {
 	case 509:  // socket exception error
 		if (id == -1) {
@@ -676,6 +877,8 @@ void TwsClient::position(const std::string& account, const Contract& contract, D
 
 std::cout << "ImportTrades_position" << std::endl;
 
+	if (tick_recorder.IsRecording()) tick_recorder.RecordPosition(contract, position, avg_cost);
+
 	// This callback is initiated by the reqPositions().
 	Reconcile_position(contract, position, avg_cost);
 
@@ -694,6 +897,7 @@ void TwsClient::positionEnd() {
 	// Send notification to ActiveTrades window that positions have all been loaded
 	// thereby allowing the loading of portfolio values.
 	is_positions_ready_for_data = true;
+	is_ui_update_needed = true;
 }
 
 
@@ -727,6 +931,8 @@ void TwsClient::accountSummary(int reqId, const std::string& account,
     if (tag == "NetLiquidation")  netliq_value = amount;
 	if (tag == "ExcessLiquidity") excessliq_value = amount;
 	if (tag == "MaintMarginReq")  maintenance_value = amount;
+
+	is_ui_update_needed = true;
 }
 
 
@@ -756,6 +962,7 @@ void TwsClient::winError(const std::string& str, int lastError) {}
 
 void TwsClient::nextValidId(OrderId orderId) {
 	is_connection_ready_for_data = true;
+	is_ui_update_needed = true;
 }
 
 void TwsClient::currentTime(long time) {
@@ -765,10 +972,10 @@ void TwsClient::currentTime(long time) {
 
 void TwsClient::tickOptionComputation(TickerId tickerId, TickType tickType, int tickAttrib, double impliedVol, double delta,
                            double optPrice, double pvDividend, double gamma, double vega, double theta, double undPrice) {
-	if (mapTickerData.count(tickerId)) {
-		if (delta > -1.0f && delta < 1.0f) {
-			mapTickerData.at(tickerId).delta = delta;
-		}
+	if (tick_recorder.IsRecording()) tick_recorder.RecordTickOptionComputation(tickerId, tickType, impliedVol, delta);
+
+	if (delta > -1.0f && delta < 1.0f) {
+		ticker_data_store.UpdateDelta(tickerId, delta);
 	}
 }
 
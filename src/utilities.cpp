@@ -39,6 +39,12 @@ SOFTWARE.
 #include <iomanip>
 #include <stdio.h>
 #include <filesystem>
+#include <string_view>
+#include <charconv>
+#include <cstring>
+#include <cerrno>
+#include <functional>
+#include <thread>
 
 #include "appstate.h"
 
@@ -290,17 +296,24 @@ bool AfxSaveStringToFile(const std::string& filename, const std::string& data) {
 // Load a text file into a string
 // ========================================================================================
 std::string AfxLoadFileIntoString(const std::string& filename) {
-    std::ifstream file(filename);
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
 
     if (!file.is_open()) {
         std::cout <<"Could not open file " + filename << std::endl;
         return "";
     }
 
-    std::stringstream buffer;
-    buffer << file.rdbuf();
+    // Read the whole file with a single read into a buffer of the exact size. Lines
+    // may therefore end in "\r\n" (see AfxNextLine).
+    std::streamsize size = file.tellg();
+    if (size <= 0) return "";
 
-    return buffer.str();
+    std::string buffer((size_t)size, '\0');
+    file.seekg(0, std::ios::beg);
+    file.read(buffer.data(), size);
+    buffer.resize((size_t)file.gcount());
+
+    return buffer;
 }
 
 
@@ -308,13 +321,9 @@ std::string AfxLoadFileIntoString(const std::string& filename) {
 // Convert YYYY-MM-DD string to year_month_day object
 // ========================================================================================
 std::chrono::year_month_day from_iso_string(const std::string& iso_string) {
-    int y;
-    unsigned int m, d;
-    char delim1, delim2;
-    std::istringstream iss(iso_string);
-
-    iss >> y >> delim1 >> m >> delim2 >> d && delim1 == '-' && delim2 == '-';
-    return year_month_day{year{y}, month{m}, day{d}};
+    int y = 0, m = 0, d = 0;
+    Date::FromString(iso_string).ToYMD(y, m, d);
+    return year_month_day{year{y}, month{(unsigned)m}, day{(unsigned)d}};
 }
 
 
@@ -406,40 +415,158 @@ std::vector<std::string> AfxSplit(const std::string& input, char delimiter) {
 
 
 // ========================================================================================
-// Convert string to integer catching any exceptions
+// Run func(begin, end) over the range [0, count) split into contiguous sub ranges that
+// are processed on separate threads (one per hardware thread). Each thread receives at
+// least min_per_thread items. Returns once every sub range has been processed.
 // ========================================================================================
-int AfxValInteger(const std::string& st)  {
-    if (st == "") return 0;
-    try {
-        size_t pos;
-        int result = std::stoi(st, &pos);
+void AfxParallelFor(size_t count, size_t min_per_thread, const std::function<void(size_t, size_t)>& func) {
+    if (count == 0) return;
+    if (min_per_thread == 0) min_per_thread = 1;
+
+    size_t num_threads = std::thread::hardware_concurrency();
+    if (num_threads == 0) num_threads = 1;
+    num_threads = std::min(num_threads, (count + min_per_thread - 1) / min_per_thread);
+
+    if (num_threads <= 1) {
+        func(0, count);
+        return;
+    }
+
+    size_t range_size = (count + num_threads - 1) / num_threads;
+
+    std::vector<std::thread> workers;
+    workers.reserve(num_threads - 1);
+
+    for (size_t begin = range_size; begin < count; begin += range_size) {
+        size_t end = std::min(begin + range_size, count);
+        workers.emplace_back(func, begin, end);
+    }
+
+    // The calling thread processes the first range itself.
+    func(0, std::min(range_size, count));
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+
+// ========================================================================================
+// Split a line into string_view tokens separated by the delimiter. The tokens vector
+// is reused between calls so no memory is allocated once it has grown large enough.
+// Follows the same rules as AfxSplit (a trailing empty token is not returned).
+// ========================================================================================
+void AfxSplitView(std::string_view input, char delimiter, std::vector<std::string_view>& tokens) {
+    tokens.clear();
+
+    while (!input.empty()) {
+        size_t pos = input.find(delimiter);
+        if (pos == std::string_view::npos) {
+            tokens.emplace_back(input);
+            break;
+        }
+        tokens.emplace_back(input.substr(0, pos));
+        input.remove_prefix(pos + 1);
+    }
+}
+
+
+// ========================================================================================
+// Remove all leading and trailing whitespace characters from a string_view
+// ========================================================================================
+std::string_view AfxTrimView(std::string_view input) {
+    while (!input.empty() && std::isspace((unsigned char)input.front())) input.remove_prefix(1);
+    while (!input.empty() && std::isspace((unsigned char)input.back())) input.remove_suffix(1);
+    return input;
+}
+
 
-        // Check if the entire string was used for conversion
-        return (pos == st.length()) ? result : 0;
+// ========================================================================================
+// Retrieve the next line from a text buffer and advance the buffer past it. Any
+// trailing carriage return is removed. Returns false when the buffer is exhausted.
+// ========================================================================================
+bool AfxNextLine(std::string_view& text, std::string_view& line) {
+    if (text.empty()) return false;
+
+    size_t pos = text.find('\n');
+    if (pos == std::string_view::npos) {
+        line = text;
+        text = std::string_view();
     }
-    catch (...) {
+    else {
+        line = text.substr(0, pos);
+        text.remove_prefix(pos + 1);
+    }
+
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    return true;
+}
+
+
+// ========================================================================================
+// Prepare a numeric string for std::from_chars. Leading whitespace and a leading plus
+// sign are skipped in the same way that std::stoi and std::stod accept them.
+// ========================================================================================
+static std::string_view NumericView(std::string_view st) {
+    while (!st.empty() && std::isspace((unsigned char)st.front())) st.remove_prefix(1);
+    if (st.size() > 1 && st.front() == '+' && st[1] != '-') st.remove_prefix(1);
+    return st;
+}
+
+
+// ========================================================================================
+// Convert string to integer. Returns zero if the entire string is not a valid integer.
+// ========================================================================================
+int AfxValInteger(std::string_view st)  {
+    if (st.empty()) return 0;
+
+    std::string_view text = NumericView(st);
+    int result = 0;
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), result);
+
+    if (ec != std::errc()) {
         std::cout << "Error: AfxValInteger " << st << std::endl;
         return 0;
     }
+
+    // Check if the entire string was used for conversion
+    return (ptr == text.data() + text.size()) ? result : 0;
 }
 
 
 // ========================================================================================
-// Convert string to double catching any exceptions
+// Convert string to double. Returns zero if the entire string is not a valid number.
 // ========================================================================================
-double AfxValDouble(const std::string& st) {
-    if (st == "") return 0.0f;
-    try {
-        size_t pos;
-        double result = std::stod(st, &pos);
+double AfxValDouble(std::string_view st) {
+    if (st.empty()) return 0.0f;
 
-        // Check if the entire string was used for conversion
-        return (pos == st.length()) ? result : 0.0f;
-    }
-    catch (...) {
+    std::string_view text = NumericView(st);
+    double result = 0;
+
+#if defined(__cpp_lib_to_chars)
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), result);
+    bool is_error = (ec != std::errc());
+    bool is_complete = (ptr == text.data() + text.size());
+#else
+    // Standard library without floating point from_chars. Numbers in the database and
+    // config files are short so copy into a local buffer for strtod.
+    char buffer[64]{};
+    if (text.size() >= sizeof(buffer)) return 0.0f;
+    std::memcpy(buffer, text.data(), text.size());
+    char* end = nullptr;
+    errno = 0;
+    result = std::strtod(buffer, &end);
+    bool is_error = (end == buffer || errno == ERANGE);
+    bool is_complete = (end == buffer + text.size());
+#endif
+
+    if (is_error) {
         std::cout << "Error: AfxValDouble " << st << std::endl;
         return 0.0f;
     }
+
+    // Check if the entire string was used for conversion
+    return is_complete ? result : 0.0f;
 }
 
 
@@ -457,10 +584,10 @@ std::string AfxDoubleToString(const double value, const int num_decimal_places)
 // Insert embedded hyphen "-" into a date string.
 // e.g.  20230728 would be returned as 2023-07-28
 // ========================================================================================
-std::string AfxInsertDateHyphens(const std::string& date_string) {
+std::string AfxInsertDateHyphens(std::string_view date_string) {
     if (date_string.length() != 8) return "";
 
-    std::string new_date = date_string;
+    std::string new_date(date_string);
     // YYYYMMDD
     // 01234567
 
@@ -497,13 +624,19 @@ std::string AfxCurrentDate() {
     // Convert to time_t for easy formatting
     std::time_t now_c = std::chrono::system_clock::to_time_t(now);
 
-    // Convert to tm structure for local time
-    std::tm* now_tm = std::localtime(&now_c);
+    // Convert to tm structure for local time. Use the reentrant versions because
+    // this function is called from the parallel database load.
+    std::tm now_tm{};
+#if defined(_WIN32)
+    localtime_s(&now_tm, &now_c);
+#else
+    localtime_r(&now_c, &now_tm);
+#endif
 
     // Convert to year_month_day object
-    const std::chrono::year y{(int)now_tm->tm_year + 1900};
-    const std::chrono::month m{(unsigned)now_tm->tm_mon + 1};
-    const std::chrono::day d{(unsigned)now_tm->tm_mday};
+    const std::chrono::year y{(int)now_tm.tm_year + 1900};
+    const std::chrono::month m{(unsigned)now_tm.tm_mon + 1};
+    const std::chrono::day d{(unsigned)now_tm.tm_mday};
 
     year_month_day ymd{y, m, d};
     return to_iso_string(ymd);
@@ -520,25 +653,26 @@ std::string AfxShortDate(const std::string& date_text) {
 }
 
 
+// ========================================================================================
+// Returns the short date MMM DD from a Date.
+// ========================================================================================
+std::string AfxShortDate(Date date) {
+    if (!date.IsValid()) return "";
+    int d = date.Day();
+    std::string text = AfxGetShortMonthName(date) + " ";
+    text += (char)('0' + d / 10);
+    text += (char)('0' + d % 10);
+    return text;
+}
+
+
 // ========================================================================================
 // Return the number of days between two dates (YYYY-MM-DD)
 // ========================================================================================
 int AfxDaysBetween(const std::string& date1, const std::string& date2) {
     if (date1.length() != 10) return 0;
     if (date2.length() != 10) return 0;
-
-    // Convert year_month_day to sys_days
-    year_month_day d1{from_iso_string(date1)};
-    year_month_day d2{from_iso_string(date2)};
-
-    auto sys_date1 = sys_days{d1};
-    auto sys_date2 = sys_days{d2};
-
-    // Calculate the difference in days
-    auto diff = sys_date2 - sys_date1;
-
-    // Print the number of days
-    return diff.count();
+    return Date::FromString(date1).DaysUntil(Date::FromString(date2));
 }
 
 
@@ -796,13 +930,20 @@ std::string AfxGetLongDayName(const std::string& date_text) {
 // Returns the short format month based on the specified date in ISO format (YYYY-MM-DD)
 // ========================================================================================
 std::string AfxGetShortMonthName(const std::string& date_text) {
+    if (date_text.length() == 0) return "";
+    return AfxGetShortMonthName(Date::FromString(date_text));
+}
+
+
+// ========================================================================================
+// Returns the short format month of the Date.
+// ========================================================================================
+std::string AfxGetShortMonthName(Date date) {
     // Define the array of day names
-    const std::array<std::string, 12> month_names =
+    static const std::array<std::string, 12> month_names =
         {"Jan","Feb","Mar","Apr","May","Jun","Jul","Aug","Sep","Oct","Nov","Dec"};
-    if (date_text.length() == 0) return "";
-    year_month_day ymd{from_iso_string(date_text)};
-    int m = (int)static_cast<unsigned>(ymd.month()) - 1;   // convert 1 based to zero based
-    return month_names[m];
+    if (!date.IsValid()) return "";
+    return month_names[date.Month() - 1];   // convert 1 based to zero based
 }
 
 
@@ -810,37 +951,102 @@ std::string AfxGetShortMonthName(const std::string& date_text) {
 // Returns the long format month based on the specified date in ISO format (YYYY-MM-DD)
 // ========================================================================================
 std::string AfxGetLongMonthName(const std::string& date_text) {
+    if (date_text.length() == 0) return "";
+    return AfxGetLongMonthName(Date::FromString(date_text));
+}
+
+
+// ========================================================================================
+// Returns the long format month of the Date.
+// ========================================================================================
+std::string AfxGetLongMonthName(Date date) {
     // Define the array of day names
-    const std::array<std::string, 12> month_names =
+    static const std::array<std::string, 12> month_names =
         {"January","February","March","April","May","June","July","August","September","October","November","December"};
-    if (date_text.length() == 0) return "";
-    year_month_day ymd{from_iso_string(date_text)};
-    int m = (int)static_cast<unsigned>(ymd.month()) - 1;   // convert 1 based to zero based
-    return month_names[m];
+    if (!date.IsValid()) return "";
+    return month_names[date.Month() - 1];   // convert 1 based to zero based
 }
 
 
 // ========================================================================================
-// Format a numeric (double) string with specified decimal places.
-// Decimal places = 2 unless specified otherwise.
-// No leading dollar sign is added.
+// Decimal point, thousands separator and digit group size for each NumberFormatType.
+// These match the en_US.UTF-8 and de_DE.UTF-8 locales that were previously imbued.
 // ========================================================================================
-std::string AfxMoney(double value, int num_decimal_places, AppState& state) {
-    // Set the output to show specified decimal places and use the fixed format
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(num_decimal_places);
+struct NumberFormatInfo {
+    char decimal_point;
+    char thousands_sep;
+    size_t group_size;
+};
+
+static const NumberFormatInfo number_formats[] = {
+    { '.', ',', 3 },    // NumberFormatType::American
+    { ',', '.', 3 },    // NumberFormatType::European
+};
+
+
+// ========================================================================================
+// Format a numeric (double) into the buffer with the specified decimal places and the
+// separators of the NumberFormatType. No leading dollar sign is added. The result is null
+// terminated. Returns the number of characters written (0 if the buffer is too small).
+// ========================================================================================
+size_t AfxFormatMoney(char* buffer, size_t buffer_size, double value, int num_decimal_places, NumberFormatType format) {
+    if (!buffer || buffer_size == 0) return 0;
+    buffer[0] = '\0';
+
+    int precision = std::max(num_decimal_places, 0);
+
+    // Plain fixed format digits (eg. -1234567.89)
+    char digits[400];
+#if defined(__cpp_lib_to_chars)
+    auto [ptr, ec] = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::fixed, precision);
+    if (ec != std::errc()) return 0;
+    size_t num_digits = ptr - digits;
+#else
+    int n = std::snprintf(digits, sizeof(digits), "%.*f", precision, value);
+    if (n < 0 || n >= (int)sizeof(digits)) return 0;
+    size_t num_digits = n;
+#endif
+
+    const NumberFormatInfo& nf = number_formats[(int)format];
 
-    // Output the amount as currency with correct separators
-    if (state.config.number_format_type == NumberFormatType::American) {
-        oss.imbue(std::locale("en_US.UTF-8"));
+    size_t int_start = (digits[0] == '-') ? 1 : 0;
+    size_t int_end = int_start;
+    while (int_end < num_digits && std::isdigit((unsigned char)digits[int_end])) int_end++;
+
+    size_t num_int_digits = int_end - int_start;
+    size_t num_separators = (num_int_digits > 0) ? (num_int_digits - 1) / nf.group_size : 0;
+
+    size_t length = num_digits + num_separators;
+    if (length + 1 > buffer_size) return 0;
+
+    char* out = buffer;
+    for (size_t i = 0; i < int_start; ++i) *out++ = digits[i];
+
+    // Integer digits with a separator in front of every complete group
+    for (size_t i = int_start; i < int_end; ++i) {
+        size_t remaining = int_end - i;
+        if (i != int_start && remaining % nf.group_size == 0) *out++ = nf.thousands_sep;
+        *out++ = digits[i];
     }
-    if (state.config.number_format_type == NumberFormatType::European) {
-        oss.imbue(std::locale("de_DE.UTF-8"));
+
+    for (size_t i = int_end; i < num_digits; ++i) {
+        *out++ = (digits[i] == '.') ? nf.decimal_point : digits[i];
     }
-    oss << value;
+    *out = '\0';
+
+    return length;
+}
 
-    std::string res = oss.str();
-    return res;
+
+// ========================================================================================
+// Format a numeric (double) string with specified decimal places.
+// Decimal places = 2 unless specified otherwise.
+// No leading dollar sign is added.
+// ========================================================================================
+std::string AfxMoney(double value, int num_decimal_places, AppState& state) {
+    char buffer[512];
+    size_t length = AfxFormatMoney(buffer, sizeof(buffer), value, num_decimal_places, state.config.number_format_type);
+    return std::string(buffer, length);
 }
 
 
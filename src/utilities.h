@@ -28,8 +28,10 @@ SOFTWARE.
 #define AFXHELPER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <chrono>
+#include <functional>
 
 #if defined(_WIN32) // win32 and win64
 #include <cwctype>
@@ -49,13 +51,17 @@ using namespace std::chrono;
 
 std::string GetDataFilesFolder();
 std::string AfxDoubleToString(const double value, const int num_decimal_places);
-int AfxValInteger(const std::string& st);
-double AfxValDouble(const std::string& st);
+int AfxValInteger(std::string_view st);
+double AfxValDouble(std::string_view st);
 std::string AfxGetExePath();
 bool AfxFileExists(const std::string& path);
 std::string AfxLoadFileIntoString(const std::string& filename);
 bool AfxSaveStringToFile(const std::string& filename, const std::string& data);
 std::vector<std::string> AfxSplit(const std::string& input, char delimiter);
+void AfxSplitView(std::string_view input, char delimiter, std::vector<std::string_view>& tokens);
+std::string_view AfxTrimView(std::string_view input);
+bool AfxNextLine(std::string_view& text, std::string_view& line);
+void AfxParallelFor(size_t count, size_t min_per_thread, const std::function<void(size_t, size_t)>& func);
 std::string AfxLower(const std::string& text);
 std::string AfxUpper(const std::string& text);
 std::string AfxLTrim(const std::string& s);
@@ -65,14 +71,17 @@ std::string AfxReplace(const std::string& str, const std::string& from, const st
 std::string AfxRemove(const std::string& text, const std::string& repl);
 std::string AfxRSet(const std::string& text, int width);
 std::string AfxLSet(const std::string& text, int width);
+size_t AfxFormatMoney(char* buffer, size_t buffer_size, double value, int num_decimal_places, NumberFormatType format);
 std::string AfxMoney(double value, int num_decimal_places, AppState& state);
 std::chrono::year_month_day from_iso_string(const std::string& iso_string);
 std::string to_iso_string(const year_month_day& ymd);
 std::string AfxGetShortMonthName(const std::string& date_text);
+std::string AfxGetShortMonthName(Date date);
 std::string AfxGetLongMonthName(const std::string& date_text);
+std::string AfxGetLongMonthName(Date date);
 std::string AfxGetShortDayName(const std::string& date_text);
 std::string AfxGetLongDayName(const std::string& date_text);
-std::string AfxInsertDateHyphens(const std::string& date_string);
+std::string AfxInsertDateHyphens(std::string_view date_string);
 std::string AfxRemoveDateHyphens(const std::string& date_string);
 std::string AfxFormatFuturesDate(const std::string& date_text);
 std::string AfxFormatFuturesDateMarketData(const std::string& date_text);
@@ -82,6 +91,7 @@ int AfxGetDay(const std::string& date_text);
 int AfxLocalDayOfWeek();
 std::string AfxCurrentDate();
 std::string AfxShortDate(const std::string& date_text);
+std::string AfxShortDate(Date date);
 int AfxDaysBetween(const std::string& date1, const std::string& date2);
 std::string AfxDateAddDays(const std::string& date_text, int num_days_to_add);
 bool AfxIsLeapYear(int year);
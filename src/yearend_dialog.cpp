@@ -38,7 +38,7 @@ SOFTWARE.
 // Process the Year End closing procedure
 // ========================================================================================
 bool ProcessYearEnd(AppState& state) {
-    std::string close_date = state.year_to_close + "-12-31";
+    Date close_date = Date::FromString(state.year_to_close + "-12-31");
 
     // Iterate the trades and remove all closed trades before the close date.
     auto iter = state.db.trades.begin();
@@ -47,7 +47,7 @@ bool ProcessYearEnd(AppState& state) {
         if (!(*iter)->is_open) {
 
             // Iterate to find the latest closed date
-            std::string trade_close_date = "0000-00-00";
+            Date trade_close_date;
             for (auto& trans : (*iter)->transactions) {
                 if (trans->trans_date > trade_close_date) {
                     trade_close_date = trans->trans_date;
@@ -55,6 +55,7 @@ bool ProcessYearEnd(AppState& state) {
             }
 
             if (trade_close_date <= close_date) {
+                state.db.SetTradeDeleted(*iter);
                 iter = state.db.trades.erase(iter);
             } else {
                 iter++;